@@ -131,6 +131,11 @@ ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_drivers.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_auto_mouse.c
+        ifeq ($(strip $(POINTING_DEVICE_MOTION_INTERRUPT_ENABLE)), yes)
+            OPT_DEFS += -DPOINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+            SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_motion.c
+            SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/pointing_device_motion.c)
+        endif
         ifneq ($(strip $(POINTING_DEVICE_DRIVER)), custom)
             SRC += drivers/sensors/$(strip $(POINTING_DEVICE_DRIVER)).c
             OPT_DEFS += -DPOINTING_DEVICE_DRIVER_$(strip $(shell echo $(POINTING_DEVICE_DRIVER) | tr '[:lower:]' '[:upper:]'))
@@ -649,6 +654,15 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     endif
 endif
 
+ifeq ($(strip $(MATRIX_WAKEUP_ENABLE)), yes)
+    ifneq ($(strip $(CUSTOM_MATRIX)), no)
+        $(call CATASTROPHIC_ERROR,Invalid MATRIX_WAKEUP_ENABLE,MATRIX_WAKEUP_ENABLE requires the standard matrix implementation)
+    endif
+    OPT_DEFS += -DMATRIX_WAKEUP_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/matrix_wakeup.c
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/matrix_wakeup.c)
+endif
+
 # Debounce Modules. Set DEBOUNCE_TYPE=custom if including one manually.
 DEBOUNCE_TYPE ?= sym_defer_g
 ifneq ($(strip $(DEBOUNCE_TYPE)), custom)
@@ -677,6 +691,7 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
                        $(QUANTUM_DIR)/split_common/transactions.c
 
         OPT_DEFS += -DSPLIT_COMMON_TRANSACTIONS
+        QUANTUM_LIB_SRC += split_link_stats.c
 
         # Functions added via QUANTUM_LIB_SRC are only included in the final binary if they're called.
         # Unused functions are pruned away, which is why we can add multiple drivers here without bloat.
@@ -936,7 +951,7 @@ ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
 
     OPT_DEFS += -DWS2812_$(strip $(shell echo $(WS2812_DRIVER) | tr '[:lower:]' '[:upper:]'))
 
-    SRC += ws2812_$(strip $(WS2812_DRIVER)).c
+    SRC += ws2812.c ws2812_$(strip $(WS2812_DRIVER)).c
 
     ifeq ($(strip $(PLATFORM)), CHIBIOS)
         ifeq ($(strip $(WS2812_DRIVER)), pwm)
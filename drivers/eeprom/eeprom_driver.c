@@ -19,63 +19,207 @@
 
 #include "eeprom_driver.h"
 
+_Static_assert(EEPROM_TXN_PAGE_COUNT > 0 && EEPROM_TXN_PAGE_COUNT <= 255, "EEPROM_TXN_PAGE_COUNT must be between 1 and 255");
+
+typedef struct eeprom_txn_page_t {
+    uintptr_t address;
+    uint8_t   data[EEPROM_TXN_PAGE_SIZE];
+    uint8_t   dirty[(EEPROM_TXN_PAGE_SIZE + 7) / 8];
+} eeprom_txn_page_t;
+
+static eeprom_txn_page_t eeprom_txn_pages[EEPROM_TXN_PAGE_COUNT];
+static uint8_t           eeprom_txn_page_count = 0;
+static uint8_t           eeprom_txn_depth      = 0;
+
+static inline bool eeprom_txn_is_dirty(const eeprom_txn_page_t *page, size_t offset) {
+    return page->dirty[offset / 8] & (1 << (offset % 8));
+}
+
+static void eeprom_txn_write_page(const eeprom_txn_page_t *page) {
+    size_t start = 0;
+    while (true) {
+        while (start < EEPROM_TXN_PAGE_SIZE && !eeprom_txn_is_dirty(page, start)) {
+            ++start;
+        }
+        if (start == EEPROM_TXN_PAGE_SIZE) {
+            break;
+        }
+
+        size_t end = start + 1;
+#if defined(EEPROM_TXN_PAGE_BURST)
+        for (size_t i = end; i < EEPROM_TXN_PAGE_SIZE; ++i) {
+            if (eeprom_txn_is_dirty(page, i)) {
+                end = i + 1;
+            }
+        }
+#else
+        while (end < EEPROM_TXN_PAGE_SIZE && eeprom_txn_is_dirty(page, end)) {
+            ++end;
+        }
+#endif
+        eeprom_write_block(&page->data[start], (void *)(page->address + start), end - start);
+        start = end;
+    }
+}
+
+static void eeprom_txn_flush(void) {
+    for (uint8_t i = 0; i < eeprom_txn_page_count; ++i) {
+        eeprom_txn_write_page(&eeprom_txn_pages[i]);
+    }
+    eeprom_txn_page_count = 0;
+}
+
+static eeprom_txn_page_t *eeprom_txn_get_page(uintptr_t address) {
+    for (uint8_t i = 0; i < eeprom_txn_page_count; ++i) {
+        if (eeprom_txn_pages[i].address == address) {
+            return &eeprom_txn_pages[i];
+        }
+    }
+
+    // Out of room for another page, so write back what's been staged so far
+    if (eeprom_txn_page_count == EEPROM_TXN_PAGE_COUNT) {
+        eeprom_txn_flush();
+    }
+
+    eeprom_txn_page_t *page = &eeprom_txn_pages[eeprom_txn_page_count++];
+    page->address           = address;
+    eeprom_read_block(page->data, (const void *)address, EEPROM_TXN_PAGE_SIZE);
+    memset(page->dirty, 0, sizeof(page->dirty));
+    return page;
+}
+
+static void eeprom_txn_stage(const void *buf, void *addr, size_t len) {
+    const uint8_t *source = (const uint8_t *)buf;
+    uintptr_t      target = (uintptr_t)addr;
+    while (len > 0) {
+        size_t offset = target % EEPROM_TXN_PAGE_SIZE;
+        size_t length = EEPROM_TXN_PAGE_SIZE - offset;
+        if (length > len) {
+            length = len;
+        }
+
+        eeprom_txn_page_t *page = eeprom_txn_get_page(target - offset);
+        for (size_t i = 0; i < length; ++i, ++offset) {
+            if (page->data[offset] != source[i]) {
+                page->data[offset] = source[i];
+                page->dirty[offset / 8] |= 1 << (offset % 8);
+            }
+        }
+
+        source += length;
+        target += length;
+        len -= length;
+    }
+}
+
+// Reads from the EEPROM, overlaid with any staged changes
+static void eeprom_txn_read(void *buf, const void *addr, size_t len) {
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end   = start + len;
+
+    // Avoid going to the EEPROM at all if a staged page covers the whole read
+    for (uint8_t i = 0; i < eeprom_txn_page_count; ++i) {
+        const eeprom_txn_page_t *page = &eeprom_txn_pages[i];
+        if (page->address <= start && end <= page->address + EEPROM_TXN_PAGE_SIZE) {
+            memcpy(buf, &page->data[start - page->address], len);
+            return;
+        }
+    }
+
+    eeprom_read_block(buf, addr, len);
+    for (uint8_t i = 0; i < eeprom_txn_page_count; ++i) {
+        const eeprom_txn_page_t *page       = &eeprom_txn_pages[i];
+        uintptr_t                page_start = page->address > start ? page->address : start;
+        uintptr_t                page_end   = page->address + EEPROM_TXN_PAGE_SIZE < end ? page->address + EEPROM_TXN_PAGE_SIZE : end;
+        if (page_start < page_end) {
+            memcpy((uint8_t *)buf + (page_start - start), &page->data[page_start - page->address], page_end - page_start);
+        }
+    }
+}
+
+static void eeprom_txn_write(const void *buf, void *addr, size_t len) {
+    if (eeprom_txn_depth > 0) {
+        eeprom_txn_stage(buf, addr, len);
+    } else {
+        eeprom_write_block(buf, addr, len);
+    }
+}
+
+void eeprom_txn_begin(void) {
+    ++eeprom_txn_depth;
+}
+
+void eeprom_txn_commit(void) {
+    if (eeprom_txn_depth > 0 && --eeprom_txn_depth == 0) {
+        eeprom_txn_flush();
+    }
+}
+
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uint8_t ret = 0;
-    eeprom_read_block(&ret, addr, 1);
+    eeprom_txn_read(&ret, addr, 1);
     return ret;
 }
 
 uint16_t eeprom_read_word(const uint16_t *addr) {
     uint16_t ret = 0;
-    eeprom_read_block(&ret, addr, 2);
+    eeprom_txn_read(&ret, addr, 2);
     return ret;
 }
 
 uint32_t eeprom_read_dword(const uint32_t *addr) {
     uint32_t ret = 0;
-    eeprom_read_block(&ret, addr, 4);
+    eeprom_txn_read(&ret, addr, 4);
     return ret;
 }
 
 void eeprom_write_byte(uint8_t *addr, uint8_t value) {
-    eeprom_write_block(&value, addr, 1);
+    eeprom_txn_write(&value, addr, 1);
 }
 
 void eeprom_write_word(uint16_t *addr, uint16_t value) {
-    eeprom_write_block(&value, addr, 2);
+    eeprom_txn_write(&value, addr, 2);
 }
 
 void eeprom_write_dword(uint32_t *addr, uint32_t value) {
-    eeprom_write_block(&value, addr, 4);
+    eeprom_txn_write(&value, addr, 4);
 }
 
 void eeprom_update_block(const void *buf, void *addr, size_t len) {
-    uint8_t read_buf[len];
+    // Staging already skips unchanged bytes
+    if (eeprom_txn_depth > 0) {
+        eeprom_txn_stage(buf, addr, len);
+        return;
+    }
+
+    const uint8_t *source = (const uint8_t *)buf;
+    uint8_t        read_buf[len];
     eeprom_read_block(read_buf, addr, len);
-    if (memcmp(buf, read_buf, len) != 0) {
-        eeprom_write_block(buf, addr, len);
+
+    // Only write the span between the first and last changed bytes
+    size_t start = 0;
+    size_t end   = len;
+    while (start < end && source[start] == read_buf[start]) {
+        ++start;
+    }
+    while (end > start && source[end - 1] == read_buf[end - 1]) {
+        --end;
+    }
+    if (start < end) {
+        eeprom_write_block(&source[start], (uint8_t *)addr + start, end - start);
     }
 }
 
 void eeprom_update_byte(uint8_t *addr, uint8_t value) {
-    uint8_t orig = eeprom_read_byte(addr);
-    if (orig != value) {
-        eeprom_write_byte(addr, value);
-    }
+    eeprom_update_block(&value, addr, sizeof(value));
 }
 
 void eeprom_update_word(uint16_t *addr, uint16_t value) {
-    uint16_t orig = eeprom_read_word(addr);
-    if (orig != value) {
-        eeprom_write_word(addr, value);
-    }
+    eeprom_update_block(&value, addr, sizeof(value));
 }
 
 void eeprom_update_dword(uint32_t *addr, uint32_t value) {
-    uint32_t orig = eeprom_read_dword(addr);
-    if (orig != value) {
-        eeprom_write_dword(addr, value);
-    }
+    eeprom_update_block(&value, addr, sizeof(value));
 }
 
 void eeprom_driver_format(bool erase) __attribute__((weak));
@@ -19,6 +19,32 @@
 #include <stdbool.h>
 #include "eeprom.h"
 
+// External EEPROM drivers export the device's page size, from either a part preset or the driver's default
+#if defined(EEPROM_I2C)
+#    include "eeprom_i2c.h"
+#elif defined(EEPROM_SPI)
+#    include "eeprom_spi.h"
+#endif
+
+#ifndef EEPROM_TXN_PAGE_SIZE
+#    if defined(EXTERNAL_EEPROM_PAGE_SIZE)
+#        define EEPROM_TXN_PAGE_SIZE EXTERNAL_EEPROM_PAGE_SIZE
+#    else
+#        define EEPROM_TXN_PAGE_SIZE 32
+#    endif
+#endif
+
+#ifndef EEPROM_TXN_PAGE_COUNT
+#    define EEPROM_TXN_PAGE_COUNT 4
+#endif
+
+// External EEPROMs take a full write cycle per page regardless of how much of it is written, so each staged page is
+// written as a single burst. Other drivers are written one run of changed bytes at a time, as unchanged bytes still
+// cost a wear-leveling log entry.
+#if defined(EXTERNAL_EEPROM_PAGE_SIZE)
+#    define EEPROM_TXN_PAGE_BURST
+#endif
+
 void eeprom_driver_init(void);
 void eeprom_driver_format(bool erase);
 void eeprom_driver_erase(void);
@@ -33,7 +33,7 @@
     there is nothing to override during linkage.
 */
 
-#include "wait.h"
+#include "timer.h"
 #include "i2c_master.h"
 #include "eeprom.h"
 #include "eeprom_driver.h"
@@ -42,10 +42,13 @@
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+static bool      write_cycle_pending = false;
+static uint32_t  write_cycle_start;
+static uintptr_t write_cycle_addr;
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -54,6 +57,24 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
+/*
+    The EEPROM doesn't respond while it's internally writing a page, so rather than waiting out the write cycle after
+    each page is sent, the wait is deferred until the EEPROM is next accessed. The EEPROM is polled until it responds,
+    which is usually well before the worst-case write time given in the datasheet.
+*/
+static void wait_for_write_cycle(void) {
+    if (!write_cycle_pending) {
+        return;
+    }
+    write_cycle_pending = false;
+
+    while (timer_elapsed32(write_cycle_start) <= EXTERNAL_EEPROM_WRITE_TIME) {
+        if (i2c_ping_address(EXTERNAL_EEPROM_I2C_ADDRESS(write_cycle_addr), 100) == I2C_STATUS_SUCCESS) {
+            break;
+        }
+    }
+}
+
 void eeprom_driver_init(void) {
     i2c_init();
 #if defined(EXTERNAL_EEPROM_WP_PIN)
@@ -90,6 +111,8 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
     uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
     fill_target_address(complete_packet, addr);
 
+    wait_for_write_cycle();
+
     i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
     i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
 
@@ -132,8 +155,13 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
         dprintf("\n");
 #endif // DEBUG_EEPROM_OUTPUT
 
+        wait_for_write_cycle();
         i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+        write_cycle_pending = true;
+        write_cycle_start   = timer_read32();
+        write_cycle_addr    = (uintptr_t)addr;
+#endif
 
         read_buf += write_length;
         target_addr += write_length;
@@ -141,6 +169,8 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     }
 
 #if defined(EXTERNAL_EEPROM_WP_PIN)
+    /* The last page needs to have been written before write protection is re-enabled */
+    wait_for_write_cycle();
     /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
     gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
     gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
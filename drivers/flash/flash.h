@@ -111,7 +111,8 @@ flash_status_t flash_read_range(uint32_t addr, void *buf, size_t len);
 /**
  * @brief Writes a range of flash memory.
  *
- * This function writes a range of flash memory from a buffer.
+ * This function writes a range of flash memory from a buffer, splitting it into page-sized writes as needed.
+ * It does not wait for the final page to be programmed; subsequent operations wait for the flash to become ready.
  *
  * @param addr The address of the range to write.
  * @param buf A pointer to the buffer to write to the range.
@@ -107,19 +107,6 @@ static flash_status_t spi_flash_write_enable(void) {
     return FLASH_STATUS_SUCCESS;
 }
 
-static flash_status_t spi_flash_write_disable(void) {
-    bool res = spi_flash_start();
-    if (!res) {
-        dprint("Failed to start SPI! [spi flash write disable]\n");
-        return FLASH_STATUS_ERROR;
-    }
-
-    spi_write(FLASH_CMD_WRDI);
-    spi_stop();
-
-    return FLASH_STATUS_SUCCESS;
-}
-
 /* This function is used for read transfer, write transfer and erase transfer. */
 static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
@@ -365,19 +352,10 @@ flash_status_t flash_write_range(uint32_t addr, const void *buf, size_t len) {
         len -= write_length;
     }
 
-    /* Wait for the write-in-progress bit to be cleared. */
-    response = spi_flash_wait_while_busy();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to check WIP flag! [spi flash write block]\n");
-        return response;
-    }
-
-    /* Disable writes. */
-    response = spi_flash_write_disable();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to write-disable! [spi flash write block]\n");
-        return response;
-    }
-
+    /*
+        Don't wait for the last page to be programmed -- every other operation waits for the write-in-progress bit to
+        be cleared before it starts, and the write enable latch is reset by the flash once programming has completed.
+        Callers can use flash_is_busy() to check for completion.
+    */
     return response;
 }
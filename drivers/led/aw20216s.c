@@ -18,6 +18,7 @@
 #include "aw20216s.h"
 #include "wait.h"
 #include "spi_master.h"
+#include "led/led_dirty.h"
 
 #define AW20216S_PWM_REGISTER_COUNT 216
 
@@ -48,6 +49,7 @@
 typedef struct aw20216s_driver_t {
     uint8_t pwm_buffer[AW20216S_PWM_REGISTER_COUNT];
     bool    pwm_buffer_dirty;
+    uint8_t pwm_buffer_dirty_registers[LED_DIRTY_BITMAP_SIZE(AW20216S_PWM_REGISTER_COUNT)];
 } PACKED aw20216s_driver_t;
 
 aw20216s_driver_t driver_buffers[AW20216S_DRIVER_COUNT] = {{
@@ -134,6 +136,17 @@ void aw20216s_init(pin_t cs_pin) {
 
     aw20216s_soft_enable(cs_pin);
     aw20216s_auto_lowpower(cs_pin);
+
+    uint8_t index = 0;
+#if defined(AW20216S_CS_PIN_2)
+    if (cs_pin == AW20216S_CS_PIN_2) {
+        index = 1;
+    }
+#endif
+
+    // The chip's PWM registers no longer match the buffer, so resend all of it on the next flush.
+    led_dirty_set_all(driver_buffers[index].pwm_buffer_dirty_registers, AW20216S_PWM_REGISTER_COUNT);
+    driver_buffers[index].pwm_buffer_dirty = true;
 }
 
 void aw20216s_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
@@ -148,6 +161,9 @@ void aw20216s_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     driver_buffers[led.driver].pwm_buffer[led.g] = green;
     driver_buffers[led.driver].pwm_buffer[led.b] = blue;
     driver_buffers[led.driver].pwm_buffer_dirty  = true;
+    led_dirty_set(driver_buffers[led.driver].pwm_buffer_dirty_registers, led.r);
+    led_dirty_set(driver_buffers[led.driver].pwm_buffer_dirty_registers, led.g);
+    led_dirty_set(driver_buffers[led.driver].pwm_buffer_dirty_registers, led.b);
 }
 
 void aw20216s_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
@@ -158,8 +174,18 @@ void aw20216s_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
 
 void aw20216s_update_pwm_buffers(pin_t cs_pin, uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
-        aw20216s_write(cs_pin, AW20216S_PAGE_PWM, 0, driver_buffers[index].pwm_buffer, AW20216S_PWM_REGISTER_COUNT);
-        driver_buffers[index].pwm_buffer_dirty = false;
+        // Transmit only the PWM registers that have changed.
+        uint16_t i = 0;
+        uint16_t length;
+
+        while ((length = led_dirty_next_run(driver_buffers[index].pwm_buffer_dirty_registers, AW20216S_PWM_REGISTER_COUNT, &i, AW20216S_PWM_REGISTER_COUNT)) > 0) {
+            if (aw20216s_write(cs_pin, AW20216S_PAGE_PWM, i, driver_buffers[index].pwm_buffer + i, length)) {
+                led_dirty_clear(driver_buffers[index].pwm_buffer_dirty_registers, i, length);
+            }
+            i += length;
+        }
+        // Registers that failed to send are still marked, and are retried on the next flush.
+        driver_buffers[index].pwm_buffer_dirty = led_dirty_any(driver_buffers[index].pwm_buffer_dirty_registers, AW20216S_PWM_REGISTER_COUNT);
     }
 }
 
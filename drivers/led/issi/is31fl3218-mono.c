@@ -16,6 +16,7 @@
 
 #include "is31fl3218-mono.h"
 #include "i2c_master.h"
+#include "led/led_dirty.h"
 #include "gpio.h"
 
 #define IS31FL3218_PWM_REGISTER_COUNT 18
@@ -32,6 +33,7 @@
 typedef struct is31fl3218_driver_t {
     uint8_t pwm_buffer[IS31FL3218_PWM_REGISTER_COUNT];
     bool    pwm_buffer_dirty;
+    uint8_t pwm_buffer_dirty_registers[LED_DIRTY_BITMAP_SIZE(IS31FL3218_PWM_REGISTER_COUNT)];
     uint8_t led_control_buffer[IS31FL3218_LED_CONTROL_REGISTER_COUNT];
     bool    led_control_buffer_dirty;
 } PACKED is31fl3218_driver_t;
@@ -55,13 +57,25 @@ void is31fl3218_write_register(uint8_t reg, uint8_t data) {
 }
 
 void is31fl3218_write_pwm_buffer(void) {
+    // Transmit only the PWM registers that have changed.
+    uint16_t i = 0;
+    uint16_t length;
+
+    while ((length = led_dirty_next_run(driver_buffers.pwm_buffer_dirty_registers, IS31FL3218_PWM_REGISTER_COUNT, &i, IS31FL3218_PWM_REGISTER_COUNT)) > 0) {
 #if IS31FL3218_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3218_I2C_PERSISTENCE; i++) {
-        if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM, driver_buffers.pwm_buffer, 18, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-    }
+        for (uint8_t j = 0; j < IS31FL3218_I2C_PERSISTENCE; j++) {
+            if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM + i, driver_buffers.pwm_buffer + i, length, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+                led_dirty_clear(driver_buffers.pwm_buffer_dirty_registers, i, length);
+                break;
+            }
+        }
 #else
-    i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM, driver_buffers.pwm_buffer, 18, IS31FL3218_I2C_TIMEOUT);
+        if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM + i, driver_buffers.pwm_buffer + i, length, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+            led_dirty_clear(driver_buffers.pwm_buffer_dirty_registers, i, length);
+        }
 #endif
+        i += length;
+    }
 }
 
 void is31fl3218_init(void) {
@@ -96,6 +110,10 @@ void is31fl3218_init(void) {
     }
 
     is31fl3218_update_led_control_registers();
+
+    // The chip's PWM registers no longer match the buffer, so resend all of it on the next flush.
+    led_dirty_set_all(driver_buffers.pwm_buffer_dirty_registers, IS31FL3218_PWM_REGISTER_COUNT);
+    driver_buffers.pwm_buffer_dirty = true;
 }
 
 void is31fl3218_set_value(int index, uint8_t value) {
@@ -110,6 +128,7 @@ void is31fl3218_set_value(int index, uint8_t value) {
 
         driver_buffers.pwm_buffer[led.v] = value;
         driver_buffers.pwm_buffer_dirty  = true;
+        led_dirty_set(driver_buffers.pwm_buffer_dirty_registers, led.v);
     }
 }
 
@@ -141,7 +160,8 @@ void is31fl3218_update_pwm_buffers(void) {
         // Load PWM registers and LED Control register data
         is31fl3218_write_register(IS31FL3218_REG_UPDATE, 0x01);
 
-        driver_buffers.pwm_buffer_dirty = false;
+        // Registers that failed to send are still marked, and are retried on the next flush.
+        driver_buffers.pwm_buffer_dirty = led_dirty_any(driver_buffers.pwm_buffer_dirty_registers, IS31FL3218_PWM_REGISTER_COUNT);
     }
 }
 
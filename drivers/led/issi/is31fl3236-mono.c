@@ -3,6 +3,7 @@
 
 #include "is31fl3236-mono.h"
 #include "i2c_master.h"
+#include "led/led_dirty.h"
 #include "gpio.h"
 
 #define IS31FL3236_PWM_REGISTER_COUNT 36
@@ -36,6 +37,7 @@ const uint8_t i2c_addresses[IS31FL3236_DRIVER_COUNT] = {
 typedef struct is31fl3236_driver_t {
     uint8_t pwm_buffer[IS31FL3236_PWM_REGISTER_COUNT];
     bool    pwm_buffer_dirty;
+    uint8_t pwm_buffer_dirty_registers[LED_DIRTY_BITMAP_SIZE(IS31FL3236_PWM_REGISTER_COUNT)];
     uint8_t led_control_buffer[IS31FL3236_LED_CONTROL_REGISTER_COUNT];
     bool    led_control_buffer_dirty;
 } PACKED is31fl3236_driver_t;
@@ -58,13 +60,25 @@ void is31fl3236_write_register(uint8_t index, uint8_t reg, uint8_t data) {
 }
 
 void is31fl3236_write_pwm_buffer(uint8_t index) {
+    // Transmit only the PWM registers that have changed.
+    uint16_t i = 0;
+    uint16_t length;
+
+    while ((length = led_dirty_next_run(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3236_PWM_REGISTER_COUNT, &i, IS31FL3236_PWM_REGISTER_COUNT)) > 0) {
 #if IS31FL3236_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3236_I2C_PERSISTENCE; i++) {
-        if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM, driver_buffers[index].pwm_buffer, 36, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-    }
+        for (uint8_t j = 0; j < IS31FL3236_I2C_PERSISTENCE; j++) {
+            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+                led_dirty_clear(driver_buffers[index].pwm_buffer_dirty_registers, i, length);
+                break;
+            }
+        }
 #else
-    i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM, driver_buffers[index].pwm_buffer, 36, IS31FL3236_I2C_TIMEOUT);
+        if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+            led_dirty_clear(driver_buffers[index].pwm_buffer_dirty_registers, i, length);
+        }
 #endif
+        i += length;
+    }
 }
 
 void is31fl3236_init_drivers(void) {
@@ -110,6 +124,10 @@ void is31fl3236_init(uint8_t index) {
 
     // Load PWM registers and LED Control register data
     is31fl3236_write_register(index, IS31FL3236_REG_UPDATE, 0x01);
+
+    // The chip's PWM registers no longer match the buffer, so resend all of it on the next flush.
+    led_dirty_set_all(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3236_PWM_REGISTER_COUNT);
+    driver_buffers[index].pwm_buffer_dirty = true;
 }
 
 void is31fl3236_set_value(int index, uint8_t value) {
@@ -124,6 +142,7 @@ void is31fl3236_set_value(int index, uint8_t value) {
 
         driver_buffers[led.driver].pwm_buffer[led.v] = value;
         driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        led_dirty_set(driver_buffers[led.driver].pwm_buffer_dirty_registers, led.v);
     }
 }
 
@@ -147,7 +166,8 @@ void is31fl3236_update_pwm_buffers(uint8_t index) {
         // Load PWM registers and LED Control register data
         is31fl3236_write_register(index, IS31FL3236_REG_UPDATE, 0x01);
 
-        driver_buffers[index].pwm_buffer_dirty = false;
+        // Registers that failed to send are still marked, and are retried on the next flush.
+        driver_buffers[index].pwm_buffer_dirty = led_dirty_any(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3236_PWM_REGISTER_COUNT);
     }
 }
 
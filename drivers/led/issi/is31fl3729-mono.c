@@ -18,6 +18,7 @@
 
 #include "is31fl3729-mono.h"
 #include "i2c_master.h"
+#include "led/led_dirty.h"
 #include "gpio.h"
 #include "wait.h"
 
@@ -82,6 +83,7 @@ const uint8_t i2c_addresses[IS31FL3729_DRIVER_COUNT] = {
 typedef struct is31fl3729_driver_t {
     uint8_t pwm_buffer[IS31FL3729_PWM_REGISTER_COUNT];
     bool    pwm_buffer_dirty;
+    uint8_t pwm_buffer_dirty_registers[LED_DIRTY_BITMAP_SIZE(IS31FL3729_PWM_REGISTER_COUNT)];
     uint8_t scaling_buffer[IS31FL3729_SCALING_REGISTER_COUNT];
     bool    scaling_buffer_dirty;
 } PACKED is31fl3729_driver_t;
@@ -104,17 +106,24 @@ void is31fl3729_write_register(uint8_t index, uint8_t reg, uint8_t data) {
 }
 
 void is31fl3729_write_pwm_buffer(uint8_t index) {
-    // Transmit PWM registers in 11 transfers of 13 bytes.
+    // Transmit only the PWM registers that have changed, in transfers of up to 13 bytes.
+    uint16_t i = 0;
+    uint16_t length;
 
-    // Iterate over the pwm_buffer contents at 13 byte intervals.
-    for (uint8_t i = 0; i <= IS31FL3729_PWM_REGISTER_COUNT; i += 13) {
+    while ((length = led_dirty_next_run(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3729_PWM_REGISTER_COUNT, &i, 13)) > 0) {
 #if IS31FL3729_I2C_PERSISTENCE > 0
         for (uint8_t j = 0; j < IS31FL3729_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+                led_dirty_clear(driver_buffers[index].pwm_buffer_dirty_registers, i, length);
+                break;
+            }
         }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT);
+        if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+            led_dirty_clear(driver_buffers[index].pwm_buffer_dirty_registers, i, length);
+        }
 #endif
+        i += length;
     }
 }
 
@@ -153,6 +162,10 @@ void is31fl3729_init(uint8_t index) {
 
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
+
+    // The chip's PWM registers no longer match the buffer, so resend all of it on the next flush.
+    led_dirty_set_all(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3729_PWM_REGISTER_COUNT);
+    driver_buffers[index].pwm_buffer_dirty = true;
 }
 
 void is31fl3729_set_value(int index, uint8_t value) {
@@ -166,6 +179,7 @@ void is31fl3729_set_value(int index, uint8_t value) {
 
         driver_buffers[led.driver].pwm_buffer[led.v] = value;
         driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        led_dirty_set(driver_buffers[led.driver].pwm_buffer_dirty_registers, led.v);
     }
 }
 
@@ -192,7 +206,8 @@ void is31fl3729_update_pwm_buffers(uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
         is31fl3729_write_pwm_buffer(index);
 
-        driver_buffers[index].pwm_buffer_dirty = false;
+        // Registers that failed to send are still marked, and are retried on the next flush.
+        driver_buffers[index].pwm_buffer_dirty = led_dirty_any(driver_buffers[index].pwm_buffer_dirty_registers, IS31FL3729_PWM_REGISTER_COUNT);
     }
 }
 
@@ -19,6 +19,7 @@
 
 #include "is31fl3741.h"
 #include "i2c_master.h"
+#include "led/led_dirty.h"
 #include "gpio.h"
 #include "wait.h"
 
@@ -78,6 +79,8 @@ typedef struct is31fl3741_driver_t {
     uint8_t pwm_buffer_0[IS31FL3741_PWM_0_REGISTER_COUNT];
     uint8_t pwm_buffer_1[IS31FL3741_PWM_1_REGISTER_COUNT];
     bool    pwm_buffer_dirty;
+    uint8_t pwm_buffer_0_dirty_registers[LED_DIRTY_BITMAP_SIZE(IS31FL3741_PWM_0_REGISTER_COUNT)];
+    uint8_t pwm_buffer_1_dirty_registers[LED_DIRTY_BITMAP_SIZE(IS31FL3741_PWM_1_REGISTER_COUNT)];
     uint8_t scaling_buffer_0[IS31FL3741_SCALING_0_REGISTER_COUNT];
     uint8_t scaling_buffer_1[IS31FL3741_SCALING_1_REGISTER_COUNT];
     bool    scaling_buffer_dirty;
@@ -107,36 +110,38 @@ void is31fl3741_select_page(uint8_t index, uint8_t page) {
     is31fl3741_write_register(index, IS31FL3741_REG_COMMAND, page);
 }
 
-void is31fl3741_write_pwm_buffer(uint8_t index) {
-    is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_0);
-
-    // Transmit PWM0 registers in 6 transfers of 30 bytes.
+static void is31fl3741_write_pwm_page(uint8_t index, uint8_t page, uint8_t *buffer, uint8_t *dirty_registers, uint16_t count, uint8_t max_length) {
+    uint16_t i      = 0;
+    uint16_t length = led_dirty_next_run(dirty_registers, count, &i, max_length);
 
-    // Iterate over the pwm_buffer_0 contents at 30 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3741_PWM_0_REGISTER_COUNT; i += 30) {
-#if IS31FL3741_I2C_PERSISTENCE > 0
-        for (uint8_t j = 0; j < IS31FL3741_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, 30, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
-#else
-        i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, 30, IS31FL3741_I2C_TIMEOUT);
-#endif
+    // Skip the page select entirely if nothing on this page has changed.
+    if (length == 0) {
+        return;
     }
 
-    is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_1);
-
-    // Transmit PWM1 registers in 9 transfers of 19 bytes.
+    is31fl3741_select_page(index, page);
 
-    // Iterate over the pwm_buffer_1 contents at 19 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3741_PWM_1_REGISTER_COUNT; i += 19) {
+    do {
 #if IS31FL3741_I2C_PERSISTENCE > 0
-        for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, 19, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+        for (uint8_t j = 0; j < IS31FL3741_I2C_PERSISTENCE; j++) {
+            if (i2c_write_register(i2c_addresses[index] << 1, i, buffer + i, length, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+                led_dirty_clear(dirty_registers, i, length);
+                break;
+            }
         }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, 19, IS31FL3741_I2C_TIMEOUT);
+        if (i2c_write_register(i2c_addresses[index] << 1, i, buffer + i, length, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) {
+            led_dirty_clear(dirty_registers, i, length);
+        }
 #endif
-    }
+        i += length;
+    } while ((length = led_dirty_next_run(dirty_registers, count, &i, max_length)) > 0);
+}
+
+void is31fl3741_write_pwm_buffer(uint8_t index) {
+    // Transmit only the PWM registers that have changed, in transfers of up to 30 bytes on PWM0 and 19 bytes on PWM1.
+    is31fl3741_write_pwm_page(index, IS31FL3741_COMMAND_PWM_0, driver_buffers[index].pwm_buffer_0, driver_buffers[index].pwm_buffer_0_dirty_registers, IS31FL3741_PWM_0_REGISTER_COUNT, 30);
+    is31fl3741_write_pwm_page(index, IS31FL3741_COMMAND_PWM_1, driver_buffers[index].pwm_buffer_1, driver_buffers[index].pwm_buffer_1_dirty_registers, IS31FL3741_PWM_1_REGISTER_COUNT, 19);
 }
 
 void is31fl3741_init_drivers(void) {
@@ -183,6 +188,11 @@ void is31fl3741_init(uint8_t index) {
 
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
+
+    // The chip's PWM registers no longer match the buffer, so resend all of it on the next flush.
+    led_dirty_set_all(driver_buffers[index].pwm_buffer_0_dirty_registers, IS31FL3741_PWM_0_REGISTER_COUNT);
+    led_dirty_set_all(driver_buffers[index].pwm_buffer_1_dirty_registers, IS31FL3741_PWM_1_REGISTER_COUNT);
+    driver_buffers[index].pwm_buffer_dirty = true;
 }
 
 uint8_t get_pwm_value(uint8_t driver, uint16_t reg) {
@@ -196,8 +206,10 @@ uint8_t get_pwm_value(uint8_t driver, uint16_t reg) {
 void set_pwm_value(uint8_t driver, uint16_t reg, uint8_t value) {
     if (reg & 0x100) {
         driver_buffers[driver].pwm_buffer_1[reg & 0xFF] = value;
+        led_dirty_set(driver_buffers[driver].pwm_buffer_1_dirty_registers, reg & 0xFF);
     } else {
         driver_buffers[driver].pwm_buffer_0[reg] = value;
+        led_dirty_set(driver_buffers[driver].pwm_buffer_0_dirty_registers, reg);
     }
 }
 
@@ -247,7 +259,8 @@ void is31fl3741_update_pwm_buffers(uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
         is31fl3741_write_pwm_buffer(index);
 
-        driver_buffers[index].pwm_buffer_dirty = false;
+        // Registers that failed to send are still marked, and are retried on the next flush.
+        driver_buffers[index].pwm_buffer_dirty = led_dirty_any(driver_buffers[index].pwm_buffer_0_dirty_registers, IS31FL3741_PWM_0_REGISTER_COUNT) || led_dirty_any(driver_buffers[index].pwm_buffer_1_dirty_registers, IS31FL3741_PWM_1_REGISTER_COUNT);
     }
 }
 
@@ -0,0 +1,103 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * \file
+ *
+ * Per-register dirty tracking for LED driver PWM buffers.
+ *
+ * Drivers mark each register they modify, and on flush walk the bitmap as a
+ * series of runs so that only the registers that actually changed are sent.
+ * Runs separated by a few clean registers are merged, since resending them is
+ * cheaper than the addressing overhead of starting a new transfer. A run is
+ * only marked clean once it has been sent, so a failed transfer is retried on
+ * the next flush.
+ */
+
+// Clean registers that may be resent to merge two dirty runs into one transfer.
+#ifndef LED_DIRTY_MAX_GAP
+#    define LED_DIRTY_MAX_GAP 2
+#endif
+
+#define LED_DIRTY_BITMAP_SIZE(count) (((count) + 7) / 8)
+
+static inline bool led_dirty_get(const uint8_t *bitmap, uint16_t reg) {
+    return bitmap[reg / 8] & (1 << (reg % 8));
+}
+
+static inline void led_dirty_set(uint8_t *bitmap, uint16_t reg) {
+    bitmap[reg / 8] |= (1 << (reg % 8));
+}
+
+/**
+ * \brief Mark every register dirty, eg. after the chip's registers have been reset.
+ */
+static inline void led_dirty_set_all(uint8_t *bitmap, uint16_t count) {
+    memset(bitmap, 0xFF, count / 8);
+    if (count % 8) {
+        bitmap[count / 8] = (1 << (count % 8)) - 1;
+    }
+}
+
+/**
+ * \brief Mark a run of registers clean once it has been sent.
+ */
+static inline void led_dirty_clear(uint8_t *bitmap, uint16_t start, uint16_t length) {
+    for (uint16_t reg = start; reg < start + length; reg++) {
+        bitmap[reg / 8] &= ~(1 << (reg % 8));
+    }
+}
+
+static inline bool led_dirty_any(const uint8_t *bitmap, uint16_t count) {
+    for (uint16_t i = 0; i < LED_DIRTY_BITMAP_SIZE(count); i++) {
+        if (bitmap[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Find the next run of dirty registers.
+ *
+ * The run is left dirty; call led_dirty_clear() once it has been sent.
+ *
+ * \param bitmap The dirty bitmap.
+ * \param count The number of registers covered by the bitmap.
+ * \param start In: the register to start searching from. Out: the first register of the run.
+ * \param max_length The largest run to return, eg. the driver's maximum transfer size.
+ * \return The length of the run, or 0 if there are no more dirty registers.
+ */
+static inline uint16_t led_dirty_next_run(const uint8_t *bitmap, uint16_t count, uint16_t *start, uint16_t max_length) {
+    uint16_t first = *start;
+
+    while (first < count && !led_dirty_get(bitmap, first)) {
+        // Skip over whole clean bytes at once.
+        if (first % 8 == 0 && bitmap[first / 8] == 0) {
+            first += 8;
+        } else {
+            first++;
+        }
+    }
+    if (first >= count) {
+        return 0;
+    }
+
+    uint16_t last = first;
+    for (uint16_t reg = first + 1; reg < count && reg - first < max_length; reg++) {
+        if (led_dirty_get(bitmap, reg)) {
+            last = reg;
+        } else if (reg - last > LED_DIRTY_MAX_GAP) {
+            break;
+        }
+    }
+
+    *start = first;
+    return last - first + 1;
+}
@@ -0,0 +1,109 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "is31fl3731.h"
+#include "i2c_master.h"
+}
+
+#define PWM_REGISTER_COUNT 144
+
+extern "C" {
+const is31fl3731_led_t PROGMEM g_is31fl3731_leds[IS31FL3731_LED_COUNT] = {
+    {0, C1_1, C2_1, C3_1},
+    {0, C1_2, C2_2, C3_2},
+    {0, C4_9, C5_9, C6_9},
+    {0, C7_16, C8_16, C9_16},
+};
+
+void wait_ms(uint32_t ms) {}
+}
+
+// Simulated chip: the command register selects which page subsequent writes land in.
+static uint8_t chip_pages[16][256];
+static uint8_t chip_page;
+static int     pwm_bytes_written;
+static bool    bus_fails;
+
+extern "C" void i2c_init(void) {}
+
+extern "C" i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (bus_fails) {
+        return I2C_STATUS_ERROR;
+    }
+    if (regaddr == IS31FL3731_REG_COMMAND) {
+        chip_page = data[0];
+        return I2C_STATUS_SUCCESS;
+    }
+    memcpy(&chip_pages[chip_page][regaddr], data, length);
+    if (chip_page == IS31FL3731_COMMAND_FRAME_1 && regaddr >= IS31FL3731_FRAME_REG_PWM) {
+        pwm_bytes_written += length;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+class IS31FL3731 : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(chip_pages, 0xAA, sizeof(chip_pages));
+        bus_fails = false;
+        is31fl3731_init_drivers();
+        is31fl3731_set_color_all(0, 0, 0);
+        is31fl3731_flush();
+        pwm_bytes_written = 0;
+    }
+
+    void expect_chip_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+        const uint8_t *pwm = &chip_pages[IS31FL3731_COMMAND_FRAME_1][IS31FL3731_FRAME_REG_PWM];
+        EXPECT_EQ(pwm[g_is31fl3731_leds[index].r], red);
+        EXPECT_EQ(pwm[g_is31fl3731_leds[index].g], green);
+        EXPECT_EQ(pwm[g_is31fl3731_leds[index].b], blue);
+    }
+};
+
+TEST_F(IS31FL3731, FlushSendsOnlyChangedRegisters) {
+    is31fl3731_set_color(0, 1, 2, 3);
+    is31fl3731_flush();
+    expect_chip_color(0, 1, 2, 3);
+    EXPECT_LT(pwm_bytes_written, PWM_REGISTER_COUNT);
+
+    pwm_bytes_written = 0;
+    is31fl3731_set_color(0, 1, 2, 3);
+    is31fl3731_flush();
+    EXPECT_EQ(pwm_bytes_written, 0);
+}
+
+TEST_F(IS31FL3731, ReinitResendsEveryRegister) {
+    for (int i = 0; i < IS31FL3731_LED_COUNT; i++) {
+        is31fl3731_set_color(i, 10 + i, 20 + i, 30 + i);
+    }
+    is31fl3731_flush();
+
+    // Init clears the chip's PWM registers, while the colours themselves are unchanged.
+    is31fl3731_init(0);
+    expect_chip_color(0, 0, 0, 0);
+    for (int i = 0; i < IS31FL3731_LED_COUNT; i++) {
+        is31fl3731_set_color(i, 10 + i, 20 + i, 30 + i);
+    }
+
+    pwm_bytes_written = 0;
+    is31fl3731_flush();
+    EXPECT_EQ(pwm_bytes_written, PWM_REGISTER_COUNT);
+    for (int i = 0; i < IS31FL3731_LED_COUNT; i++) {
+        expect_chip_color(i, 10 + i, 20 + i, 30 + i);
+    }
+}
+
+TEST_F(IS31FL3731, FailedWriteIsRetried) {
+    bus_fails = true;
+    is31fl3731_set_color(2, 4, 5, 6);
+    is31fl3731_flush();
+    expect_chip_color(2, 0, 0, 0);
+
+    bus_fails = false;
+    is31fl3731_flush();
+    expect_chip_color(2, 4, 5, 6);
+}
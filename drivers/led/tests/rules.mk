@@ -0,0 +1,10 @@
+is31fl3731_CONFIG := $(DRIVER_PATH)/led/tests/config_mock.h
+
+is31fl3731_SRC := \
+	$(DRIVER_PATH)/led/tests/is31fl3731_tests.cpp \
+	$(DRIVER_PATH)/led/issi/is31fl3731.c
+
+is31fl3731_INC := \
+	$(DRIVER_PATH) \
+	$(DRIVER_PATH)/led/issi \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers
@@ -0,0 +1 @@
+TEST_LIST += is31fl3731
@@ -166,6 +166,30 @@ uint32_t oled_scroll_timeout;
 uint16_t oled_update_timeout;
 #endif
 
+#if defined(OLED_DOUBLE_BUFFER)
+#    define OLED_PAGE_COUNT (OLED_DISPLAY_HEIGHT / 8)
+// Bytes it costs to start a new rectangle instead of sending a few more columns, roughly the size of the address command
+#    define OLED_RECT_OVERHEAD 8
+
+// What the display holds once the flush in progress completes, laid out as the display memory, so already rotated
+static uint8_t oled_front_buffer[OLED_MATRIX_SIZE];
+// Set when the display memory no longer matches the front buffer, and all of it needs sending
+static bool oled_front_stale = true;
+// Columns of each page that are yet to be sent, from start up to but not including end
+static uint8_t oled_flush_start[OLED_PAGE_COUNT];
+static uint8_t oled_flush_end[OLED_PAGE_COUNT];
+
+// The rectangle being sent, and how much of its data is left
+static bool           oled_rect_open = false;
+static uint8_t        oled_rect_first_page;
+static uint8_t        oled_rect_page;
+static uint8_t        oled_rect_last_page;
+static uint8_t        oled_rect_start;
+static uint8_t        oled_rect_end;
+static const uint8_t *oled_rect_data;
+static uint16_t       oled_rect_remaining;
+#endif
+
 #if defined(OLED_TRANSPORT_SPI)
 #    ifndef OLED_DC_PIN
 #        error "The OLED driver in SPI needs a D/C pin defined"
@@ -253,6 +277,14 @@ __attribute__((weak)) bool oled_send_data(const uint8_t *data, uint16_t size) {
 #endif
 }
 
+__attribute__((weak)) bool oled_send_data_async(const uint8_t *data, uint16_t size) {
+    return oled_send_data(data, size);
+}
+
+__attribute__((weak)) bool oled_is_busy(void) {
+    return false;
+}
+
 __attribute__((weak)) void oled_driver_init(void) {
 #if defined(OLED_TRANSPORT_SPI)
     spi_init();
@@ -363,6 +395,11 @@ bool oled_init(oled_rotation_t rotation) {
 #endif
 
     oled_clear();
+#if defined(OLED_DOUBLE_BUFFER)
+    // Whatever the display holds now, it isn't the front buffer
+    oled_front_stale = true;
+    oled_rect_open   = false;
+#endif
     oled_initialized = true;
     oled_active      = true;
     oled_scrolling   = false;
@@ -431,24 +468,233 @@ static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
 #endif
 }
 
-uint8_t crot(uint8_t a, int8_t n) {
-    const uint8_t mask = 0x7;
-    n &= mask;
-    return a << n | a >> (-n & mask);
+static void rotate_90(const uint8_t *src, uint8_t *dest) {
+    // Transposes the 8x8 tile as two 32 bit halves, swapping bits between rows in three rounds, rather than bit by bit.
+    uint32_t x = (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 | (uint32_t)src[2] << 8 | src[3];
+    uint32_t y = (uint32_t)src[4] << 24 | (uint32_t)src[5] << 16 | (uint32_t)src[6] << 8 | src[7];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    dest[7] = x >> 24;
+    dest[6] = x >> 16;
+    dest[5] = x >> 8;
+    dest[4] = x;
+    dest[3] = y >> 24;
+    dest[2] = y >> 16;
+    dest[1] = y >> 8;
+    dest[0] = y;
 }
 
-static void rotate_90(const uint8_t *src, uint8_t *dest) {
-    for (uint8_t i = 0, shift = 7; i < 8; ++i, --shift) {
-        uint8_t selector = (1 << i);
-        for (uint8_t j = 0; j < 8; ++j) {
-            dest[i] |= crot(src[j] & selector, shift - (int8_t)j);
+#if defined(OLED_DOUBLE_BUFFER)
+static bool oled_flush_pending(void) {
+    if (oled_rect_open) {
+        return true;
+    }
+    for (uint8_t page = 0; page < OLED_PAGE_COUNT; ++page) {
+        if (oled_flush_start[page] < oled_flush_end[page]) {
+            return true;
         }
     }
+    return false;
+}
+
+static void oled_flush_mark(uint8_t page, uint8_t start, uint8_t end) {
+    if (oled_flush_start[page] >= oled_flush_end[page]) {
+        oled_flush_start[page] = start;
+        oled_flush_end[page]   = end;
+    } else {
+        oled_flush_start[page] = MIN(oled_flush_start[page], start);
+        oled_flush_end[page]   = MAX(oled_flush_end[page], end);
+    }
+}
+
+static void oled_flush_store(uint16_t index, uint8_t data) {
+    if (oled_front_buffer[index] != data) {
+        oled_front_buffer[index] = data;
+        oled_flush_mark(index / OLED_DISPLAY_WIDTH, index % OLED_DISPLAY_WIDTH, index % OLED_DISPLAY_WIDTH + 1);
+    }
+}
+
+// Copies the dirty blocks into the front buffer, rotating them if needed, and notes which columns of which pages changed.
+// Only called once the previous flush has completed, so the front buffer is not being sent from.
+static void oled_flush_snapshot(void) {
+    for (uint8_t block = 0; block < OLED_BLOCK_COUNT; ++block) {
+        if (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << block))) {
+            continue;
+        }
+
+        if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+            // The buffer has the same layout as the display memory
+            for (uint16_t i = OLED_BLOCK_SIZE * block; i < OLED_BLOCK_SIZE * (block + 1); ++i) {
+                oled_flush_store(i, oled_buffer[i]);
+            }
+        } else {
+            // The buffer is laid out as a display of OLED_DISPLAY_HEIGHT x OLED_DISPLAY_WIDTH, so each 8x8 tile of it
+            // lands on the display with its rows as columns, and its columns counting up from the bottom.
+            for (uint16_t i = OLED_BLOCK_SIZE * block; i < OLED_BLOCK_SIZE * (block + 1); i += 8) {
+                uint8_t  tile[8];
+                uint8_t  page  = OLED_PAGE_COUNT - 1 - (i % OLED_DISPLAY_HEIGHT) / 8;
+                uint16_t index = page * OLED_DISPLAY_WIDTH + i / OLED_DISPLAY_HEIGHT * 8;
+                rotate_90(&oled_buffer[i], tile);
+                for (uint8_t j = 0; j < 8; ++j) {
+                    oled_flush_store(index + j, tile[j]);
+                }
+            }
+        }
+    }
+    oled_dirty = 0;
+
+    if (oled_front_stale) {
+        for (uint8_t page = 0; page < OLED_PAGE_COUNT; ++page) {
+            oled_flush_mark(page, 0, OLED_DISPLAY_WIDTH);
+        }
+        oled_front_stale = false;
+    }
+}
+
+// Sends the address command for the next rectangle, starting at the first page with changes.
+static bool oled_flush_open_rect(void) {
+    uint8_t page = 0;
+    while (oled_flush_start[page] >= oled_flush_end[page]) {
+        ++page;
+    }
+
+    uint8_t last_page = page;
+    uint8_t start     = oled_flush_start[page];
+    uint8_t end       = oled_flush_end[page];
+#    if OLED_IC_HAS_HORIZONTAL_MODE
+    // Grow the rectangle down over the following pages, as long as that sends fewer bytes than starting a new one would.
+    while (last_page + 1 < OLED_PAGE_COUNT && oled_flush_start[last_page + 1] < oled_flush_end[last_page + 1]) {
+        uint8_t  next_start = MIN(start, oled_flush_start[last_page + 1]);
+        uint8_t  next_end   = MAX(end, oled_flush_end[last_page + 1]);
+        uint16_t merged     = (last_page - page + 2) * (next_end - next_start);
+        uint16_t separate   = (last_page - page + 1) * (end - start) + OLED_RECT_OVERHEAD + (oled_flush_end[last_page + 1] - oled_flush_start[last_page + 1]);
+        if (merged > separate) {
+            break;
+        }
+        start = next_start;
+        end   = next_end;
+        ++last_page;
+    }
+
+    uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, OLED_COLUMN_OFFSET + start, OLED_COLUMN_OFFSET + end - 1, PAGE_ADDR, page, last_page};
+#    else
+    // Page addressing mode has no end bound, so each page is a rectangle of its own.
+    uint8_t display_start[] = {I2C_CMD, PAM_PAGE_ADDR | page, PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start) & 0x0f), PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start) >> 4 & 0x0f)};
+#    endif
+    if (!oled_send_cmd(display_start, ARRAY_SIZE(display_start))) {
+        print("oled_render offset command failed\n");
+        return false;
+    }
+
+    for (uint8_t i = page; i <= last_page; ++i) {
+        oled_flush_start[i] = 0;
+        oled_flush_end[i]   = 0;
+    }
+    oled_rect_open       = true;
+    oled_rect_first_page = page;
+    oled_rect_page       = page;
+    oled_rect_last_page  = last_page;
+    oled_rect_start      = start;
+    oled_rect_end        = end;
+    oled_rect_data       = &oled_front_buffer[page * OLED_DISPLAY_WIDTH + start];
+    if (start == 0 && end == OLED_DISPLAY_WIDTH) {
+        // Full width rows follow on from each other in the front buffer, so they go out together
+        oled_rect_remaining = (last_page - page + 1) * OLED_DISPLAY_WIDTH;
+        oled_rect_page      = last_page;
+    } else {
+        oled_rect_remaining = end - start;
+    }
+    return true;
+}
+
+// Sends the next chunk of the open rectangle's data, at most a block's worth so that each call does a bounded amount of work.
+static bool oled_flush_send_data(void) {
+    uint16_t size = MIN(oled_rect_remaining, OLED_BLOCK_SIZE);
+    if (!oled_send_data_async(oled_rect_data, size)) {
+        print("oled_render data failed\n");
+        // Whatever is left of the rectangle is sent again as part of a new one
+        for (uint8_t i = oled_rect_first_page; i <= oled_rect_last_page; ++i) {
+            oled_flush_mark(i, oled_rect_start, oled_rect_end);
+        }
+        oled_rect_open = false;
+        return false;
+    }
+
+    oled_rect_data += size;
+    oled_rect_remaining -= size;
+    if (oled_rect_remaining == 0) {
+        if (oled_rect_page < oled_rect_last_page) {
+            ++oled_rect_page;
+            oled_rect_data      = &oled_front_buffer[oled_rect_page * OLED_DISPLAY_WIDTH + oled_rect_start];
+            oled_rect_remaining = oled_rect_end - oled_rect_start;
+        } else {
+            oled_rect_open = false;
+        }
+    }
+    return true;
+}
+
+static void oled_flush(bool all) {
+    uint8_t num_processed = 0;
+    while (num_processed < OLED_UPDATE_PROCESS_LIMIT || all) {
+        // Neither the display nor the front buffer can be touched until the last transfer has gone out
+        if (oled_is_busy()) {
+            if (!all) {
+                return;
+            }
+            continue;
+        }
+
+        if (!oled_flush_pending()) {
+            if (!oled_dirty) {
+                return;
+            }
+            // From here on the buffer is free to be drawn on again, while the front buffer is sent
+            oled_flush_snapshot();
+            continue;
+        }
+
+        // Turn on display if it is off
+        oled_on();
+
+        if (!(oled_rect_open ? oled_flush_send_data() : oled_flush_open_rect())) {
+            return;
+        }
+        ++num_processed;
+    }
+}
+#endif // defined(OLED_DOUBLE_BUFFER)
+
+// Whether everything drawn has been sent to the display
+static bool oled_render_idle(void) {
+#if defined(OLED_DOUBLE_BUFFER)
+    return !oled_dirty && !oled_flush_pending();
+#else
+    return !oled_dirty;
+#endif
 }
 
 void oled_render_dirty(bool all) {
     // Do we have work to do?
     oled_dirty &= OLED_ALL_BLOCKS_MASK;
+#if defined(OLED_DOUBLE_BUFFER)
+    if (!oled_initialized || oled_scrolling) {
+        return;
+    }
+    oled_flush(all);
+#else
     if (!oled_dirty || !oled_initialized || oled_scrolling) {
         return;
     }
@@ -530,6 +776,7 @@ void oled_render_dirty(bool all) {
         // Clear dirty flag of just rendered block
         oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
     }
+#endif // defined(OLED_DOUBLE_BUFFER)
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -836,7 +1083,7 @@ bool oled_scroll_right(void) {
 
     // Dont enable scrolling if we need to update the display
     // This prevents scrolling of bad data from starting the scroll too early after init
-    if (!oled_dirty && !oled_scrolling) {
+    if (oled_render_idle() && !oled_scrolling) {
         uint8_t display_scroll_right[] = {I2C_CMD, SCROLL_RIGHT, 0x00, oled_scroll_start, oled_scroll_speed, oled_scroll_end, 0x00, 0xFF, ACTIVATE_SCROLL};
         if (!oled_send_cmd(display_scroll_right, ARRAY_SIZE(display_scroll_right))) {
             print("oled_scroll_right cmd failed\n");
@@ -854,7 +1101,7 @@ bool oled_scroll_left(void) {
 
     // Dont enable scrolling if we need to update the display
     // This prevents scrolling of bad data from starting the scroll too early after init
-    if (!oled_dirty && !oled_scrolling) {
+    if (oled_render_idle() && !oled_scrolling) {
         uint8_t display_scroll_left[] = {I2C_CMD, SCROLL_LEFT, 0x00, oled_scroll_start, oled_scroll_speed, oled_scroll_end, 0x00, 0xFF, ACTIVATE_SCROLL};
         if (!oled_send_cmd(display_scroll_left, ARRAY_SIZE(display_scroll_left))) {
             print("oled_scroll_left cmd failed\n");
@@ -878,6 +1125,10 @@ bool oled_scroll_off(void) {
         }
         oled_scrolling = false;
         oled_dirty     = OLED_ALL_BLOCKS_MASK;
+#if defined(OLED_DOUBLE_BUFFER)
+        // Scrolling moved the contents of the display memory around
+        oled_front_stale = true;
+#endif
     }
     return !oled_scrolling;
 }
@@ -344,6 +344,14 @@ bool oled_send_cmd_P(const uint8_t *data, uint16_t size);
 bool oled_send_data(const uint8_t *data, uint16_t size);
 void oled_driver_init(void);
 
+// Starts sending data to the screen, without waiting for it to be sent, used to flush with OLED_DOUBLE_BUFFER
+// Weak function, sends synchronously with oled_send_data by default
+bool oled_send_data_async(const uint8_t *data, uint16_t size);
+
+// Returns true while data passed to oled_send_data_async is still being sent
+// Weak function, overridable along with oled_send_data_async
+bool oled_is_busy(void);
+
 // Called at the start of oled_init, weak function overridable by the user
 // rotation - the value passed into oled_init
 // Return new oled_rotation_t if you want to override default rotation
@@ -357,7 +365,8 @@ void oled_clear(void);
 #define oled_render() oled_render_dirty(false)
 
 // Renders all dirty blocks to the display at one time or a subset depending on the value of
-// all.
+// all. With OLED_DOUBLE_BUFFER, the dirty blocks are copied to a second buffer and sent from
+// there over as many calls as it takes, while drawing carries on in the first.
 void oled_render_dirty(bool all);
 
 // Moves cursor to character position indicated by column and line, wraps if out of bounds
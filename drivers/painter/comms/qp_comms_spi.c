@@ -3,9 +3,68 @@
 
 #ifdef QUANTUM_PAINTER_SPI_ENABLE
 
+#    include <string.h>
+
 #    include "spi_master.h"
 #    include "qp_comms_spi.h"
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Background transmission queue
+
+#    if QUANTUM_PAINTER_SPI_ASYNC
+
+_Static_assert((QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH & (QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH - 1)) == 0, "QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH must be a power of two");
+_Static_assert(QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH <= 128, "QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH is too large");
+_Static_assert(QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE <= UINT16_MAX, "QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE is too large");
+
+#        define QP_SPI_QUEUE_SLOT(index) ((index) & (QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH - 1))
+
+// The callers reuse their buffers as soon as the send returns, so the data is copied into one of these. The slot at the
+// head is being sent, the ones up to the tail are waiting to be. Both counters wrap around harmlessly.
+static uint8_t          qp_spi_queue[QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH][QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE] __attribute__((aligned(4)));
+static uint16_t         qp_spi_queue_length[QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH];
+static volatile uint8_t qp_spi_queue_head = 0;
+static volatile uint8_t qp_spi_queue_tail = 0;
+
+// Completion callback for each chunk, called from the SPI interrupt: frees the slot that was sent and moves on to the next.
+static bool qp_comms_spi_queue_next(const uint8_t **data, uint16_t *length) {
+    uint8_t head      = qp_spi_queue_head + 1;
+    qp_spi_queue_head = head;
+    if (head == qp_spi_queue_tail) {
+        return false;
+    }
+
+    *data   = qp_spi_queue[QP_SPI_QUEUE_SLOT(head)];
+    *length = qp_spi_queue_length[QP_SPI_QUEUE_SLOT(head)];
+    return true;
+}
+
+static void qp_comms_spi_queue_push(const uint8_t *data, uint16_t length) {
+    // Wait for the oldest chunk to have been sent if the queue is full.
+    while ((uint8_t)(qp_spi_queue_tail - qp_spi_queue_head) >= QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH) {
+    }
+
+    uint8_t tail = qp_spi_queue_tail;
+    memcpy(qp_spi_queue[QP_SPI_QUEUE_SLOT(tail)], data, length);
+    qp_spi_queue_length[QP_SPI_QUEUE_SLOT(tail)] = length;
+    __asm__ volatile("" ::: "memory");
+    qp_spi_queue_tail = tail + 1;
+
+    // Either the interrupt has picked up the new chunk, or the transmission had already finished and needs restarting.
+    // Once it has finished nothing else runs in the background, so the check and restart can't race with it.
+    if (!spi_is_busy()) {
+        uint8_t head = qp_spi_queue_head;
+        spi_transmit_async(qp_spi_queue[QP_SPI_QUEUE_SLOT(head)], qp_spi_queue_length[QP_SPI_QUEUE_SLOT(head)], qp_comms_spi_queue_next);
+    }
+}
+
+static inline void qp_comms_spi_queue_wait(void) {
+    while (spi_is_busy()) {
+    }
+}
+
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Base SPI support
 
@@ -33,11 +92,19 @@ bool qp_comms_spi_start(painter_device_t device) {
 uint32_t qp_comms_spi_send_data(painter_device_t device, const void *data, uint32_t byte_count) {
     uint32_t       bytes_remaining = byte_count;
     const uint8_t *p               = (const uint8_t *)data;
-    const uint32_t max_msg_length  = 1024;
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    const uint32_t max_msg_length = QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE;
+#    else
+    const uint32_t max_msg_length = 1024;
+#    endif
 
     while (bytes_remaining > 0) {
         uint32_t bytes_this_loop = QP_MIN(bytes_remaining, max_msg_length);
+#    if QUANTUM_PAINTER_SPI_ASYNC
+        qp_comms_spi_queue_push(p, bytes_this_loop);
+#    else
         spi_transmit(p, bytes_this_loop);
+#    endif
         p += bytes_this_loop;
         bytes_remaining -= bytes_this_loop;
     }
@@ -48,8 +115,14 @@ uint32_t qp_comms_spi_send_data(painter_device_t device, const void *data, uint3
 void qp_comms_spi_stop(painter_device_t device) {
     painter_driver_t *     driver       = (painter_driver_t *)device;
     qp_comms_spi_config_t *comms_config = (qp_comms_spi_config_t *)driver->comms_config;
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    // Return without waiting for the queue to drain, the chip select is released once the last chunk has been sent.
+    (void)comms_config;
+    spi_stop_async();
+#    else
     spi_stop();
     gpio_write_pin_high(comms_config->chip_select_pin);
+#    endif
 }
 
 const painter_comms_vtable_t spi_comms_vtable = {
@@ -100,6 +173,10 @@ uint32_t qp_comms_spi_dc_reset_send_data(painter_device_t device, const void *da
 void qp_comms_spi_dc_reset_send_command(painter_device_t device, uint8_t cmd) {
     painter_driver_t *              driver       = (painter_driver_t *)device;
     qp_comms_spi_dc_reset_config_t *comms_config = (qp_comms_spi_dc_reset_config_t *)driver->comms_config;
+#        if QUANTUM_PAINTER_SPI_ASYNC
+    // D/C can't change while queued data is still going out.
+    qp_comms_spi_queue_wait();
+#        endif
     gpio_write_pin_low(comms_config->dc_pin);
     spi_write(cmd);
 }
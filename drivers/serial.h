@@ -28,6 +28,9 @@ void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
 
+// run the link at 2^level times its configured speed, usart and vendor drivers only
+void soft_serial_set_speed_level(uint8_t level);
+
 #ifdef SERIAL_DEBUG
 #    include <debug.h>
 #    include <print.h>
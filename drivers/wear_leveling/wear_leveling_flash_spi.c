@@ -11,6 +11,9 @@
 #    define WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT 32
 #endif // WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT
 
+// Complemented data is staged in a static, word-aligned buffer rather than on the stack, so that it's suitable for DMA
+static backing_store_int_t bulk_buffer[WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT] __attribute__((aligned(4)));
+
 bool backing_store_init(void) {
     bs_dprintf("Init\n");
     flash_init();
@@ -41,6 +44,20 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+bool backing_store_erase_block(uint32_t address) {
+    _Static_assert((BACKING_STORE_ERASE_SIZE) % (EXTERNAL_FLASH_SECTOR_SIZE) == 0, "Erase size must be a multiple of EXTERNAL_FLASH_SECTOR_SIZE");
+
+    uint32_t offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
+    for (uint32_t i = 0; i < (BACKING_STORE_ERASE_SIZE); i += (EXTERNAL_FLASH_SECTOR_SIZE)) {
+        if (flash_erase_sector(offset + i) != FLASH_STATUS_SUCCESS) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -69,26 +86,23 @@ bool backing_store_read_bulk(uint32_t address, backing_store_int_t *values, size
 }
 
 bool backing_store_write_bulk(uint32_t address, backing_store_int_t *values, size_t item_count) {
-    uint32_t            offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
-    size_t              index  = 0;
-    backing_store_int_t temp[WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT];
+    uint32_t offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
+    size_t   index  = 0;
     do {
-        // Copy out the block of data we want to transmit first
-        size_t this_loop = MIN(item_count, WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT);
-        for (size_t i = 0; i < this_loop; ++i) {
-            temp[i] = values[index + i];
-        }
+        // Don't cross a page boundary, so that each block of data is programmed in one go
+        size_t page_items = ((EXTERNAL_FLASH_PAGE_SIZE) - (offset % (EXTERNAL_FLASH_PAGE_SIZE))) / sizeof(backing_store_int_t);
+        size_t this_loop  = MIN(MIN(item_count, WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT), page_items);
 
         bs_dprintf("Write ");
-        wl_dump(offset, temp, sizeof(backing_store_int_t) * this_loop);
+        wl_dump(offset, &values[index], sizeof(backing_store_int_t) * this_loop);
 
         // Take the complement instead
         for (size_t i = 0; i < this_loop; ++i) {
-            temp[i] = ~temp[i];
+            bulk_buffer[i] = ~values[index + i];
         }
 
         // Write out the block
-        if (flash_write_range(offset, temp, sizeof(backing_store_int_t) * this_loop) != FLASH_STATUS_SUCCESS) {
+        if (flash_write_range(offset, bulk_buffer, sizeof(backing_store_int_t) * this_loop) != FLASH_STATUS_SUCCESS) {
             return false;
         }
 
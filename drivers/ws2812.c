@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ws2812.h"
+
+// Defaults for drivers that can't send in the background, including custom ones.
+
+__attribute__((weak)) void ws2812_setleds_async(rgb_led_t *ledarray, uint16_t number_of_leds) {
+    ws2812_setleds(ledarray, number_of_leds);
+}
+
+__attribute__((weak)) bool ws2812_is_busy(void) {
+    return false;
+}
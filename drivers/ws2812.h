@@ -76,3 +76,15 @@ void ws2812_init(void);
  *         - Wait 50us to reset the LEDs
  */
 void ws2812_setleds(rgb_led_t *ledarray, uint16_t number_of_leds);
+
+/*
+ * Start sending RGB data to the LEDs, without waiting for it to go out where the driver can send in the
+ * background. The data is copied or encoded before returning, so ledarray may be changed straight away.
+ * Drivers that can't send in the background send synchronously.
+ */
+void ws2812_setleds_async(rgb_led_t *ledarray, uint16_t number_of_leds);
+
+/*
+ * Whether a frame is still being sent. Calling ws2812_setleds_async() while busy may have to wait for it.
+ */
+bool ws2812_is_busy(void);
@@ -3,6 +3,7 @@
 import datetime
 import math
 import re
+from collections import deque
 from string import Template
 from PIL import Image, ImageOps
 
@@ -124,7 +125,7 @@ def _render_image_metadata(metadata):
             # Unpack rect's coords
             l, t, r, b = v["delta_rect"]
 
-            delta_px = (r - l) * (b - t)
+            delta_px = (r - l + 1) * (b - t + 1)
             px = size["width"] * size["height"]
 
             # FIXME: May need need more chars here too
@@ -430,3 +431,85 @@ def compress_bytes_qmk_rle(bytearray):
                 temp = []
                 repeat = False
     return output
+
+
+# QMK LZ parameters, fixed by the decoder -- see qp_draw.h
+LZ_WINDOW_SIZE = 1024
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = LZ_MIN_MATCH + 31 + 255
+LZ_MAX_LITERALS = 128
+LZ_MAX_CANDIDATES = 64
+
+
+def compress_bytes_qmk_lz(bytearray):
+    """Compresses the supplied bytes as runs of literal bytes, and matches copied from the previous 1024 bytes.
+    """
+    data = bytes(bytearray)
+    output = []
+    literals = []
+    chains = {}
+
+    def flush_literals():
+        while literals:
+            run = literals[:LZ_MAX_LITERALS]
+            del literals[:LZ_MAX_LITERALS]
+            output.append(len(run) - 1)
+            output.extend(run)
+
+    def remember(pos):
+        # Index each position by the bytes starting there, forgetting positions that have fallen out of the window
+        if pos + LZ_MIN_MATCH <= len(data):
+            chain = chains.setdefault(data[pos:pos + LZ_MIN_MATCH], deque(maxlen=LZ_MAX_CANDIDATES))
+            chain.append(pos)
+
+    pos = 0
+    while pos < len(data):
+        best_length = 0
+        best_distance = 0
+        limit = min(len(data) - pos, LZ_MAX_MATCH)
+        for candidate in reversed(chains.get(data[pos:pos + LZ_MIN_MATCH], ())):
+            distance = pos - candidate
+            if distance > LZ_WINDOW_SIZE:
+                break
+            # Matches may overlap the bytes they produce, the decoder copies one byte at a time
+            length = LZ_MIN_MATCH
+            while length < limit and data[candidate + length] == data[pos + length]:
+                length += 1
+            if length > best_length:
+                best_length = length
+                best_distance = distance
+                if length == limit:
+                    break
+
+        if best_length >= LZ_MIN_MATCH:
+            flush_literals()
+            length_code = min(best_length - LZ_MIN_MATCH, 31)
+            output.append(0x80 | (length_code << 2) | ((best_distance - 1) >> 8))
+            output.append((best_distance - 1) & 0xFF)
+            if length_code == 31:
+                output.append(best_length - LZ_MIN_MATCH - 31)
+            for n in range(pos, pos + best_length):
+                remember(n)
+            pos += best_length
+        else:
+            literals.append(data[pos])
+            remember(pos)
+            pos += 1
+
+    flush_literals()
+    return output
+
+
+def compress_bytes_qmk(bytearray, *, use_rle, use_lz=False):
+    """Picks the smallest of the enabled encodings for the supplied bytes.
+
+    Returns the compression scheme (see qp.h, painter_compression_t) along with the encoded bytes.
+    """
+    candidates = [(0x00, bytearray)]
+    if use_rle:
+        candidates.append((0x01, compress_bytes_qmk_rle(bytearray)))
+    if use_lz:
+        candidates.append((0x02, compress_bytes_qmk_lz(bytearray)))
+
+    # Ties go to the simplest encoding, as it's the fastest to decode
+    return min(candidates, key=lambda c: len(c[1]))
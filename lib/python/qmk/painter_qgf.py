@@ -8,7 +8,7 @@
 import functools
 from colorsys import rgb_to_hsv
 from types import FunctionType
-from PIL import Image, ImageFile, ImageChops
+from PIL import Image, ImageFile, ImageChops, ImageOps
 from PIL._binary import o8, o16le as o16, o32le as o32
 import qmk.painter
 
@@ -245,42 +245,75 @@ def _accept(prefix):
     return False
 
 
-def _for_all_frames(x: FunctionType, /, images):
-    frame_num = 0
+def _for_all_frames(x: FunctionType, /, frames):
     last_frame = None
-    for frame in images:
+    for frame_num, frame in enumerate(frames):
+        x(frame_num, frame, last_frame)
+        last_frame = frame
+
+
+def _quantize_for_deltas(frame, format_):
+    """Reduces a frame to the precision that the requested format keeps, so that changes which won't be visible on the
+    device don't count as differences.
+    """
+    image_format = format_['image_format']
+    if image_format == 'IMAGE_FORMAT_GRAYSCALE':
+        maxval = format_['num_colors'] - 1
+        return ImageOps.grayscale(frame).point(lambda v: qmk.painter.rescale_byte(v, maxval))
+    if image_format == 'IMAGE_FORMAT_RGB565':
+        r, g, b = frame.convert("RGB").split()
+        return Image.merge("RGB", (r.point(lambda v: v >> 3), g.point(lambda v: v >> 2), b.point(lambda v: v >> 3)))
+
+    # Palettes are worked out separately for each frame, so only the original pixels can be compared
+    return frame
+
+
+def _delta_bbox(frame, last_frame, format_):
+    """Finds the area of the frame that differs from the previous one, or None if nothing does.
+    """
+    diff = ImageChops.difference(_quantize_for_deltas(frame, format_), _quantize_for_deltas(last_frame, format_))
+    return diff.getbbox()
+
+
+def _collect_frames(images, *, format_, merge_unchanged):
+    """Gathers all the frames of the input images, merging frames which don't change anything into the previous one.
+    """
+    frames = []
+    for image in images:
         # Get number of of frames in this image
-        nfr = getattr(frame, "n_frames", 1)
+        nfr = getattr(image, "n_frames", 1)
         for idx in range(nfr):
-            frame.seek(idx)
-            frame.load()
-            copy = frame.copy().convert("RGB")
-            x(frame_num, copy, last_frame)
-            last_frame = copy
-            frame_num += 1
+            image.seek(idx)
+            image.load()
+            copy = image.copy().convert("RGB")
+            copy.info['duration'] = image.info.get('duration', 1000)  # If we're not an animation, just pretend we're delaying for 1000ms
 
+            if merge_unchanged and frames:
+                # The delay of the previous frame has to fit in the frame descriptor
+                last_frame = frames[-1]
+                merged_delay = last_frame.info['duration'] + copy.info['duration']
+                if merged_delay <= 0xFFFF and _delta_bbox(copy, last_frame, format_) is None:
+                    last_frame.info['duration'] = merged_delay
+                    continue
 
-def _compress_image(frame, last_frame, *, use_rle, use_deltas, format_, **_kwargs):
+            frames.append(copy)
+    return frames
+
+
+def _compress_image(frame, last_frame, *, use_rle, use_lz, use_deltas, format_, **_kwargs):
     # Convert the original frame so we can do comparisons
     converted = qmk.painter.convert_requested_format(frame, format_)
     graphic_data = qmk.painter.convert_image_bytes(converted, format_)
 
-    # Convert the raw data to RLE-encoded if requested
-    raw_data = graphic_data[1]
-    if use_rle:
-        rle_data = qmk.painter.compress_bytes_qmk_rle(graphic_data[1])
-    use_raw_this_frame = not use_rle or len(raw_data) <= len(rle_data)
-    image_data = raw_data if use_raw_this_frame else rle_data
+    # Compress the raw data if requested, and if it helps
+    compression, image_data = qmk.painter.compress_bytes_qmk(graphic_data[1], use_rle=use_rle, use_lz=use_lz)
 
     # Work out if a delta frame is smaller than injecting it directly
     use_delta_this_frame = False
     bbox = None
     if use_deltas and last_frame is not None:
-        # If we want to use deltas, then find the difference
-        diff = ImageChops.difference(frame, last_frame)
-
-        # Get the bounding box of those differences
-        bbox = diff.getbbox()
+        # If we want to use deltas, then find the bounding box of the differences that remain after conversion
+        bbox = _delta_bbox(frame, last_frame, format_)
 
         # If we have a valid bounding box...
         if bbox:
@@ -292,11 +325,7 @@ def _compress_image(frame, last_frame, *, use_rle, use_deltas, format_, **_kwarg
             delta_graphic_data = qmk.painter.convert_image_bytes(delta_converted, format_)
 
             # Work out how large the delta frame is going to be with compression etc.
-            delta_raw_data = delta_graphic_data[1]
-            if use_rle:
-                delta_rle_data = qmk.painter.compress_bytes_qmk_rle(delta_graphic_data[1])
-            delta_use_raw_this_frame = not use_rle or len(delta_raw_data) <= len(delta_rle_data)
-            delta_image_data = delta_raw_data if delta_use_raw_this_frame else delta_rle_data
+            delta_compression, delta_image_data = qmk.painter.compress_bytes_qmk(delta_graphic_data[1], use_rle=use_rle, use_lz=use_lz)
 
             # If the size of the delta frame (plus delta descriptor) is smaller than the original, use that instead
             # This ensures that if a non-delta is overall smaller in size, we use that in preference due to flash
@@ -304,9 +333,7 @@ def _compress_image(frame, last_frame, *, use_rle, use_deltas, format_, **_kwarg
             if (len(delta_image_data) + QGFFrameDeltaDescriptorV1.length) < len(image_data):
                 # Copy across all the delta equivalents so that the rest of the processing acts on those
                 graphic_data = delta_graphic_data
-                raw_data = delta_raw_data
-                rle_data = delta_rle_data
-                use_raw_this_frame = delta_use_raw_this_frame
+                compression = delta_compression
                 image_data = delta_image_data
                 use_delta_this_frame = True
 
@@ -319,10 +346,10 @@ def _compress_image(frame, last_frame, *, use_rle, use_deltas, format_, **_kwarg
 
     return {
         "bbox": bbox,
+        "compression": compression,
         "graphic_data": graphic_data,
         "image_data": image_data,
         "use_delta_this_frame": use_delta_this_frame,
-        "use_raw_this_frame": use_raw_this_frame,
     }
 
 
@@ -338,7 +365,6 @@ def _write_frame(idx, frame, last_frame, *, fp, frame_offsets, metadata, **kwarg
     graphic_data = outputs["graphic_data"]
     image_data = outputs["image_data"]
     use_delta_this_frame = outputs["use_delta_this_frame"]
-    use_raw_this_frame = outputs["use_raw_this_frame"]
 
     # Write out the frame descriptor
     frame_offsets.frame_offsets[idx] = fp.tell()
@@ -347,8 +373,8 @@ def _write_frame(idx, frame, last_frame, *, fp, frame_offsets, metadata, **kwarg
     frame_descriptor.is_delta = use_delta_this_frame
     frame_descriptor.is_transparent = False
     frame_descriptor.format = format_['image_format_byte']
-    frame_descriptor.compression = 0x00 if use_raw_this_frame else 0x01  # See qp.h, painter_compression_t
-    frame_descriptor.delay = frame.info.get('duration', 1000)  # If we're not an animation, just pretend we're delaying for 1000ms
+    frame_descriptor.compression = outputs["compression"]  # See qp.h, painter_compression_t
+    frame_descriptor.delay = frame.info['duration']
     frame_descriptor.write(fp)
 
     # Write out the palette if required
@@ -408,9 +434,12 @@ def _save(im, fp, _filename):
     verbose = encoderinfo.get("verbose", False)
     vprint = print if verbose else lambda *_args, **_kwargs: None
 
-    # Helper to iterate through all frames in the input image
+    # Helper to iterate through all frames in the input image, frames that don't change anything are dropped when using
+    # deltas as the previous frame stays on screen for longer instead
     append_images = list(encoderinfo.get("append_images", []))
-    for_all_frames = functools.partial(_for_all_frames, images=[im, *append_images])
+    use_deltas = encoderinfo.get("use_deltas", True)
+    frames = _collect_frames([im, *append_images], format_=encoderinfo["qmk_format"], merge_unchanged=use_deltas)
+    for_all_frames = functools.partial(_for_all_frames, frames=frames)
 
     # Collect all the frame sizes
     frame_sizes = []
@@ -437,7 +466,7 @@ def _save(im, fp, _filename):
     frame_offsets.write(fp)
 
     # Iterate over each if the input frames, writing it to the output in the process
-    write_frame = functools.partial(_write_frame, format_=encoderinfo["qmk_format"], fp=fp, use_deltas=encoderinfo.get("use_deltas", True), use_rle=encoderinfo.get("use_rle", True), frame_offsets=frame_offsets, metadata=metadata)
+    write_frame = functools.partial(_write_frame, format_=encoderinfo["qmk_format"], fp=fp, use_deltas=use_deltas, use_rle=encoderinfo.get("use_rle", True), use_lz=encoderinfo.get("use_lz", False), frame_offsets=frame_offsets, metadata=metadata)
     for_all_frames(write_frame)
 
     # Go back and update the graphics descriptor now that we can determine the final file size
@@ -167,6 +167,23 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+// There's no DMA to hand the transfer to, so everything is sent before returning.
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length, spi_async_next_t next) {
+    do {
+        spi_status_t status = spi_transmit(data, length);
+
+        if (status < 0) {
+            return status;
+        }
+    } while (next != NULL && next(&data, &length));
+
+    return SPI_STATUS_SUCCESS;
+}
+
+bool spi_is_busy(void) {
+    return false;
+}
+
 void spi_stop(void) {
     if (currentSlavePin != NO_PIN) {
         gpio_set_pin_output(currentSlavePin);
@@ -178,3 +195,7 @@ void spi_stop(void) {
         currentSlave2X     = false;
     }
 }
+
+void spi_stop_async(void) {
+    spi_stop();
+}
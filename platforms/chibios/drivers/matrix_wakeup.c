@@ -0,0 +1,41 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <hal.h>
+#include "matrix_wakeup.h"
+
+#if PAL_USE_CALLBACKS == TRUE
+
+static void matrix_wakeup_callback(void *arg) {
+    (void)arg;
+    matrix_wakeup_signal();
+}
+
+bool matrix_wakeup_arm_pins(const pin_t *pins, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] == NO_PIN) {
+            continue;
+        }
+        // Lines may share an event slot (e.g. A1 and B1 on STM32 EXTI), or already belong to an encoder or motion
+        // pin. Taking it over would break the other user, so fall back to polling instead.
+        if (palGetLineEvent(pins[i])->cb != NULL) {
+            matrix_wakeup_disarm_pins(pins, i);
+            return false;
+        }
+        palSetLineCallback(pins[i], matrix_wakeup_callback, NULL);
+        palEnableLineEvent(pins[i], PAL_EVENT_MODE_BOTH_EDGES);
+    }
+    return true;
+}
+
+void matrix_wakeup_disarm_pins(const pin_t *pins, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] == NO_PIN) {
+            continue;
+        }
+        // Also clears the callback, releasing the line
+        palDisableLineEvent(pins[i]);
+    }
+}
+
+#endif // PAL_USE_CALLBACKS == TRUE
@@ -0,0 +1,24 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <hal.h>
+#include "pointing_device_motion.h"
+
+#if PAL_USE_CALLBACKS == TRUE
+
+static void pointing_device_motion_callback(void *arg) {
+    (void)arg;
+    pointing_device_motion_signal();
+}
+
+bool pointing_device_motion_arm_pin(pin_t pin, bool active_low) {
+    // The line's interrupt may already belong to an encoder or the matrix, poll the sensor instead
+    if (palGetLineEvent(pin)->cb != NULL) {
+        return false;
+    }
+    palSetLineCallback(pin, pointing_device_motion_callback, NULL);
+    palEnableLineEvent(pin, active_low ? PAL_EVENT_MODE_FALLING_EDGE : PAL_EVENT_MODE_RISING_EDGE);
+    return true;
+}
+
+#endif // PAL_USE_CALLBACKS == TRUE
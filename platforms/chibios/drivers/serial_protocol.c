@@ -7,6 +7,13 @@
 #include "serial_protocol.h"
 #include "synchronization_util.h"
 
+#if defined(SPLIT_LINK_STATS_ENABLE)
+#    include "split_link_stats.h"
+#    define serial_link_error(status) split_link_stats_error(status)
+#else
+#    define serial_link_error(status)
+#endif
+
 static inline bool initiate_transaction(uint8_t transaction_id);
 static inline bool react_to_transaction(void);
 
@@ -133,10 +140,15 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
      *   - due to the half duplex limitations on return codes, we always have to read *something*.
      *   - without the read, write only transactions *always* succeed, even during the boot process where the slave is not ready.
      */
-    if (unlikely(!serial_transport_receive(&transaction_id_shake, sizeof(transaction_id_shake)) || (transaction_id_shake != (transaction_id ^ NUM_TOTAL_TRANSACTIONS)))) {
+    if (unlikely(!serial_transport_receive(&transaction_id_shake, sizeof(transaction_id_shake)))) {
         serial_dprintf("SPLIT: receiving handshake failed\n");
         return false;
     }
+    if (unlikely(transaction_id_shake != (transaction_id ^ NUM_TOTAL_TRANSACTIONS))) {
+        serial_dprintf("SPLIT: corrupted handshake\n");
+        serial_link_error(SPLIT_LINK_CRC_ERROR);
+        return false;
+    }
 
     /* Send transaction buffer to the slave. If this transaction requires it. */
     if (transaction->initiator2target_buffer_size) {
@@ -156,3 +168,13 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     return true;
 }
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+/**
+ * @brief Change the link speed, dropping anything received at the old speed.
+ */
+void soft_serial_set_speed_level(uint8_t level) {
+    serial_transport_driver_set_speed_level(level);
+    serial_transport_driver_clear();
+}
+#endif
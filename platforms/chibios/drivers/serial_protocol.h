@@ -24,6 +24,11 @@ void serial_transport_driver_slave_init(void);
  */
 void serial_transport_driver_master_init(void);
 
+/**
+ * @brief Change the speed of the link to SERIAL_USART_SPEED * 2^level.
+ */
+void serial_transport_driver_set_speed_level(uint8_t level);
+
 /**
  * @brief  Blocking receive of size * bytes.
  *
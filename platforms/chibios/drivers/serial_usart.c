@@ -50,6 +50,10 @@ static inline void usart_driver_start(void) {
     sdStart(serial_driver, &serial_config);
 }
 
+static inline void usart_driver_stop(void) {
+    sdStop(serial_driver);
+}
+
 inline void serial_transport_driver_clear(void) {
     osalSysLock();
     bool volatile queue_not_empty = !iqIsEmptyI(&serial_driver->iqueue);
@@ -80,6 +84,10 @@ static inline void usart_driver_start(void) {
     sioStart(serial_driver, &serial_config);
 }
 
+static inline void usart_driver_stop(void) {
+    sioStop(serial_driver);
+}
+
 inline void serial_transport_driver_clear(void) {
     if (sioHasRXErrorsX(serial_driver)) {
         sioGetAndClearErrors(serial_driver);
@@ -235,3 +243,16 @@ void serial_transport_driver_master_init(void) {
 
     usart_driver_start();
 }
+
+/**
+ * @brief Restart the USART peripheral at SERIAL_USART_SPEED * 2^level.
+ */
+void serial_transport_driver_set_speed_level(uint8_t level) {
+    usart_driver_stop();
+#if defined(MCU_STM32) && HAL_USE_SERIAL
+    serial_config.speed = (uint32_t)(SERIAL_USART_SPEED) << level;
+#else
+    serial_config.baud = (uint32_t)(SERIAL_USART_SPEED) << level;
+#endif
+    usart_driver_start();
+}
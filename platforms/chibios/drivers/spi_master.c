@@ -26,6 +26,46 @@ static pin_t currentSlavePin;
 
 static SPIConfig spiConfig;
 
+// State of an asynchronous transmission, the interrupt keeps it going for as long as spiAsyncNext has more to send.
+static volatile bool    spiAsyncBusy   = false;
+static bool             spiStopPending = false;
+static spi_async_next_t spiAsyncNext   = NULL;
+
+static void spi_async_end_cb(SPIDriver *spip) {
+    if (!spiAsyncBusy) {
+        // A blocking transfer, the waiting thread is woken up by the driver.
+        return;
+    }
+
+    const uint8_t *data;
+    uint16_t       length;
+    if (spiAsyncNext != NULL && spiAsyncNext(&data, &length)) {
+        osalSysLockFromISR();
+        spiStartSendI(spip, length, data);
+        osalSysUnlockFromISR();
+        return;
+    }
+
+    if (spiStopPending) {
+        // The slave can be released right away, the rest of spi_stop() has to wait for thread context.
+#if SPI_SELECT_MODE == SPI_SELECT_MODE_NONE
+        if (currentSlavePin != NO_PIN) {
+            gpio_write_pin_high(currentSlavePin);
+        }
+#else
+        osalSysLockFromISR();
+        spiUnselectI(spip);
+        osalSysUnlockFromISR();
+#endif
+    }
+    spiAsyncBusy = false;
+}
+
+static inline void spi_async_wait(void) {
+    while (spiAsyncBusy) {
+    }
+}
+
 __attribute__((weak)) void spi_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -64,6 +104,11 @@ __attribute__((weak)) void spi_init(void) {
 }
 
 bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    // Finish off a transaction that was left to complete in the background.
+    if (spiStopPending) {
+        spi_stop();
+    }
+
 #if (SPI_USE_MUTUAL_EXCLUSION == TRUE)
     spiAcquireBus(&SPI_DRIVER);
 #endif // (SPI_USE_MUTUAL_EXCLUSION == TRUE)
@@ -269,6 +314,12 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     }
 #endif
 
+#if defined(HAL_LLD_SELECT_SPI_V2)
+    spiConfig.data_cb = spi_async_end_cb;
+#else
+    spiConfig.end_cb = spi_async_end_cb;
+#endif
+
     spiStarted = true;
 #if SPI_SELECT_MODE == SPI_SELECT_MODE_NONE
     currentSlavePin = slavePin;
@@ -297,6 +348,8 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
 }
 
 spi_status_t spi_write(uint8_t data) {
+    spi_async_wait();
+
     uint8_t rxData;
     spiExchange(&SPI_DRIVER, 1, &data, &rxData);
 
@@ -304,6 +357,8 @@ spi_status_t spi_write(uint8_t data) {
 }
 
 spi_status_t spi_read(void) {
+    spi_async_wait();
+
     uint8_t data = 0;
     spiReceive(&SPI_DRIVER, 1, &data);
 
@@ -311,16 +366,36 @@ spi_status_t spi_read(void) {
 }
 
 spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    spi_async_wait();
+
     spiSend(&SPI_DRIVER, length, data);
     return SPI_STATUS_SUCCESS;
 }
 
 spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    spi_async_wait();
+
     spiReceive(&SPI_DRIVER, length, data);
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length, spi_async_next_t next) {
+    spi_async_wait();
+
+    spiAsyncNext = next;
+    spiAsyncBusy = true;
+    spiStartSend(&SPI_DRIVER, length, data);
+    return SPI_STATUS_SUCCESS;
+}
+
+bool spi_is_busy(void) {
+    return spiAsyncBusy;
+}
+
 void spi_stop(void) {
+    spi_async_wait();
+    spiStopPending = false;
+
     if (spiStarted) {
 #if SPI_SELECT_MODE == SPI_SELECT_MODE_NONE
         if (currentSlavePin != NO_PIN) {
@@ -336,3 +411,16 @@ void spi_stop(void) {
     spiReleaseBus(&SPI_DRIVER);
 #endif // (SPI_USE_MUTUAL_EXCLUSION == TRUE)
 }
+
+void spi_stop_async(void) {
+    osalSysLock();
+    bool busy = spiAsyncBusy;
+    if (busy) {
+        spiStopPending = true;
+    }
+    osalSysUnlock();
+
+    if (!busy) {
+        spi_stop();
+    }
+}
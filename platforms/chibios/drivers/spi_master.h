@@ -72,6 +72,12 @@ typedef int16_t spi_status_t;
 #define SPI_TIMEOUT_IMMEDIATE (0)
 #define SPI_TIMEOUT_INFINITE (0xFFFF)
 
+/**
+ * Supplies the next chunk of an asynchronous transmission. Called from the SPI interrupt once the previous chunk has
+ * been sent, so it must not block. Returns false when there is nothing more to send.
+ */
+typedef bool (*spi_async_next_t)(const uint8_t **data, uint16_t *length);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -87,7 +93,13 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 
 spi_status_t spi_receive(uint8_t *data, uint16_t length);
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length, spi_async_next_t next);
+
+bool spi_is_busy(void);
+
 void spi_stop(void);
+
+void spi_stop_async(void);
 #ifdef __cplusplus
 }
 #endif
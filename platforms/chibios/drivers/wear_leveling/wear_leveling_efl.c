@@ -133,6 +133,38 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+bool backing_store_erase_block(uint32_t address) {
+    flash_offset_t start = base_offset + address;
+    flash_offset_t end   = start + (BACKING_STORE_ERASE_SIZE);
+    bool           found = false;
+    flash_error_t  status;
+    for (int i = 0; i < sector_count; ++i) {
+        flash_offset_t offset = flashGetSectorOffset(flash, first_sector + i);
+        if (offset < start || offset >= end) {
+            continue;
+        }
+
+        // Sectors can't be partially erased, so the block needs to cover whole sectors
+        if (offset + flashGetSectorSize(flash, first_sector + i) > end) {
+            bs_dprintf("Erase size is not a multiple of the sector size\n");
+            return false;
+        }
+        found |= (offset == start);
+
+        status = flashStartEraseSector(flash, first_sector + i);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            return false;
+        }
+        status = flashWaitErase(flash);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            return false;
+        }
+    }
+    return found;
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     uint32_t offset = (base_offset + address);
     bs_dprintf("Write ");
@@ -177,6 +209,23 @@ bool backing_store_read(uint32_t address, backing_store_int_t *value) {
     return true;
 }
 
+bool backing_store_read_bulk(uint32_t address, backing_store_int_t *values, size_t item_count) {
+    uint32_t             offset = (base_offset + address);
+    backing_store_int_t *loc    = (backing_store_int_t *)flashGetOffsetAddress(flash, offset);
+    for (size_t i = 0; i < item_count; ++i) {
+        values[i] = backing_store_safe_read_from_location(&loc[i]);
+        if (ecc_error_occurred) {
+            bs_dprintf("Failed to read from backing store, ECC error detected\n");
+            ecc_error_occurred = false;
+            return false;
+        }
+    }
+
+    bs_dprintf("Read  ");
+    wl_dump(offset, values, sizeof(backing_store_int_t) * item_count);
+    return true;
+}
+
 bool backing_store_allow_ecc_errors(void) {
     return is_issuing_read;
 }
@@ -48,7 +48,16 @@
 #    define WEAR_LEVELING_BACKING_SIZE 2048
 #endif // WEAR_LEVELING_BACKING_SIZE
 
-// 1kB logical EEPROM
+// 1kB logical EEPROM, or 512B if background consolidation needs to keep two copies
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
+
+// Sector sizes vary between MCUs, so by default erase half of the backing store at a time
+#ifndef BACKING_STORE_ERASE_SIZE
+#    define BACKING_STORE_ERASE_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#endif // BACKING_STORE_ERASE_SIZE
@@ -37,6 +37,13 @@
 #    define WS2812_RES (1000 * WS2812_TRST_US) // Width of the low gap between bits to cause a frame to latch
 #endif
 
+// Interrupts are held off while a chunk of this many LEDs is sent, and serviced between chunks. The default of 0 holds
+// them off for the whole strip, as any interrupt that keeps the data line low for longer than the LEDs tolerate
+// latches the frame early.
+#ifndef WS2812_BITBANG_CHUNK_LEDS
+#    define WS2812_BITBANG_CHUNK_LEDS 0
+#endif
+
 #define NUMBER_NOPS 6
 #define CYCLES_PER_SEC (CPU_CLOCK / NUMBER_NOPS * WS2812_BITBANG_NOP_FUDGE)
 #define NS_PER_SEC (1000000000L) // Note that this has to be SIGNED since we want to be able to check for negative values of derivatives
@@ -85,7 +92,15 @@ void ws2812_setleds(rgb_led_t *ledarray, uint16_t leds) {
     // this code is very time dependent, so we need to disable interrupts
     chSysLock();
 
-    for (uint8_t i = 0; i < leds; i++) {
+    for (uint16_t i = 0; i < leds; i++) {
+#if WS2812_BITBANG_CHUNK_LEDS > 0
+        if (i > 0 && i % WS2812_BITBANG_CHUNK_LEDS == 0) {
+            // Let any pending interrupts run before the next chunk.
+            chSysUnlock();
+            chSysLock();
+        }
+#endif
+
         // WS2812 protocol dictates grb order
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
         sendByte(ledarray[i].g);
@@ -106,7 +121,8 @@ void ws2812_setleds(rgb_led_t *ledarray, uint16_t leds) {
 #endif
     }
 
-    wait_ns(WS2812_RES);
-
     chSysUnlock();
+
+    // Interrupts only make the reset gap longer, which is harmless.
+    wait_ns(WS2812_RES);
 }
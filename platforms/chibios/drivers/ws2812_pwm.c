@@ -397,3 +397,12 @@ void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
 #endif
     }
 }
+
+// The DMA streams the frame buffer out continuously, so writing to it never has to wait.
+void ws2812_setleds_async(rgb_led_t* ledarray, uint16_t leds) {
+    ws2812_setleds(ledarray, leds);
+}
+
+bool ws2812_is_busy(void) {
+    return false;
+}
@@ -1,5 +1,6 @@
 #include "ws2812.h"
 #include "gpio.h"
+#include "timer.h"
 #include "util.h"
 #include "chibios_config.h"
 
@@ -62,6 +63,11 @@
 #    error "Configured WS2812_SPI_DIVISOR value is not supported at this time."
 #endif
 
+// Longest time a frame may take to go out before the transfer is considered stuck, in milliseconds
+#ifndef WS2812_SPI_TIMEOUT
+#    define WS2812_SPI_TIMEOUT 100
+#endif
+
 // Use SPI circular buffer
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
 #    define WS2812_SPI_BUFFER_MODE 1 // circular buffer
@@ -86,54 +92,92 @@
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
+
+#if defined(WS2812_SPI_DOUBLE_BUFFER) && (defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_SYNC))
+#    error "WS2812_SPI_DOUBLE_BUFFER can't be combined with WS2812_SPI_USE_CIRCULAR_BUFFER or WS2812_SPI_SYNC"
+#endif
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#    error "The ws2812 SPI encoder table assumes a little endian MCU"
+#endif
+
+// Every 32-bit store covers exactly one color byte, so they must be aligned.
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+// One frame is encoded while the other is being sent.
+static uint8_t  txbufs[2][TXBUF_SIZE] __attribute__((aligned(4))) = {{0}};
+static uint8_t* txbuf                                              = txbufs[0];
+#else
+static uint8_t txbuf[TXBUF_SIZE] __attribute__((aligned(4))) = {0};
+#endif
+
+#if !defined(WS2812_SPI_USE_CIRCULAR_BUFFER) && !defined(WS2812_SPI_SYNC)
+static volatile bool ws2812_spi_busy = false;
+
+static void ws2812_spi_end_cb(SPIDriver* spip) {
+    (void)spip;
+    ws2812_spi_busy = false;
+}
+
+// Wait for the previous frame to go out. A transfer that never completes is aborted, rather than hanging the keyboard.
+static void ws2812_spi_wait(void) {
+    uint16_t start = timer_read();
+    while (ws2812_spi_busy) {
+        if (timer_elapsed(start) > WS2812_SPI_TIMEOUT) {
+#    if defined(HAL_LLD_SELECT_SPI_V2)
+            spiStopTransfer(&WS2812_SPI_DRIVER, NULL);
+#    elif SPI_SUPPORTS_CIRCULAR == TRUE
+            spiAbort(&WS2812_SPI_DRIVER);
+#    else
+            // No way to abort a transfer, restart the peripheral instead
+            const SPIConfig* config = WS2812_SPI_DRIVER.config;
+            spiStop(&WS2812_SPI_DRIVER);
+            spiStart(&WS2812_SPI_DRIVER, config);
+#    endif
+            ws2812_spi_busy = false;
+        }
+    }
+}
+#    define WS2812_SPI_END_CB ws2812_spi_end_cb
+#else
+#    define WS2812_SPI_END_CB NULL
+#endif
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * the ws2812b protocol, every bit of a color is sent as a nibble of 0b1110 or
+ * 0b1000 (with the appropriate timing). The patterns for all 256 byte values
+ * are precomputed, so encoding a color byte is a single 32-bit store.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
-}
+#define WS2812_SPI_BIT_PAIR(data) ((((data)&2) ? 0xE0 : 0x80) | (((data)&1) ? 0x0E : 0x08))
+#define WS2812_SPI_BYTE(data) ((uint32_t)WS2812_SPI_BIT_PAIR((data) >> 6) | (uint32_t)WS2812_SPI_BIT_PAIR((data) >> 4) << 8 | (uint32_t)WS2812_SPI_BIT_PAIR((data) >> 2) << 16 | (uint32_t)WS2812_SPI_BIT_PAIR(data) << 24)
+#define WS2812_SPI_BYTES_4(n) WS2812_SPI_BYTE(n), WS2812_SPI_BYTE((n) + 1), WS2812_SPI_BYTE((n) + 2), WS2812_SPI_BYTE((n) + 3)
+#define WS2812_SPI_BYTES_16(n) WS2812_SPI_BYTES_4(n), WS2812_SPI_BYTES_4((n) + 4), WS2812_SPI_BYTES_4((n) + 8), WS2812_SPI_BYTES_4((n) + 12)
+#define WS2812_SPI_BYTES_64(n) WS2812_SPI_BYTES_16(n), WS2812_SPI_BYTES_16((n) + 16), WS2812_SPI_BYTES_16((n) + 32), WS2812_SPI_BYTES_16((n) + 48)
+
+static const uint32_t ws2812_spi_patterns[256] = {WS2812_SPI_BYTES_64(0), WS2812_SPI_BYTES_64(64), WS2812_SPI_BYTES_64(128), WS2812_SPI_BYTES_64(192)};
+
+_Static_assert(BYTES_FOR_LED_BYTE == sizeof(uint32_t), "Each color byte must be encoded as one table entry");
+_Static_assert(PREAMBLE_SIZE % sizeof(uint32_t) == 0, "The encoded colors must be aligned");
 
 static void set_led_color_rgb(rgb_led_t color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
+    uint32_t* tx_start = (uint32_t*)&txbuf[PREAMBLE_SIZE + BYTES_FOR_LED * pos];
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    tx_start[0] = ws2812_spi_patterns[color.g];
+    tx_start[1] = ws2812_spi_patterns[color.r];
+    tx_start[2] = ws2812_spi_patterns[color.b];
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    tx_start[0] = ws2812_spi_patterns[color.r];
+    tx_start[1] = ws2812_spi_patterns[color.g];
+    tx_start[2] = ws2812_spi_patterns[color.b];
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.b, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.r, j);
+    tx_start[0] = ws2812_spi_patterns[color.b];
+    tx_start[1] = ws2812_spi_patterns[color.g];
+    tx_start[2] = ws2812_spi_patterns[color.r];
 #endif
 #ifdef WS2812_RGBW
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 3 + j] = get_protocol_eq(color.w, j);
+    tx_start[3] = ws2812_spi_patterns[color.w];
 #endif
 }
 
@@ -151,7 +195,7 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_CIRCULAR == TRUE
         WS2812_SPI_BUFFER_MODE,
 #    endif
-        NULL, // end_cb
+        WS2812_SPI_END_CB, // end_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
 #    if defined(WB32F3G71xx) || defined(WB32FQ95xx)
@@ -170,8 +214,8 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
-        NULL, // data_cb
-        NULL, // error_cb
+        WS2812_SPI_END_CB, // data_cb
+        NULL,              // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
         WS2812_SPI_DIVISOR_CR1_BR_X,
@@ -183,22 +227,48 @@ void ws2812_init(void) {
     spiStart(&WS2812_SPI_DRIVER, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI_DRIVER);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #endif
 }
 
-void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
-    for (uint8_t i = 0; i < leds; i++) {
+bool ws2812_is_busy(void) {
+#if !defined(WS2812_SPI_USE_CIRCULAR_BUFFER) && !defined(WS2812_SPI_SYNC)
+    return ws2812_spi_busy;
+#else
+    return false;
+#endif
+}
+
+void ws2812_setleds_async(rgb_led_t* ledarray, uint16_t leds) {
+#if !defined(WS2812_SPI_USE_CIRCULAR_BUFFER) && !defined(WS2812_SPI_SYNC) && !defined(WS2812_SPI_DOUBLE_BUFFER)
+    // The only buffer can't be touched until the previous frame has been sent.
+    ws2812_spi_wait();
+#endif
+
+    for (uint16_t i = 0; i < leds; i++) {
         set_led_color_rgb(ledarray[i], i);
     }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
+    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms. A flush that comes faster than that waits for the previous
+    // frame, unless WS2812_SPI_DOUBLE_BUFFER lets it encode into the other buffer first.
+    // Instead spiSend can be used to send synchronously.
 #ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
 #    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #    else
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+#        ifdef WS2812_SPI_DOUBLE_BUFFER
+    // The previous frame was sent while this one was encoded, usually it is done by now.
+    ws2812_spi_wait();
+#        endif
+    ws2812_spi_busy = true;
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
+#        ifdef WS2812_SPI_DOUBLE_BUFFER
+    txbuf = txbuf == txbufs[0] ? txbufs[1] : txbufs[0];
+#        endif
 #    endif
 #endif
 }
+
+void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
+    ws2812_setleds_async(ledarray, leds);
+}
@@ -22,6 +22,16 @@ void     eeprom_update_dword(uint32_t *__p, uint32_t __value);
 void     eeprom_update_block(const void *__src, void *__dst, size_t __n);
 #endif
 
+#if defined(EEPROM_DRIVER)
+// Stages writes in RAM until the outermost commit, then writes them back in page-sized bursts
+void eeprom_txn_begin(void);
+void eeprom_txn_commit(void);
+#else
+// Writes go straight through to the EEPROM
+static inline void eeprom_txn_begin(void) {}
+static inline void eeprom_txn_commit(void) {}
+#endif
+
 // While newer avr-libc versions may have an implementation
 //   use preprocessor as to not cause conflicts
 #undef eeprom_write_qword
@@ -0,0 +1,46 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_wakeup.h"
+
+// Simulated pin-change interrupt controller, so that event-driven scanning can be unit tested.
+
+#define MATRIX_WAKEUP_MAX_SIMULATED_PINS 64
+
+static bool  interrupts_available = true;
+static pin_t armed_pins[MATRIX_WAKEUP_MAX_SIMULATED_PINS];
+static int   armed_count = 0;
+
+void matrix_wakeup_simulate_interrupts_available(bool available) {
+    interrupts_available = available;
+}
+
+int matrix_wakeup_simulate_armed_count(void) {
+    return armed_count;
+}
+
+void matrix_wakeup_simulate_edge(pin_t pin) {
+    for (int i = 0; i < armed_count; i++) {
+        if (armed_pins[i] == pin) {
+            matrix_wakeup_signal();
+            return;
+        }
+    }
+}
+
+bool matrix_wakeup_arm_pins(const pin_t *pins, uint8_t count) {
+    if (!interrupts_available) {
+        return false;
+    }
+    armed_count = 0;
+    for (uint8_t i = 0; i < count && armed_count < MATRIX_WAKEUP_MAX_SIMULATED_PINS; i++) {
+        if (pins[i] != NO_PIN) {
+            armed_pins[armed_count++] = pins[i];
+        }
+    }
+    return true;
+}
+
+void matrix_wakeup_disarm_pins(const pin_t *pins, uint8_t count) {
+    armed_count = 0;
+}
@@ -0,0 +1,24 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "pointing_device_motion.h"
+
+// Simulated motion pin interrupt, so that interrupt driven acquisition can be unit tested.
+
+static bool  interrupts_available = true;
+static pin_t armed_pin            = NO_PIN;
+
+void pointing_device_motion_simulate_interrupts_available(bool available) {
+    interrupts_available = available;
+}
+
+void pointing_device_motion_simulate_edge(void) {
+    if (armed_pin != NO_PIN) {
+        pointing_device_motion_signal();
+    }
+}
+
+bool pointing_device_motion_arm_pin(pin_t pin, bool active_low) {
+    armed_pin = interrupts_available ? pin : NO_PIN;
+    return interrupts_available;
+}
@@ -0,0 +1,188 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom.h"
+#include "eeprom_driver.h"
+}
+
+#define MOCK_EEPROM_SIZE 1024
+
+struct MockWrite {
+    uintptr_t address;
+    size_t    length;
+};
+
+static uint8_t                mock_eeprom[MOCK_EEPROM_SIZE];
+static std::vector<MockWrite> mock_writes;
+static size_t                 mock_read_count;
+
+extern "C" {
+void eeprom_driver_init(void) {}
+
+void eeprom_driver_erase(void) {
+    memset(mock_eeprom, 0, sizeof(mock_eeprom));
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    ++mock_read_count;
+    memcpy(buf, &mock_eeprom[(uintptr_t)addr], len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    mock_writes.push_back({(uintptr_t)addr, len});
+    memcpy(&mock_eeprom[(uintptr_t)addr], buf, len);
+}
+}
+
+class EepromTxnTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        eeprom_driver_erase();
+        mock_writes.clear();
+        mock_read_count = 0;
+    }
+};
+
+TEST_F(EepromTxnTest, WritesThroughOutsideTransaction) {
+    eeprom_update_byte((uint8_t *)3, 0x42);
+    EXPECT_EQ(mock_eeprom[3], 0x42);
+    ASSERT_EQ(mock_writes.size(), 1);
+    EXPECT_EQ(mock_writes[0].address, 3);
+}
+
+TEST_F(EepromTxnTest, UpdateBlockOnlyWritesChangedSpan) {
+    uint8_t data[16] = {0};
+    data[4]          = 1;
+    data[9]          = 2;
+    eeprom_update_block(data, (void *)100, sizeof(data));
+    ASSERT_EQ(mock_writes.size(), 1);
+    EXPECT_EQ(mock_writes[0].address, 104);
+    EXPECT_EQ(mock_writes[0].length, 6);
+
+    eeprom_update_block(data, (void *)100, sizeof(data));
+    EXPECT_EQ(mock_writes.size(), 1);
+}
+
+TEST_F(EepromTxnTest, StagedWritesAreVisible) {
+    eeprom_txn_begin();
+    eeprom_update_byte((uint8_t *)5, 0x11);
+    eeprom_update_word((uint16_t *)30, 0x2233);
+    eeprom_write_dword((uint32_t *)64, 0x44556677);
+    EXPECT_EQ(eeprom_read_byte((uint8_t *)5), 0x11);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)30), 0x2233);
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)64), 0x44556677);
+    // Straddles the first two pages
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)29), 0x00223300);
+    EXPECT_EQ(mock_writes.size(), 0);
+    EXPECT_EQ(mock_eeprom[5], 0);
+
+    eeprom_txn_commit();
+    EXPECT_EQ(mock_eeprom[5], 0x11);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)30), 0x2233);
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)64), 0x44556677);
+}
+
+TEST_F(EepromTxnTest, CoalescesByteWritesIntoPages) {
+    eeprom_txn_begin();
+    for (uint16_t i = 0; i < 4 * EEPROM_TXN_PAGE_SIZE; ++i) {
+        eeprom_update_byte((uint8_t *)(uintptr_t)i, (uint8_t)(i % 255 + 1));
+    }
+    eeprom_txn_commit();
+
+    // One read and one write per page
+    EXPECT_EQ(mock_read_count, 4);
+    ASSERT_EQ(mock_writes.size(), 4);
+    for (size_t i = 0; i < mock_writes.size(); ++i) {
+        EXPECT_EQ(mock_writes[i].address, i * EEPROM_TXN_PAGE_SIZE);
+        EXPECT_EQ(mock_writes[i].length, EEPROM_TXN_PAGE_SIZE);
+    }
+    for (uint16_t i = 0; i < 4 * EEPROM_TXN_PAGE_SIZE; ++i) {
+        EXPECT_EQ(mock_eeprom[i], (uint8_t)(i % 255 + 1));
+    }
+}
+
+TEST_F(EepromTxnTest, SkipsUnchangedBytes) {
+    mock_eeprom[40] = 0x99;
+    eeprom_txn_begin();
+    eeprom_update_byte((uint8_t *)40, 0x99);
+    eeprom_write_byte((uint8_t *)41, 0x00);
+    eeprom_txn_commit();
+    EXPECT_EQ(mock_writes.size(), 0);
+}
+
+TEST_F(EepromTxnTest, NestedTransactionsCommitOnce) {
+    eeprom_txn_begin();
+    eeprom_txn_begin();
+    eeprom_update_byte((uint8_t *)7, 0x42);
+    eeprom_txn_commit();
+    EXPECT_EQ(mock_writes.size(), 0);
+    eeprom_txn_commit();
+    EXPECT_EQ(mock_writes.size(), 1);
+    EXPECT_EQ(mock_eeprom[7], 0x42);
+
+    // Unbalanced commits are ignored
+    eeprom_txn_commit();
+    eeprom_update_byte((uint8_t *)8, 0x43);
+    EXPECT_EQ(mock_eeprom[8], 0x43);
+}
+
+TEST_F(EepromTxnTest, WritesBackWhenJournalIsFull) {
+    eeprom_txn_begin();
+    for (uint16_t page = 0; page < EEPROM_TXN_PAGE_COUNT; ++page) {
+        eeprom_update_byte((uint8_t *)(uintptr_t)(page * EEPROM_TXN_PAGE_SIZE), 0x42);
+    }
+    EXPECT_EQ(mock_writes.size(), 0);
+
+    eeprom_update_byte((uint8_t *)(uintptr_t)(EEPROM_TXN_PAGE_COUNT * EEPROM_TXN_PAGE_SIZE), 0x42);
+    EXPECT_EQ(mock_writes.size(), EEPROM_TXN_PAGE_COUNT);
+    eeprom_txn_commit();
+    EXPECT_EQ(mock_writes.size(), EEPROM_TXN_PAGE_COUNT + 1);
+
+    for (uint16_t page = 0; page <= EEPROM_TXN_PAGE_COUNT; ++page) {
+        EXPECT_EQ(mock_eeprom[page * EEPROM_TXN_PAGE_SIZE], 0x42);
+    }
+}
+
+TEST_F(EepromTxnTest, WritesSparseChanges) {
+    eeprom_txn_begin();
+    eeprom_update_byte((uint8_t *)2, 0x42);
+    eeprom_update_byte((uint8_t *)10, 0x43);
+    eeprom_txn_commit();
+
+#if defined(EEPROM_TXN_PAGE_BURST)
+    // A single burst covering both changes
+    ASSERT_EQ(mock_writes.size(), 1);
+    EXPECT_EQ(mock_writes[0].address, 2);
+    EXPECT_EQ(mock_writes[0].length, 9);
+#else
+    // Each run of changed bytes on its own
+    ASSERT_EQ(mock_writes.size(), 2);
+    EXPECT_EQ(mock_writes[0].address, 2);
+    EXPECT_EQ(mock_writes[0].length, 1);
+    EXPECT_EQ(mock_writes[1].address, 10);
+    EXPECT_EQ(mock_writes[1].length, 1);
+#endif
+    EXPECT_EQ(mock_eeprom[2], 0x42);
+    EXPECT_EQ(mock_eeprom[10], 0x43);
+}
+
+#if defined(EEPROM_I2C_24LC256)
+TEST_F(EepromTxnTest, UsesPartPresetPageSize) {
+    // Only the part is configured, so the page size comes from the I2C driver's preset
+    EXPECT_EQ(EEPROM_TXN_PAGE_SIZE, 64);
+
+    eeprom_txn_begin();
+    eeprom_update_byte((uint8_t *)64, 0x42);
+    eeprom_update_byte((uint8_t *)127, 0x43);
+    eeprom_txn_commit();
+
+    ASSERT_EQ(mock_writes.size(), 1);
+    EXPECT_EQ(mock_writes[0].address, 64);
+    EXPECT_EQ(mock_writes[0].length, 64);
+}
+#endif
@@ -1,4 +1,4 @@
-eeprom_legacy_emulated_flash_DEFS  := -DEEPROM_TEST_HARNESS -DLEGACY_FLASH_OPS_MOCKED -DNO_PRINT -DFEE_FLASH_BASE=FlashBuf
+eeprom_legacy_emulated_flash_DEFS  := -DEEPROM_TEST_HARNESS -DEEPROM_DRIVER -DLEGACY_FLASH_OPS_MOCKED -DNO_PRINT -DFEE_FLASH_BASE=FlashBuf
 eeprom_legacy_emulated_flash_tiny_DEFS := $(eeprom_legacy_emulated_flash_DEFS) \
 	-DFEE_MCU_FLASH_SIZE=1 \
 	-DMOCK_FLASH_SIZE=1024 \
@@ -23,3 +23,15 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+eeprom_txn_DEFS := -DEEPROM_TEST_HARNESS -DEEPROM_DRIVER -DEEPROM_TXN_PAGE_SIZE=32 -DEEPROM_TXN_PAGE_COUNT=4
+eeprom_txn_page_burst_DEFS := $(eeprom_txn_DEFS) \
+	-DEXTERNAL_EEPROM_PAGE_SIZE=32
+eeprom_txn_i2c_preset_DEFS := -DEEPROM_TEST_HARNESS -DEEPROM_DRIVER -DEEPROM_I2C -DEEPROM_I2C_24LC256
+
+eeprom_txn_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_txn_tests.cpp
+eeprom_txn_page_burst_SRC := $(eeprom_txn_SRC)
+eeprom_txn_i2c_preset_SRC := $(eeprom_txn_SRC)
+eeprom_txn_i2c_preset_INC := $(DRIVER_PATH)/eeprom
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode_config.h"
 #include "debug.h"
 #include "quantum.h"
+#include "tracing.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -71,6 +72,7 @@ __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *reco
  * FIXME: Needs documentation.
  */
 void action_exec(keyevent_t event) {
+    TRACE_BEGIN(TRACE_ACTION_EXEC);
     if (IS_EVENT(event)) {
         ac_dprintf("\n---- action_exec: start -----\n");
         ac_dprintf("EVENT: ");
@@ -132,6 +134,7 @@ void action_exec(keyevent_t event) {
         dprintln();
     }
 #endif
+    TRACE_END(TRACE_ACTION_EXEC);
 }
 
 #ifdef SWAP_HANDS_ENABLE
@@ -271,17 +274,23 @@ void process_record(keyrecord_t *record) {
         return;
     }
 
+    TRACE_BEGIN(TRACE_PROCESS_RECORD);
+    TRACE_LATENCY_BEGIN(record->event.key.row, record->event.key.col, record->event.pressed, IS_COMBOEVENT(record->event));
     if (!process_record_quantum(record)) {
 #ifndef NO_ACTION_ONESHOT
         if (is_oneshot_layer_active() && record->event.pressed && keymap_config.oneshot_enable) {
             clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
         }
 #endif
+        TRACE_LATENCY_END();
+        TRACE_END(TRACE_PROCESS_RECORD);
         return;
     }
 
     process_record_handler(record);
     post_process_record_quantum(record);
+    TRACE_LATENCY_END();
+    TRACE_END(TRACE_PROCESS_RECORD);
 }
 
 void process_record_handler(keyrecord_t *record) {
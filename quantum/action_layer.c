@@ -1,5 +1,6 @@
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "keyboard.h"
 #include "action.h"
@@ -316,16 +317,15 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Resolve layer
  *
- * Gets the layer based on key info
+ * Walks the supplied layers from the top down to find the first non-transparent entry for the key
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static uint8_t layer_switch_resolve_layer(keypos_t key, layer_state_t layers) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -337,6 +337,57 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+/** \brief resolved layer lookup cache
+ *
+ * Holds the resolved layer for each matrix position, valid for a single combined layer state.
+ * Entries are filled on demand, and the whole table is discarded when the layer state or keymap changes.
+ */
+#    define LAYER_LOOKUP_CACHE_EMPTY 0xFF
+
+static uint8_t       layer_lookup_cache[MATRIX_ROWS * MATRIX_COLS];
+static layer_state_t layer_lookup_cache_state = 0;
+static bool          layer_lookup_cache_valid = false;
+
+/** \brief Invalidate layer lookup cache
+ *
+ * Must be called whenever the contents of the keymap change
+ */
+void layer_lookup_cache_invalidate(void) {
+    layer_lookup_cache_valid = false;
+}
+
+static uint8_t layer_lookup_cache_get(keypos_t key, layer_state_t layers) {
+    if (!layer_lookup_cache_valid || layer_lookup_cache_state != layers) {
+        memset(layer_lookup_cache, LAYER_LOOKUP_CACHE_EMPTY, sizeof(layer_lookup_cache));
+        layer_lookup_cache_state = layers;
+        layer_lookup_cache_valid = true;
+    }
+
+    uint8_t *entry = &layer_lookup_cache[(uint16_t)(key.row * MATRIX_COLS) + key.col];
+    if (*entry == LAYER_LOOKUP_CACHE_EMPTY) {
+        *entry = layer_switch_resolve_layer(key, layers);
+    }
+    return *entry;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return layer_lookup_cache_get(key, layers);
+    }
+#    endif
+    return layer_switch_resolve_layer(key, layers);
 #else
     return get_highest_layer(default_layer_state);
 #endif
@@ -19,41 +19,19 @@
 #include "progmem.h"
 #include "util.h"
 
-RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+static inline RGB hsv_to_rgb_pixel(uint16_t h, uint16_t s, uint16_t v) {
+    RGB     rgb;
+    uint8_t region, remainder, p, q, t;
 
-    if (hsv.s == 0) {
-#ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
-#endif
+    if (s == 0) {
+        rgb.r = v;
+        rgb.g = v;
+        rgb.b = v;
         return rgb;
     }
 
-    h = hsv.h;
-    s = hsv.s;
-#ifdef USE_CIE1931_CURVE
-    if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
-    }
-#else
-    v = hsv.v;
-#endif
-
-    region    = h * 6 / 255;
+    // Equivalent to h * 6 / 255 for every 8 bit hue, without the division.
+    region    = (h * 193) >> 13;
     remainder = (h * 2 - region * 85) * 3;
 
     p = (v * (255 - s)) >> 8;
@@ -97,6 +75,46 @@ RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
     return rgb;
 }
 
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        return hsv_to_rgb_pixel(hsv.h, hsv.s, pgm_read_byte(&CIE1931_CURVE[hsv.v]));
+    }
+#endif
+    return hsv_to_rgb_pixel(hsv.h, hsv.s, hsv.v);
+}
+
+void hsv_to_rgb_batch_impl(const HSV *hsv, RGB *rgb, uint16_t count, bool use_cie) {
+    if (count == 0) {
+        return;
+    }
+
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        // Effects commonly vary only the hue across a frame, so avoid re-reading the curve for runs of the same value.
+        uint8_t last_v = hsv[0].v;
+        uint8_t cie_v  = pgm_read_byte(&CIE1931_CURVE[last_v]);
+        for (uint16_t i = 0; i < count; i++) {
+            if (hsv[i].v != last_v) {
+                last_v = hsv[i].v;
+                cie_v  = pgm_read_byte(&CIE1931_CURVE[last_v]);
+            }
+            RGB out  = hsv_to_rgb_pixel(hsv[i].h, hsv[i].s, cie_v);
+            rgb[i].r = out.r;
+            rgb[i].g = out.g;
+            rgb[i].b = out.b;
+        }
+        return;
+    }
+#endif
+    for (uint16_t i = 0; i < count; i++) {
+        RGB out  = hsv_to_rgb_pixel(hsv[i].h, hsv[i].s, hsv[i].v);
+        rgb[i].r = out.r;
+        rgb[i].g = out.g;
+        rgb[i].b = out.b;
+    }
+}
+
 RGB hsv_to_rgb(HSV hsv) {
 #ifdef USE_CIE1931_CURVE
     return hsv_to_rgb_impl(hsv, true);
@@ -109,6 +127,14 @@ RGB hsv_to_rgb_nocie(HSV hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
 
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint16_t count) {
+#ifdef USE_CIE1931_CURVE
+    hsv_to_rgb_batch_impl(hsv, rgb, count, true);
+#else
+    hsv_to_rgb_batch_impl(hsv, rgb, count, false);
+#endif
+}
+
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led) {
     // Determine lowest value in all three colors, put that into
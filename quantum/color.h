@@ -111,6 +111,15 @@ typedef struct PACKED HSV {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+
+/**
+ * \brief Convert an array of HSV colors to RGB in one pass.
+ *
+ * Produces exactly the same output as calling hsv_to_rgb() on each element,
+ * but hoists the per-call checks out of the loop. `hsv` and `rgb` must not overlap.
+ */
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint16_t count);
+void hsv_to_rgb_batch_impl(const HSV *hsv, RGB *rgb, uint16_t count, bool use_cie);
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led);
 #endif
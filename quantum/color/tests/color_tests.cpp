@@ -0,0 +1,149 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie);
+}
+
+// The conversion as it was written before the division was removed, kept as a reference.
+static RGB reference_hsv_to_rgb(HSV hsv, bool use_cie) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h = hsv.h, s = hsv.s, v = use_cie ? CIE1931_CURVE[hsv.v] : hsv.v;
+
+    if (s == 0) {
+        rgb.r = rgb.g = rgb.b = v;
+        return rgb;
+    }
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v, rgb.g = t, rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q, rgb.g = v, rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p, rgb.g = v, rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p, rgb.g = q, rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t, rgb.g = p, rgb.b = v;
+            break;
+        default:
+            rgb.r = v, rgb.g = p, rgb.b = q;
+            break;
+    }
+    return rgb;
+}
+
+static bool same_rgb(const RGB &a, const RGB &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+class Color : public ::testing::Test {};
+
+TEST_F(Color, MatchesReferenceForEveryColor) {
+    for (bool use_cie : {false, true}) {
+        for (uint32_t i = 0; i < (1 << 24); i++) {
+            HSV hsv = {.h = (uint8_t)i, .s = (uint8_t)(i >> 8), .v = (uint8_t)(i >> 16)};
+            RGB rgb = hsv_to_rgb_impl(hsv, use_cie);
+            RGB ref = reference_hsv_to_rgb(hsv, use_cie);
+            ASSERT_TRUE(same_rgb(rgb, ref)) << "h=" << +hsv.h << " s=" << +hsv.s << " v=" << +hsv.v << " cie=" << use_cie;
+        }
+    }
+}
+
+TEST_F(Color, BatchMatchesSingle) {
+    std::vector<HSV> hsv(256);
+    std::vector<RGB> rgb(hsv.size());
+
+    for (bool use_cie : {false, true}) {
+        for (uint32_t sv = 0; sv < (1 << 16); sv++) {
+            for (uint16_t h = 0; h < hsv.size(); h++) {
+                hsv[h] = {.h = (uint8_t)h, .s = (uint8_t)sv, .v = (uint8_t)(sv >> 8)};
+            }
+            // Vary the value within the batch too, to exercise the curve lookup cache.
+            hsv[sv % hsv.size()].v = ~hsv[0].v;
+
+            hsv_to_rgb_batch_impl(hsv.data(), rgb.data(), hsv.size(), use_cie);
+            for (uint16_t h = 0; h < hsv.size(); h++) {
+                ASSERT_TRUE(same_rgb(rgb[h], hsv_to_rgb_impl(hsv[h], use_cie))) << "h=" << +hsv[h].h << " s=" << +hsv[h].s << " v=" << +hsv[h].v << " cie=" << use_cie;
+            }
+        }
+    }
+}
+
+TEST_F(Color, BatchWithNoColors) {
+    RGB rgb;
+    rgb.r = 1;
+    rgb.g = 2;
+    rgb.b = 3;
+    hsv_to_rgb_batch(nullptr, &rgb, 0);
+    EXPECT_EQ(rgb.r, 1);
+    EXPECT_EQ(rgb.g, 2);
+    EXPECT_EQ(rgb.b, 3);
+}
+
+/*
+ * Converts a 120 LED rainbow frame, as produced by the effect runners, through
+ * the per-LED and batch paths and reports the time taken per frame.
+ */
+TEST_F(Color, Benchmark120Leds) {
+    const uint16_t   led_count = 120;
+    const uint32_t   frames    = 20000;
+    std::vector<HSV> hsv(led_count);
+    std::vector<RGB> single(led_count);
+    std::vector<RGB> batch(led_count);
+    uint32_t         checksum_single = 0;
+    uint32_t         checksum_batch  = 0;
+
+    auto fill = [&](uint32_t frame) {
+        for (uint16_t i = 0; i < led_count; i++) {
+            hsv[i] = {.h = (uint8_t)(i * 2 + frame), .s = 255, .v = 200};
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        fill(frame);
+        for (uint16_t i = 0; i < led_count; i++) {
+            single[i] = hsv_to_rgb(hsv[i]);
+        }
+        checksum_single += single[frame % led_count].r;
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        fill(frame);
+        hsv_to_rgb_batch(hsv.data(), batch.data(), led_count);
+        checksum_batch += batch[frame % led_count].r;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(checksum_single, checksum_batch);
+
+    double single_ns = std::chrono::duration<double, std::nano>(middle - start).count() / frames;
+    double batch_ns  = std::chrono::duration<double, std::nano>(end - middle).count() / frames;
+    printf("hsv_to_rgb benchmark: %u LEDs: %.0f ns per frame per-LED, %.0f ns per frame batched\n", led_count, single_ns, batch_ns);
+    RecordProperty("single_ns_per_frame", (int)(single_ns + 0.5));
+    RecordProperty("batch_ns_per_frame", (int)(batch_ns + 0.5));
+}
@@ -0,0 +1,192 @@
+/*
+Copyright 2024 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key algorithm using vertical counters.
+Behaves the same as sym_defer_pk: when no state changes have occured on a key for
+DEBOUNCE milliseconds, we push the state of that key.
+
+Rather than keeping one counter per key, each row keeps a handful of "bit planes".
+Plane n holds bit n of the elapsed time counter of every key in the row, so a
+whole row of counters can be started, advanced and compared against DEBOUNCE
+with a few word operations. All state is statically allocated.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#if DEBOUNCE > 0
+
+// Number of bit planes required to hold a counter value of DEBOUNCE.
+#    if DEBOUNCE < 2
+#        define DEBOUNCE_PLANES 1
+#    elif DEBOUNCE < 4
+#        define DEBOUNCE_PLANES 2
+#    elif DEBOUNCE < 8
+#        define DEBOUNCE_PLANES 3
+#    elif DEBOUNCE < 16
+#        define DEBOUNCE_PLANES 4
+#    elif DEBOUNCE < 32
+#        define DEBOUNCE_PLANES 5
+#    elif DEBOUNCE < 64
+#        define DEBOUNCE_PLANES 6
+#    elif DEBOUNCE < 128
+#        define DEBOUNCE_PLANES 7
+#    else
+#        define DEBOUNCE_PLANES 8
+#    endif
+
+typedef struct {
+    matrix_row_t active;
+    matrix_row_t planes[DEBOUNCE_PLANES];
+} debounce_row_t;
+
+static debounce_row_t debounce_rows[MATRIX_ROWS];
+static fast_timer_t   last_time;
+static bool           counters_need_update;
+static bool           cooked_changed;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        debounce_rows[row] = (debounce_row_t){0};
+    }
+    counters_need_update = false;
+}
+
+void debounce_free(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+/**
+ * \brief Add elapsed_time to every active counter in the row, and return the mask of counters that have reached DEBOUNCE.
+ */
+static matrix_row_t add_and_compare(debounce_row_t *row, uint8_t elapsed_time) {
+    if (elapsed_time >= DEBOUNCE) {
+        return row->active;
+    }
+
+    // Ripple-carry add of a constant to every counter in the row at once. Only
+    // active counters are non-zero, so the carry is seeded from the active mask.
+    matrix_row_t carry = 0;
+    for (uint8_t n = 0; n < DEBOUNCE_PLANES; n++) {
+        matrix_row_t addend = (elapsed_time & (1 << n)) ? row->active : 0;
+        matrix_row_t plane  = row->planes[n];
+        row->planes[n]      = plane ^ addend ^ carry;
+        carry               = (plane & addend) | (carry & (plane ^ addend));
+    }
+
+    // A carry out of the top plane means the counter exceeds DEBOUNCE.
+    matrix_row_t expired = carry;
+    matrix_row_t equal   = row->active & ~carry;
+    for (int8_t n = DEBOUNCE_PLANES - 1; n >= 0; n--) {
+        if (DEBOUNCE & (1 << n)) {
+            equal &= row->planes[n];
+        } else {
+            expired |= equal & row->planes[n];
+            equal &= ~row->planes[n];
+        }
+    }
+    return expired | equal;
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        debounce_row_t *state = &debounce_rows[row];
+        if (!state->active) {
+            continue;
+        }
+
+        matrix_row_t expired = add_and_compare(state, elapsed_time);
+        if (expired) {
+            matrix_row_t cooked_next = (cooked[row] & ~expired) | (raw[row] & expired);
+            cooked_changed |= cooked[row] ^ cooked_next;
+            cooked[row] = cooked_next;
+
+            state->active &= ~expired;
+            for (uint8_t n = 0; n < DEBOUNCE_PLANES; n++) {
+                state->planes[n] &= ~expired;
+            }
+        }
+
+        if (state->active) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        debounce_row_t *state = &debounce_rows[row];
+        matrix_row_t    delta = raw[row] ^ cooked[row];
+
+        // Keys that were already debouncing keep their counter, keys that have
+        // returned to their cooked state are stopped, and new keys start at zero.
+        matrix_row_t keep = state->active & delta;
+        for (uint8_t n = 0; n < DEBOUNCE_PLANES; n++) {
+            state->planes[n] &= keep;
+        }
+        state->active = delta;
+
+        if (delta) {
+            counters_need_update = true;
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
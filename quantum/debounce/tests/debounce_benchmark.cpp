@@ -0,0 +1,147 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "debounce.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define DEBOUNCE_BENCHMARK_STR2(x) #x
+#define DEBOUNCE_BENCHMARK_STR(x) DEBOUNCE_BENCHMARK_STR2(x)
+
+/*
+ * Runs the same pseudo-random typing workload through whichever debounce algorithm
+ * the test binary was linked against, and reports the average time per debounce()
+ * call. Compare the output of the debounce_* test targets to compare algorithms.
+ */
+class DebounceBenchmark : public ::testing::Test {
+   protected:
+    typedef std::array<matrix_row_t, MATRIX_ROWS> Scan;
+
+    static const uint32_t scans_per_ms = 8;
+    static const uint32_t duration_ms  = 20000;
+
+    uint32_t random() {
+        seed_ = seed_ * 1664525 + 1013904223;
+        return seed_ >> 8;
+    }
+
+    matrix_row_t randomRow() {
+        return (matrix_row_t)(random() ^ (random() << 16)) & (matrix_row_t)((1ULL << MATRIX_COLS) - 1);
+    }
+
+    void run(const char *workload, const std::vector<Scan> &scans, const Scan &stable);
+
+    uint32_t seed_ = 0x5eed;
+};
+
+void DebounceBenchmark::run(const char *workload, const std::vector<Scan> &scans, const Scan &stable) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+    uint32_t     calls               = 0;
+
+    set_time(1000);
+    debounce_init(MATRIX_ROWS);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto &next : scans) {
+        bool changed = !std::equal(next.begin(), next.end(), std::begin(raw));
+        std::copy(next.begin(), next.end(), std::begin(raw));
+        debounce(raw, cooked, MATRIX_ROWS, changed);
+        if (++calls % scans_per_ms == 0) {
+            advance_time(1);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Let everything settle, the cooked matrix must then match the stable inputs.
+    std::copy(stable.begin(), stable.end(), std::begin(raw));
+    debounce(raw, cooked, MATRIX_ROWS, true);
+    for (uint32_t ms = 0; ms <= 2 * DEBOUNCE + 1; ms++) {
+        advance_time(1);
+        debounce(raw, cooked, MATRIX_ROWS, false);
+    }
+    EXPECT_TRUE(std::equal(stable.begin(), stable.end(), std::begin(cooked)));
+
+    debounce_free();
+
+    double ns_per_call = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    printf("debounce benchmark: %s %s %ux%u DEBOUNCE=%u: %.1f ns per debounce() call over %u calls\n", DEBOUNCE_BENCHMARK_STR(DEBOUNCE_ALGORITHM), workload, MATRIX_ROWS, MATRIX_COLS, DEBOUNCE, ns_per_call, calls);
+    RecordProperty("ns_per_call", (int)(ns_per_call + 0.5));
+}
+
+TEST_F(DebounceBenchmark, TypingWithBounce) {
+    std::vector<Scan> scans;
+    Scan              stable      = {0};
+    uint8_t           bounce_row  = 0;
+    matrix_row_t      bounce_mask = 0;
+    uint8_t           bounce_left = 0;
+
+    // Generate the workload up front so only debounce() itself is timed.
+    // Every 20ms on average, a key changes state and bounces for a couple of milliseconds.
+    scans.reserve(duration_ms * scans_per_ms);
+    for (uint32_t ms = 0; ms < duration_ms; ms++) {
+        if (bounce_left == 0 && random() % 20 == 0) {
+            bounce_row  = random() % MATRIX_ROWS;
+            bounce_mask = (matrix_row_t)1 << (random() % MATRIX_COLS);
+            stable[bounce_row] ^= bounce_mask;
+            bounce_left = 1 + random() % 3;
+        }
+
+        for (uint32_t scan = 0; scan < scans_per_ms; scan++) {
+            Scan next = stable;
+            if (bounce_left && (random() & 1)) {
+                next[bounce_row] ^= bounce_mask;
+            }
+            scans.push_back(next);
+        }
+
+        if (bounce_left) {
+            bounce_left--;
+        }
+    }
+
+    run("typing", scans, stable);
+}
+
+TEST_F(DebounceBenchmark, AllKeysChattering) {
+    std::vector<Scan> scans;
+    Scan              stable = {0};
+
+    // Worst case: noise on every key, so most counters are running most of the time.
+    scans.reserve(duration_ms * scans_per_ms);
+    for (uint32_t ms = 0; ms < duration_ms; ms++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            stable[row] = randomRow();
+        }
+        for (uint32_t scan = 0; scan < scans_per_ms; scan++) {
+            scans.push_back(stable);
+        }
+    }
+
+    run("chattering", scans, stable);
+}
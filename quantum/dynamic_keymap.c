@@ -17,10 +17,12 @@
 #include "dynamic_keymap.h"
 #include "keymap_introspection.h"
 #include "action.h"
+#include "action_layer.h"
 #include "eeprom.h"
 #include "progmem.h"
 #include "send_string.h"
 #include "keycodes.h"
+#include "util.h"
 
 #ifdef VIA_ENABLE
 #    include "via.h"
@@ -36,6 +38,11 @@
 #    define NUM_ENCODERS 0
 #endif
 
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+#    include <string.h>
+#    include "timer.h"
+#endif
+
 #ifndef DYNAMIC_KEYMAP_LAYER_COUNT
 #    define DYNAMIC_KEYMAP_LAYER_COUNT 4
 #endif
@@ -101,6 +108,120 @@ _Static_assert((DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (DYNAMIC_KEYMAP_MACRO_EEPROM_A
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#define DYNAMIC_KEYMAP_KEYMAP_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+#ifdef ENCODER_MAP_ENABLE
+#    define DYNAMIC_KEYMAP_ENCODER_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * NUM_ENCODERS * 2 * 2)
+#else
+#    define DYNAMIC_KEYMAP_ENCODER_SIZE 0
+#endif
+
+// Keymap and encoder map entries are addressed by their offset into a single space, keymap first.
+static void *dynamic_keymap_offset_to_eeprom_address(uint16_t offset) {
+    if (offset < DYNAMIC_KEYMAP_KEYMAP_SIZE) {
+        return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset;
+    }
+    return ((void *)DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR) + (offset - DYNAMIC_KEYMAP_KEYMAP_SIZE);
+}
+
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// Time without further changes before the mirror is written back to EEPROM
+#    ifndef DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY
+#        define DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY 500
+#    endif
+// Number of bytes written back to EEPROM per pass of the main loop
+#    ifndef DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE
+#        define DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE 32
+#    endif
+
+#    define DYNAMIC_KEYMAP_RAM_MIRROR_SIZE (DYNAMIC_KEYMAP_KEYMAP_SIZE + DYNAMIC_KEYMAP_ENCODER_SIZE)
+#    define DYNAMIC_KEYMAP_RAM_MIRROR_BLOCKS ((DYNAMIC_KEYMAP_RAM_MIRROR_SIZE + DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE - 1) / DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE)
+
+static uint8_t  dynamic_keymap_mirror[DYNAMIC_KEYMAP_RAM_MIRROR_SIZE];
+static uint8_t  dynamic_keymap_mirror_dirty[(DYNAMIC_KEYMAP_RAM_MIRROR_BLOCKS + 7) / 8];
+static bool     dynamic_keymap_mirror_pending = false;
+static uint32_t dynamic_keymap_mirror_last_change;
+
+static inline uint8_t dynamic_keymap_read_byte(uint16_t offset) {
+    return dynamic_keymap_mirror[offset];
+}
+
+static inline void dynamic_keymap_update_byte(uint16_t offset, uint8_t value) {
+    if (dynamic_keymap_mirror[offset] != value) {
+        dynamic_keymap_mirror[offset] = value;
+
+        uint16_t block = offset / DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE;
+        dynamic_keymap_mirror_dirty[block / 8] |= 1 << (block % 8);
+        dynamic_keymap_mirror_pending     = true;
+        dynamic_keymap_mirror_last_change = timer_read32();
+    }
+}
+
+static void dynamic_keymap_mirror_write(uint16_t start, uint16_t end) {
+    // The keymap and encoder map aren't necessarily adjacent in EEPROM
+    if (start < DYNAMIC_KEYMAP_KEYMAP_SIZE && end > DYNAMIC_KEYMAP_KEYMAP_SIZE) {
+        dynamic_keymap_mirror_write(start, DYNAMIC_KEYMAP_KEYMAP_SIZE);
+        start = DYNAMIC_KEYMAP_KEYMAP_SIZE;
+    }
+    eeprom_update_block(&dynamic_keymap_mirror[start], dynamic_keymap_offset_to_eeprom_address(start), end - start);
+}
+
+// Writes back the first dirty block, returning whether there are any more
+static bool dynamic_keymap_mirror_write_next(void) {
+    bool written = false;
+    for (uint16_t block = 0; block < DYNAMIC_KEYMAP_RAM_MIRROR_BLOCKS; ++block) {
+        if (dynamic_keymap_mirror_dirty[block / 8] & (1 << (block % 8))) {
+            if (written) {
+                return true;
+            }
+            uint16_t start = block * DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE;
+            uint16_t end   = MIN(start + DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_SIZE, DYNAMIC_KEYMAP_RAM_MIRROR_SIZE);
+            dynamic_keymap_mirror_write(start, end);
+            dynamic_keymap_mirror_dirty[block / 8] &= ~(1 << (block % 8));
+            written = true;
+        }
+    }
+    return false;
+}
+
+void dynamic_keymap_init(void) {
+    eeprom_read_block(dynamic_keymap_mirror, (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_KEYMAP_SIZE);
+#    ifdef ENCODER_MAP_ENABLE
+    eeprom_read_block(&dynamic_keymap_mirror[DYNAMIC_KEYMAP_KEYMAP_SIZE], (void *)DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR, DYNAMIC_KEYMAP_ENCODER_SIZE);
+#    endif // ENCODER_MAP_ENABLE
+    memset(dynamic_keymap_mirror_dirty, 0, sizeof(dynamic_keymap_mirror_dirty));
+    dynamic_keymap_mirror_pending = false;
+    layer_lookup_cache_invalidate();
+}
+
+void dynamic_keymap_task(void) {
+    // Changes from the host tend to arrive in bursts, so wait for them to settle, then write back a block at a time to
+    // keep each pass of the main loop short.
+    if (dynamic_keymap_mirror_pending && timer_elapsed32(dynamic_keymap_mirror_last_change) >= DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY) {
+        dynamic_keymap_mirror_pending = dynamic_keymap_mirror_write_next();
+    }
+}
+
+void dynamic_keymap_flush(void) {
+    while (dynamic_keymap_mirror_pending) {
+        dynamic_keymap_mirror_pending = dynamic_keymap_mirror_write_next();
+    }
+}
+#else // DYNAMIC_KEYMAP_RAM_MIRROR
+static inline uint8_t dynamic_keymap_read_byte(uint16_t offset) {
+    return eeprom_read_byte(dynamic_keymap_offset_to_eeprom_address(offset));
+}
+
+static inline void dynamic_keymap_update_byte(uint16_t offset, uint8_t value) {
+    eeprom_update_byte(dynamic_keymap_offset_to_eeprom_address(offset), value);
+}
+
+void dynamic_keymap_init(void) {}
+
+void dynamic_keymap_task(void) {}
+
+void dynamic_keymap_flush(void) {}
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -110,21 +231,26 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
     return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
 }
 
+static inline uint16_t dynamic_keymap_key_to_offset(uint8_t layer, uint8_t row, uint8_t column) {
+    return (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
+}
+
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
-    void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+    uint16_t offset = dynamic_keymap_key_to_offset(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = eeprom_read_byte(address) << 8;
-    keycode |= eeprom_read_byte(address + 1);
+    uint16_t keycode = dynamic_keymap_read_byte(offset) << 8;
+    keycode |= dynamic_keymap_read_byte(offset + 1);
     return keycode;
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
-    void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+    uint16_t offset = dynamic_keymap_key_to_offset(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    dynamic_keymap_update_byte(offset, (uint8_t)(keycode >> 8));
+    dynamic_keymap_update_byte(offset + 1, (uint8_t)(keycode & 0xFF));
+    layer_lookup_cache_invalidate();
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -132,25 +258,30 @@ void *dynamic_keymap_encoder_to_eeprom_address(uint8_t layer, uint8_t encoder_id
     return ((void *)DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR) + (layer * NUM_ENCODERS * 2 * 2) + (encoder_id * 2 * 2);
 }
 
+static inline uint16_t dynamic_keymap_encoder_to_offset(uint8_t layer, uint8_t encoder_id, bool clockwise) {
+    return DYNAMIC_KEYMAP_KEYMAP_SIZE + (layer * NUM_ENCODERS * 2 * 2) + (encoder_id * 2 * 2) + (clockwise ? 0 : 2);
+}
+
 uint16_t dynamic_keymap_get_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
-    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
+    uint16_t offset = dynamic_keymap_encoder_to_offset(layer, encoder_id, clockwise);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = ((uint16_t)eeprom_read_byte(address + (clockwise ? 0 : 2))) << 8;
-    keycode |= eeprom_read_byte(address + (clockwise ? 0 : 2) + 1);
+    uint16_t keycode = ((uint16_t)dynamic_keymap_read_byte(offset)) << 8;
+    keycode |= dynamic_keymap_read_byte(offset + 1);
     return keycode;
 }
 
 void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return;
-    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
+    uint16_t offset = dynamic_keymap_encoder_to_offset(layer, encoder_id, clockwise);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
+    dynamic_keymap_update_byte(offset, (uint8_t)(keycode >> 8));
+    dynamic_keymap_update_byte(offset + 1, (uint8_t)(keycode & 0xFF));
 }
 #endif // ENCODER_MAP_ENABLE
 
 void dynamic_keymap_reset(void) {
+    eeprom_txn_begin();
     // Reset the keymaps in EEPROM to what is in flash.
     for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
         for (int row = 0; row < MATRIX_ROWS; row++) {
@@ -165,34 +296,39 @@ void dynamic_keymap_reset(void) {
         }
 #endif // ENCODER_MAP_ENABLE
     }
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    // The mirror may not have been loaded yet, so don't rely on it to tell what has changed
+    memset(dynamic_keymap_mirror_dirty, 0xFF, sizeof(dynamic_keymap_mirror_dirty));
+    dynamic_keymap_mirror_pending = true;
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
+    // Callers rely on the reset keymap being persisted, e.g. before marking the VIA EEPROM contents as valid
+    dynamic_keymap_flush();
+    eeprom_txn_commit();
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
+    uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            *target = eeprom_read_byte(source);
+        if (offset + i < DYNAMIC_KEYMAP_KEYMAP_SIZE) {
+            *target = dynamic_keymap_read_byte(offset + i);
         } else {
             *target = 0x00;
         }
-        source++;
         target++;
     }
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
+    uint8_t *source = data;
+    eeprom_txn_begin();
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            eeprom_update_byte(target, *source);
+        if (offset + i < DYNAMIC_KEYMAP_KEYMAP_SIZE) {
+            dynamic_keymap_update_byte(offset + i, *source);
         }
         source++;
-        target++;
     }
+    eeprom_txn_commit();
+    layer_lookup_cache_invalidate();
 }
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
@@ -220,7 +356,7 @@ uint16_t dynamic_keymap_macro_get_buffer_size(void) {
 }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -234,8 +370,9 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   target = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *source = data;
+    eeprom_txn_begin();
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
             eeprom_update_byte(target, *source);
@@ -243,15 +380,18 @@ void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *da
         source++;
         target++;
     }
+    eeprom_txn_commit();
 }
 
 void dynamic_keymap_macro_reset(void) {
     void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
     void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+    eeprom_txn_begin();
     while (p != end) {
         eeprom_update_byte(p, 0);
         ++p;
     }
+    eeprom_txn_commit();
 }
 
 void dynamic_keymap_macro_send(uint8_t id) {
@@ -18,6 +18,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// With DYNAMIC_KEYMAP_RAM_MIRROR, the keymap and encoder map are loaded into RAM by dynamic_keymap_init(), so lookups
+// never touch the EEPROM driver. Changes are made in RAM, and written back in the background by dynamic_keymap_task().
+void dynamic_keymap_init(void);
+void dynamic_keymap_task(void);
+// Writes back all changes still pending, blocking until everything has been written
+void dynamic_keymap_flush(void);
+
 uint8_t  dynamic_keymap_get_layer_count(void);
 void *   dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column);
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column);
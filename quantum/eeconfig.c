@@ -49,6 +49,8 @@ void eeconfig_init_quantum(void) {
     eeprom_driver_format(false);
 #endif
 
+    // The defaults are all small writes close together, so stage them to be written back together
+    eeprom_txn_begin();
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
     eeprom_update_byte(EECONFIG_DEBUG, 0);
     default_layer_state = (layer_state_t)1 << 0;
@@ -74,6 +76,7 @@ void eeconfig_init_quantum(void) {
 #if (EECONFIG_USER_DATA_SIZE) > 0
     eeconfig_init_user_datablock();
 #endif
+    eeprom_txn_commit();
 
 #if defined(VIA_ENABLE)
     // Invalidate VIA eeprom config, and then reset.
@@ -20,8 +20,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "tracing.h"
 #include "atomic_util.h"
 
+#ifdef MATRIX_WAKEUP_ENABLE
+#    include "matrix_wakeup.h"
+#endif
+
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -133,6 +138,15 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+#    ifdef MATRIX_WAKEUP_ENABLE
+#        define MATRIX_WAKEUP_INPUTS (&direct_pins[0][0])
+#        define MATRIX_WAKEUP_INPUT_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+
+static void matrix_wakeup_select_all(void) {}
+
+static void matrix_wakeup_unselect_all(void) {}
+#    endif
+
 #elif defined(DIODE_DIRECTION)
 #    if defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
 #        if (DIODE_DIRECTION == COL2ROW)
@@ -198,6 +212,23 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+#            ifdef MATRIX_WAKEUP_ENABLE
+#                define MATRIX_WAKEUP_INPUTS col_pins
+#                define MATRIX_WAKEUP_INPUT_COUNT MATRIX_COLS
+
+static void matrix_wakeup_select_all(void) {
+    for (uint8_t x = 0; x < ROWS_PER_HAND; x++) {
+        select_row(x);
+    }
+    matrix_output_select_delay();
+}
+
+static void matrix_wakeup_unselect_all(void) {
+    unselect_rows();
+    matrix_io_delay();
+}
+#            endif
+
 #        elif (DIODE_DIRECTION == ROW2COL)
 
 static bool select_col(uint8_t col) {
@@ -262,6 +293,23 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     matrix_output_unselect_delay(current_col, key_pressed); // wait for all Row signals to go HIGH
 }
 
+#            ifdef MATRIX_WAKEUP_ENABLE
+#                define MATRIX_WAKEUP_INPUTS row_pins
+#                define MATRIX_WAKEUP_INPUT_COUNT ROWS_PER_HAND
+
+static void matrix_wakeup_select_all(void) {
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+    matrix_output_select_delay();
+}
+
+static void matrix_wakeup_unselect_all(void) {
+    unselect_cols();
+    matrix_io_delay();
+}
+#            endif
+
 #        else
 #            error DIODE_DIRECTION must be one of COL2ROW or ROW2COL!
 #        endif
@@ -320,7 +368,57 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 }
 #endif
 
-uint8_t matrix_scan(void) {
+#ifdef MATRIX_WAKEUP_ENABLE
+#    ifndef MATRIX_WAKEUP_INPUTS
+#        error MATRIX_WAKEUP_ENABLE requires DIRECT_PINS, or MATRIX_ROW_PINS and MATRIX_COL_PINS
+#    endif
+
+bool matrix_wakeup_read_inputs(void) {
+    const pin_t *pins = MATRIX_WAKEUP_INPUTS;
+    for (uint8_t i = 0; i < MATRIX_WAKEUP_INPUT_COUNT; i++) {
+        if (pins[i] != NO_PIN && readMatrixPin(pins[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Leaves the idle state if any input has changed since it was entered.
+ *
+ * @return true A full scan is required
+ * @return false Nothing has changed, scanning and debouncing can be skipped
+ */
+static bool matrix_wakeup_should_scan(void) {
+    if (!matrix_wakeup_is_idle()) {
+        return true;
+    }
+    if (!matrix_wakeup_pending()) {
+        return false;
+    }
+    matrix_wakeup_idle_exit(MATRIX_WAKEUP_INPUTS, MATRIX_WAKEUP_INPUT_COUNT);
+    matrix_wakeup_unselect_all();
+    return true;
+}
+
+/**
+ * @brief Goes idle once every key on this half has been released and debounced, as there is then nothing left
+ * for debounce to report until an input changes.
+ */
+static void matrix_wakeup_update(matrix_row_t debounced_matrix[]) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (raw_matrix[row] || debounced_matrix[row]) {
+            return;
+        }
+    }
+    matrix_wakeup_select_all();
+    if (!matrix_wakeup_idle_enter(MATRIX_WAKEUP_INPUTS, MATRIX_WAKEUP_INPUT_COUNT)) {
+        matrix_wakeup_unselect_all();
+    }
+}
+#endif
+
+static bool matrix_read_raw(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
@@ -338,11 +436,35 @@ uint8_t matrix_scan(void) {
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
+    return changed;
+}
+
+uint8_t matrix_scan(void) {
+#ifdef SPLIT_KEYBOARD
+    matrix_row_t *debounced_matrix = matrix + thisHand;
+#else
+    matrix_row_t *debounced_matrix = matrix;
+#endif
+    bool changed = false;
+
+#ifdef MATRIX_WAKEUP_ENABLE
+    if (matrix_wakeup_should_scan())
+#endif
+    {
+        changed = matrix_read_raw();
+
+        TRACE_BEGIN(TRACE_DEBOUNCE);
+        changed = debounce(raw_matrix, debounced_matrix, ROWS_PER_HAND, changed);
+        TRACE_END(TRACE_DEBOUNCE);
+
+#ifdef MATRIX_WAKEUP_ENABLE
+        matrix_wakeup_update(debounced_matrix);
+#endif
+    }
 
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    changed |= matrix_post_scan();
 #else
-    changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
     matrix_scan_kb();
 #endif
     return (uint8_t)changed;
@@ -1,5 +1,6 @@
 #include "matrix.h"
 #include "debounce.h"
+#include "tracing.h"
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
@@ -168,10 +169,14 @@ __attribute__((weak)) void matrix_init(void) {
 __attribute__((weak)) uint8_t matrix_scan(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
+    TRACE_BEGIN(TRACE_DEBOUNCE);
 #ifdef SPLIT_KEYBOARD
-    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
+    changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+    TRACE_END(TRACE_DEBOUNCE);
+    changed |= matrix_post_scan();
 #else
     changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    TRACE_END(TRACE_DEBOUNCE);
     matrix_scan_kb();
 #endif
 
@@ -0,0 +1,67 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_wakeup.h"
+
+static volatile bool wakeup_signalled = false;
+static bool          wakeup_idle      = false;
+static bool          wakeup_armed     = false;
+
+__attribute__((weak)) bool matrix_wakeup_arm_pins(const pin_t *pins, uint8_t count) {
+    return false;
+}
+
+__attribute__((weak)) void matrix_wakeup_disarm_pins(const pin_t *pins, uint8_t count) {}
+
+__attribute__((weak)) bool matrix_wakeup_read_inputs(void) {
+    // Without a way of reading the inputs, always request a full scan.
+    return true;
+}
+
+void matrix_wakeup_signal(void) {
+    wakeup_signalled = true;
+}
+
+bool matrix_wakeup_is_idle(void) {
+    return wakeup_idle;
+}
+
+bool matrix_wakeup_idle_enter(const pin_t *pins, uint8_t count) {
+    wakeup_signalled = false;
+    wakeup_armed     = matrix_wakeup_arm_pins(pins, count);
+
+    // A key pressed after the last scan but before the interrupts were armed never produces an edge, so check again.
+    if (wakeup_armed && matrix_wakeup_read_inputs()) {
+        matrix_wakeup_disarm_pins(pins, count);
+        wakeup_armed = false;
+        return false;
+    }
+
+    wakeup_idle = true;
+    return true;
+}
+
+void matrix_wakeup_idle_exit(const pin_t *pins, uint8_t count) {
+    if (wakeup_armed) {
+        matrix_wakeup_disarm_pins(pins, count);
+        wakeup_armed = false;
+    }
+    wakeup_idle = false;
+}
+
+bool matrix_wakeup_pending(void) {
+    if (!wakeup_idle) {
+        return true;
+    }
+
+    if (!wakeup_armed) {
+        return matrix_wakeup_read_inputs();
+    }
+
+    // Only cleared once seen, so a signal raised during the check is never lost; it just triggers a full scan.
+    if (wakeup_signalled) {
+        wakeup_signalled = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,73 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+/**
+ * \file
+ *
+ * \defgroup matrix_wakeup Event-driven matrix scanning
+ *
+ * Once every key has been released and debounced, the matrix drives all of
+ * its outputs active at the same time and waits for any input to change,
+ * instead of scanning every row on every pass of the main loop. A full scan
+ * only happens once a change has been detected.
+ *
+ * Platforms that can raise an interrupt on an input pin change implement
+ * matrix_wakeup_arm_pins() and call matrix_wakeup_signal() from the ISR.
+ * Otherwise the input pins are polled through matrix_wakeup_read_inputs(),
+ * which only costs one read per input pin.
+ * \{
+ */
+
+/**
+ * \brief Enable change interrupts on the supplied input pins. Entries set to `NO_PIN` are skipped.
+ *
+ * Nothing is armed if any pin shares its interrupt line with another pin, or a line is already in use elsewhere.
+ *
+ * \return true if the platform will call matrix_wakeup_signal() on change, false if the pins need to be polled.
+ */
+bool matrix_wakeup_arm_pins(const pin_t *pins, uint8_t count);
+
+/**
+ * \brief Disable change interrupts on the supplied input pins.
+ */
+void matrix_wakeup_disarm_pins(const pin_t *pins, uint8_t count);
+
+/**
+ * \brief Notify that an input pin has changed. Safe to call from an interrupt.
+ */
+void matrix_wakeup_signal(void);
+
+/**
+ * \brief Read whether any input is active while all outputs are selected. Used when interrupts are unavailable.
+ */
+bool matrix_wakeup_read_inputs(void);
+
+/**
+ * \brief Whether the matrix is currently idle, with all outputs selected.
+ */
+bool matrix_wakeup_is_idle(void);
+
+/**
+ * \brief Enter the idle state. All outputs must already be selected.
+ *
+ * \return false if an input was already active once armed. The matrix then stays in scan mode and the outputs
+ * should be unselected again.
+ */
+bool matrix_wakeup_idle_enter(const pin_t *pins, uint8_t count);
+
+/**
+ * \brief Leave the idle state. Outputs should be unselected afterwards.
+ */
+void matrix_wakeup_idle_exit(const pin_t *pins, uint8_t count);
+
+/**
+ * \brief Check, and clear, whether a change has been detected since the matrix went idle.
+ */
+bool matrix_wakeup_pending(void);
+
+/** \} */
@@ -0,0 +1,10 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+
+typedef uint8_t pin_t;
+
+#define MATRIX_ROWS 1
+#define MATRIX_COLS 4
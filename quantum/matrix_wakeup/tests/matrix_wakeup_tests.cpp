@@ -0,0 +1,97 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_wakeup.h"
+
+void matrix_wakeup_simulate_interrupts_available(bool available);
+int  matrix_wakeup_simulate_armed_count(void);
+void matrix_wakeup_simulate_edge(pin_t pin);
+}
+
+static bool inputs_active = false;
+static int  input_reads   = 0;
+
+extern "C" bool matrix_wakeup_read_inputs(void) {
+    input_reads++;
+    return inputs_active;
+}
+
+static const pin_t input_pins[] = {2, 3, NO_PIN, 5};
+
+class MatrixWakeup : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        inputs_active = false;
+        input_reads   = 0;
+        matrix_wakeup_simulate_interrupts_available(true);
+        matrix_wakeup_idle_exit(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+    }
+};
+
+TEST_F(MatrixWakeup, ScansWhenNotIdle) {
+    EXPECT_FALSE(matrix_wakeup_is_idle());
+    EXPECT_TRUE(matrix_wakeup_pending());
+}
+
+TEST_F(MatrixWakeup, IdleArmsInputPins) {
+    EXPECT_TRUE(matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0])));
+    EXPECT_TRUE(matrix_wakeup_is_idle());
+    EXPECT_EQ(matrix_wakeup_simulate_armed_count(), 3);
+
+    matrix_wakeup_idle_exit(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+    EXPECT_FALSE(matrix_wakeup_is_idle());
+    EXPECT_EQ(matrix_wakeup_simulate_armed_count(), 0);
+}
+
+TEST_F(MatrixWakeup, InterruptWakesIdleMatrix) {
+    matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+
+    // No change, no scan, and the pins are only read once when armed.
+    for (int i = 0; i < 100; i++) {
+        EXPECT_FALSE(matrix_wakeup_pending());
+    }
+    EXPECT_EQ(input_reads, 1);
+
+    // Unarmed pins do not wake the matrix.
+    matrix_wakeup_simulate_edge(7);
+    EXPECT_FALSE(matrix_wakeup_pending());
+
+    matrix_wakeup_simulate_edge(3);
+    EXPECT_TRUE(matrix_wakeup_pending());
+    // The signal is consumed once seen.
+    EXPECT_FALSE(matrix_wakeup_pending());
+}
+
+TEST_F(MatrixWakeup, StaleSignalIsDiscardedOnIdle) {
+    matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+    matrix_wakeup_simulate_edge(2);
+    matrix_wakeup_idle_exit(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+
+    matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+    EXPECT_FALSE(matrix_wakeup_pending());
+}
+
+TEST_F(MatrixWakeup, KeyHeldWhileArmingStaysInScanMode) {
+    // Pressed between the last scan and arming, so no edge will ever arrive.
+    inputs_active = true;
+    EXPECT_FALSE(matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0])));
+    EXPECT_FALSE(matrix_wakeup_is_idle());
+    EXPECT_EQ(matrix_wakeup_simulate_armed_count(), 0);
+    EXPECT_TRUE(matrix_wakeup_pending());
+}
+
+TEST_F(MatrixWakeup, PollsInputsWithoutInterrupts) {
+    matrix_wakeup_simulate_interrupts_available(false);
+    matrix_wakeup_idle_enter(input_pins, sizeof(input_pins) / sizeof(input_pins[0]));
+    EXPECT_EQ(matrix_wakeup_simulate_armed_count(), 0);
+
+    EXPECT_FALSE(matrix_wakeup_pending());
+    EXPECT_EQ(input_reads, 1);
+
+    inputs_active = true;
+    EXPECT_TRUE(matrix_wakeup_pending());
+    EXPECT_EQ(input_reads, 2);
+}
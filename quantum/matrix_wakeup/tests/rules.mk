@@ -0,0 +1,7 @@
+matrix_wakeup_DEFS := -DMATRIX_WAKEUP_ENABLE
+matrix_wakeup_CONFIG := $(QUANTUM_PATH)/matrix_wakeup/tests/config_mock.h
+
+matrix_wakeup_SRC := \
+	$(QUANTUM_PATH)/matrix_wakeup/tests/matrix_wakeup_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/matrix_wakeup.c \
+	$(QUANTUM_PATH)/matrix_wakeup.c
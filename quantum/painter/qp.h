@@ -72,6 +72,31 @@
 #    define QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE 1024
 #endif
 
+#ifndef QUANTUM_PAINTER_SPI_ASYNC
+/**
+ * @def This controls whether SPI displays are sent their pixel data in the background, using DMA where the platform
+ *      supports it. Data is copied into a queue of buffers, so drawing returns as soon as the last of it has been
+ *      queued rather than once it has been sent. Costs \ref QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH times
+ *      \ref QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE bytes of RAM.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC FALSE
+#endif
+
+#ifndef QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH
+/**
+ * @def This controls the number of buffers queued up for background SPI transmission, including the one being sent.
+ *      Must be a power of two.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC_QUEUE_LENGTH 2
+#endif
+
+#ifndef QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE
+/**
+ * @def This controls the size of each buffer queued up for background SPI transmission.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC_CHUNK_SIZE 1024
+#endif
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 /**
  * @def This controls whether 256-color palettes are supported. This has relatively hefty requirements on RAM -- at
@@ -80,6 +105,14 @@
 #    define QUANTUM_PAINTER_SUPPORTS_256_PALETTE FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+/**
+ * @def This controls whether assets compressed with QMK LZ can be drawn. This costs 1kB of RAM for the history window
+ *      the decoder copies matches from.
+ */
+#    define QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION FALSE
+#endif
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS
 /**
  * @def This controls whether the native color range is supported. This avoids the use of palettes but each image
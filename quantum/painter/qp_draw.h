@@ -54,6 +54,16 @@ void qp_internal_invalidate_palette(void);
 // Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
 bool qp_internal_load_qgf_palette(qp_stream_t* stream, uint8_t bpp);
 
+// Keys identifying the contents of the global palette, so that it only needs to be regenerated and converted when it changes. Expects the stream to be positioned at the start of the palette block header, and leaves it after the block.
+bool     qp_internal_hash_qgf_palette(qp_stream_t* stream, uint8_t bpp, uint32_t* key);
+uint32_t qp_internal_hash_interpolated_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
+
+// Checks whether the global palette currently holds the palette matching the key, already converted to the device's native pixel format.
+bool qp_internal_palette_is_converted(painter_device_t device, uint32_t key);
+
+// Records that the global palette now holds the palette matching the key, converted to the device's native pixel format.
+void qp_internal_palette_set_converted(painter_device_t device, uint32_t key);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter codec functions
 
@@ -63,6 +73,9 @@ enum qp_internal_rle_mode_t {
     NON_REPEATING_RUN,
 };
 
+// Size of the history that QMK LZ matches may refer back into, fixed by the format
+#define QP_LZ_WINDOW_SIZE 1024
+
 typedef struct qp_internal_byte_input_state_t {
     painter_device_t device;
     qp_stream_t*     src_stream;
@@ -73,6 +86,13 @@ typedef struct qp_internal_byte_input_state_t {
             enum qp_internal_rle_mode_t mode;
             uint8_t                     remain; // number of bytes remaining in the current mode
         } rle;
+        // LZ-specific
+        struct {
+            bool     match;    // whether the current run is copied from the window, rather than being literal bytes
+            uint16_t remain;   // number of bytes remaining in the current run
+            uint16_t distance; // how far back in the window the current match copies from
+            uint16_t pos;      // write position in the window
+        } lz;
     };
 } qp_internal_byte_input_state_t;
 
@@ -97,4 +117,5 @@ bool qp_internal_byte_appender(uint8_t byteval, void* cb_arg);
 //     - qp_internal_send_bytes                                  (bpp > 8)
 bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_count, qp_internal_byte_input_callback input_callback, void* input_state);
 
+// Sets up the input state to decode a new block of data with the supplied compression scheme, returning the matching input callback or NULL if it's unsupported.
 qp_internal_byte_input_callback qp_internal_prepare_input_state(qp_internal_byte_input_state_t* input_state, painter_compression_t compression);
@@ -126,6 +126,65 @@ static inline int16_t qp_drawimage_byte_rle_decoder(void* cb_arg) {
     return c;
 }
 
+#if QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+// Holds the most recently decoded bytes, for matches to copy from. Only one asset is ever being decoded at a time.
+static uint8_t qp_internal_lz_window[QP_LZ_WINDOW_SIZE];
+
+static inline int16_t qp_drawimage_byte_lz_decoder(void* cb_arg) {
+    qp_internal_byte_input_state_t* state = (qp_internal_byte_input_state_t*)cb_arg;
+
+    // Work out if we're parsing the next token
+    if (state->lz.remain == 0) {
+        int16_t token = qp_stream_get(state->src_stream);
+        if (token < 0) {
+            return STREAM_EOF;
+        }
+
+        if (token >= 128) {
+            // Match, with a 5-bit length and the high bits of a 10-bit distance, followed by the low bits of the distance
+            int16_t distance = qp_stream_get(state->src_stream);
+            if (distance < 0) {
+                return STREAM_EOF;
+            }
+            uint8_t length = (token >> 2) & 0x1F;
+            if (length == 0x1F) {
+                // Longer matches carry an extra length byte
+                int16_t extra = qp_stream_get(state->src_stream);
+                if (extra < 0) {
+                    return STREAM_EOF;
+                }
+                state->lz.remain = length + 3 + extra;
+            } else {
+                state->lz.remain = length + 3;
+            }
+            state->lz.match    = true;
+            state->lz.distance = (((token & 0x03) << 8) | distance) + 1;
+        } else {
+            // Literal run
+            state->lz.match  = false;
+            state->lz.remain = token + 1;
+        }
+    }
+
+    uint8_t c;
+    if (state->lz.match) {
+        c = qp_internal_lz_window[(state->lz.pos - state->lz.distance) & (QP_LZ_WINDOW_SIZE - 1)];
+    } else {
+        int16_t byteval = qp_stream_get(state->src_stream);
+        if (byteval < 0) {
+            return STREAM_EOF;
+        }
+        c = byteval;
+    }
+
+    qp_internal_lz_window[state->lz.pos & (QP_LZ_WINDOW_SIZE - 1)] = c;
+    state->lz.pos++;
+    state->lz.remain--;
+    state->curr = c;
+    return c;
+}
+#endif // QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+
 bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg) {
     qp_internal_pixel_output_state_t* state  = (qp_internal_pixel_output_state_t*)cb_arg;
     painter_driver_t*                 driver = (painter_driver_t*)state->device;
@@ -212,6 +271,13 @@ qp_internal_byte_input_callback qp_internal_prepare_input_state(qp_internal_byte
             input_state->rle.mode   = MARKER_BYTE;
             input_state->rle.remain = 0;
             return qp_drawimage_byte_rle_decoder;
+#if QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
+        case IMAGE_COMPRESSED_LZ:
+            input_state->lz.match  = false;
+            input_state->lz.remain = 0;
+            input_state->lz.pos    = 0;
+            return qp_drawimage_byte_lz_decoder;
+#endif // QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION
         default:
             return NULL;
     }
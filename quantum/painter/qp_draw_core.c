@@ -33,6 +33,10 @@ __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
+// What the lookup table holds once converted to native pixels, so that animation frames sharing a palette skip conversion
+static painter_device_t converted_palette_device = NULL;
+static uint32_t         converted_palette_key    = 0;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helpers
 
@@ -66,8 +70,9 @@ void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint
 
 // Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
 void qp_internal_invalidate_palette(void) {
-    generated_palette = false;
-    generated_steps   = -1;
+    generated_palette        = false;
+    generated_steps          = -1;
+    converted_palette_device = NULL;
 }
 
 // Interpolates between two colors to generate a palette
@@ -80,10 +85,11 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
     }
 
     // Save the parameters so we know whether we can skip generation
-    generated_palette      = true;
-    generated_steps        = steps;
-    interpolated_fg_hsv888 = fg_hsv888;
-    interpolated_bg_hsv888 = bg_hsv888;
+    generated_palette        = true;
+    generated_steps          = steps;
+    interpolated_fg_hsv888   = fg_hsv888;
+    interpolated_bg_hsv888   = bg_hsv888;
+    converted_palette_device = NULL;
 
     int16_t hue_fg = fg_hsv888.hsv888.h;
     int16_t hue_bg = bg_hsv888.hsv888.h;
@@ -140,6 +146,56 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     return true;
 }
 
+// FNV-1a, enough to tell palettes apart
+#define QP_PALETTE_HASH_BASIS 0x811C9DC5u
+#define QP_PALETTE_HASH_PRIME 0x01000193u
+
+static uint32_t qp_internal_hash_bytes(uint32_t hash, const uint8_t *data, uint32_t length) {
+    for (uint32_t i = 0; i < length; ++i) {
+        hash = (hash ^ data[i]) * QP_PALETTE_HASH_PRIME;
+    }
+    return hash;
+}
+
+bool qp_internal_hash_qgf_palette(qp_stream_t *stream, uint8_t bpp, uint32_t *key) {
+    qgf_palette_v1_t palette_descriptor;
+    if (qp_stream_read(&palette_descriptor, sizeof(qgf_palette_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read palette_descriptor, expected length was not %d\n", (int)sizeof(qgf_palette_v1_t));
+        return false;
+    }
+
+    uint32_t hash = qp_internal_hash_bytes(QP_PALETTE_HASH_BASIS, &bpp, sizeof(bpp));
+
+    // Read the palette entries in batches, rather than one at a time
+    const uint16_t         palette_entries = 1u << bpp;
+    qgf_palette_entry_v1_t entries[16];
+    for (uint16_t i = 0; i < palette_entries; i += 16) {
+        uint16_t batch = QP_MIN(palette_entries - i, 16);
+        if (qp_stream_read(entries, sizeof(qgf_palette_entry_v1_t), batch, stream) != batch) {
+            return false;
+        }
+        hash = qp_internal_hash_bytes(hash, (const uint8_t *)entries, batch * sizeof(qgf_palette_entry_v1_t));
+    }
+
+    *key = hash;
+    return true;
+}
+
+uint32_t qp_internal_hash_interpolated_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
+    // Starts with a marker so that it can't be mistaken for a palette read from an asset
+    const uint8_t params[] = {0xFF, fg_hsv888.hsv888.h, fg_hsv888.hsv888.s, fg_hsv888.hsv888.v, bg_hsv888.hsv888.h, bg_hsv888.hsv888.s, bg_hsv888.hsv888.v, steps & 0xFF, steps >> 8};
+    return qp_internal_hash_bytes(QP_PALETTE_HASH_BASIS, params, sizeof(params));
+}
+
+bool qp_internal_palette_is_converted(painter_device_t device, uint32_t key) {
+    return converted_palette_device == device && converted_palette_key == key;
+}
+
+void qp_internal_palette_set_converted(painter_device_t device, uint32_t key) {
+    converted_palette_device = device;
+    converted_palette_key    = key;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_setpixel
 
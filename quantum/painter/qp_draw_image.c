@@ -148,38 +148,51 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
         return false;
     }
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
-
     if (!qp_internal_bpp_capable(info->bpp)) {
         qp_dprintf("qp_drawimage_recolor: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE or QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS)\n", (int)info->bpp);
         qp_comms_stop(device);
         return false;
     }
 
-    // Handle palette if needed
-    const uint16_t palette_entries  = 1u << info->bpp;
-    bool           needs_pixconvert = false;
+    // Handle palette if needed -- frames of an animation usually share the same palette, so it's only loaded and
+    // converted to native pixels when it differs from what was last converted for this device
+    const uint16_t palette_entries = 1u << info->bpp;
     if (info->has_palette) {
-        // Load the palette from the stream
-        if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
+        int32_t  palette_offset = qp_stream_tell(&qgf_image->stream);
+        uint32_t palette_key;
+        if (!qp_internal_hash_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp, &palette_key)) {
             return false;
         }
 
-        needs_pixconvert = true;
-    } else {
-        if (info->bpp <= 8) {
-            // Interpolate from fg/bg
-            needs_pixconvert = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
+        if (!qp_internal_palette_is_converted(device, palette_key)) {
+            // Load the palette from the stream
+            qp_stream_setpos(&qgf_image->stream, palette_offset);
+            if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
+                return false;
+            }
+
+            // Convert the palette to native format
+            if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
+                qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
+                qp_comms_stop(device);
+                return false;
+            }
+            qp_internal_palette_set_converted(device, palette_key);
         }
-    }
-
-    if (needs_pixconvert) {
-        // Convert the palette to native format
-        if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
-            qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
-            return false;
+    } else if (info->bpp <= 8) {
+        uint32_t palette_key = qp_internal_hash_interpolated_palette(fg_hsv888, bg_hsv888, palette_entries);
+        if (!qp_internal_palette_is_converted(device, palette_key)) {
+            // Interpolate from fg/bg, ensuring we aren't reusing a palette converted for another device
+            qp_internal_invalidate_palette();
+            qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
+
+            // Convert the palette to native format
+            if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
+                qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
+                qp_comms_stop(device);
+                return false;
+            }
+            qp_internal_palette_set_converted(device, palette_key);
         }
     }
 
@@ -296,6 +309,8 @@ typedef struct animation_state_t {
     qp_pixel_t             fg_hsv888;
     qp_pixel_t             bg_hsv888;
     uint16_t               frame_number;
+    uint16_t               frame_delay;
+    bool                   drawn;
     deferred_token         defer_token;
 } animation_state_t;
 
@@ -303,6 +318,13 @@ static deferred_executor_t animation_executors[QUANTUM_PAINTER_CONCURRENT_ANIMAT
 static animation_state_t   animation_states[QUANTUM_PAINTER_CONCURRENT_ANIMATIONS]    = {0};
 
 static deferred_token qp_render_animation_state(animation_state_t *state, uint16_t *delay_ms) {
+    // Frames that don't change anything are merged into the one before by the generator, so a single frame has nothing
+    // left to redraw once it's on screen.
+    if (state->drawn && state->image->frame_count == 1) {
+        *delay_ms = state->frame_delay;
+        return true;
+    }
+
     qgf_frame_info_t frame_info = {0};
     qp_dprintf("qp_render_animation_state: entry (frame #%d)\n", (int)state->frame_number);
     bool ret = qp_drawimage_recolor_impl(state->device, state->x, state->y, state->image, state->frame_number, &frame_info, state->fg_hsv888, state->bg_hsv888);
@@ -311,7 +333,9 @@ static deferred_token qp_render_animation_state(animation_state_t *state, uint16
         if (state->frame_number >= state->image->frame_count) {
             state->frame_number = 0;
         }
-        *delay_ms = frame_info.delay;
+        *delay_ms          = frame_info.delay;
+        state->frame_delay = frame_info.delay;
+        state->drawn       = true;
     }
     qp_dprintf("qp_render_animation_state: %s (delay %dms)\n", ret ? "ok" : "fail", (int)(*delay_ms));
     return ret;
@@ -353,6 +377,7 @@ deferred_token qp_animate_recolor(painter_device_t device, uint16_t x, uint16_t
     anim_state->fg_hsv888    = (qp_pixel_t){.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
     anim_state->bg_hsv888    = (qp_pixel_t){.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
     anim_state->frame_number = 0;
+    anim_state->drawn        = false;
 
     // Draw the first frame
     uint16_t delay_ms;
@@ -1,12 +1,17 @@
 // Copyright 2021 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
 #include "qp_stream.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Stream API
 
 uint32_t qp_stream_read_impl(void *output_buf, uint32_t member_size, uint32_t num_members, qp_stream_t *stream) {
+    if (stream->read) {
+        return stream->read(stream, output_buf, num_members * member_size) / member_size;
+    }
+
     uint8_t *output_ptr = (uint8_t *)output_buf;
 
     uint32_t i;
@@ -57,6 +62,18 @@ static inline bool mem_put(qp_stream_t *stream, uint8_t c) {
     return true;
 }
 
+static inline uint32_t mem_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_memory_stream_t *s         = (qp_memory_stream_t *)stream;
+    uint32_t            available = (s->position < s->length) ? (uint32_t)(s->length - s->position) : 0;
+    if (length > available) {
+        length    = available;
+        s->is_eof = true;
+    }
+    memcpy(output_buf, &s->buffer[s->position], length);
+    s->position += length;
+    return length;
+}
+
 static inline int mem_seek(qp_stream_t *stream, int32_t offset, int origin) {
     qp_memory_stream_t *s = (qp_memory_stream_t *)stream;
 
@@ -111,7 +128,7 @@ static inline void mem_close(qp_stream_t *stream) {
 
 qp_memory_stream_t qp_make_memory_stream(void *buffer, int32_t length) {
     qp_memory_stream_t stream = {
-        .base     = {.get = mem_get, .put = mem_put, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close},
+        .base     = {.get = mem_get, .put = mem_put, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close, .read = mem_read},
         .buffer   = (uint8_t *)buffer,
         .length   = length,
         .position = 0,
@@ -136,6 +153,11 @@ static inline bool file_put(qp_stream_t *stream, uint8_t c) {
     return fputc(c, s->file) == c;
 }
 
+static inline uint32_t file_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_file_stream_t *s = (qp_file_stream_t *)stream;
+    return (uint32_t)fread(output_buf, 1, length, s->file);
+}
+
 static inline int file_seek(qp_stream_t *stream, int32_t offset, int origin) {
     qp_file_stream_t *s = (qp_file_stream_t *)stream;
     return fseek(s->file, offset, origin);
@@ -158,7 +180,7 @@ static inline void file_close(qp_stream_t *stream) {
 
 qp_file_stream_t qp_make_file_stream(FILE *f) {
     qp_file_stream_t stream = {
-        .base = {.get = file_get, .put = file_put, .seek = file_seek, .tell = file_tell, .is_eof = file_is_eof, .close = file_close},
+        .base = {.get = file_get, .put = file_put, .seek = file_seek, .tell = file_tell, .is_eof = file_is_eof, .close = file_close, .read = file_read},
         .file = f,
     };
     return stream;
@@ -55,6 +55,8 @@ typedef struct qp_stream_t {
     int32_t (*tell)(qp_stream_t *stream);
     bool (*is_eof)(qp_stream_t *stream);
     void (*close)(qp_stream_t *stream);
+    // Optional, reads up to length bytes in one go and returns the number read -- otherwise get() is used a byte at a time
+    uint32_t (*read)(qp_stream_t *stream, void *output_buf, uint32_t length);
 } qp_stream_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
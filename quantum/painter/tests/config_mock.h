@@ -0,0 +1,6 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// TRUE/FALSE come from ChibiOS, which the test platform doesn't have.
+#define QUANTUM_PAINTER_SUPPORTS_LZ_COMPRESSION 1
@@ -0,0 +1,131 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "qp_draw.h"
+
+// Only the byte decoders are exercised, the pixel output side is never reached.
+uint8_t    qp_internal_global_pixdata_buffer[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+qp_pixel_t qp_internal_global_pixel_lookup_table[16];
+uint32_t   qp_internal_num_pixels_in_buffer(painter_device_t device) {
+    return 0;
+}
+bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
+    return false;
+}
+}
+
+#include "qp_codec_vectors.h"
+
+static const uint16_t test_image_width  = 64;
+static const uint16_t test_image_height = 64;
+
+static uint8_t test_image_pixel(uint16_t x, uint16_t y) {
+    int32_t dx = x - 32, dy = y - 32;
+    return (dx * dx + dy * dy < 24 * 24) ? ((x + y) / 8) & 0x0F : 0;
+}
+
+static std::vector<uint8_t> test_image_bytes(void) {
+    std::vector<uint8_t> bytes;
+    for (uint16_t y = 0; y < test_image_height; ++y) {
+        for (uint16_t x = 0; x < test_image_width; x += 2) {
+            bytes.push_back(test_image_pixel(x, y) | (test_image_pixel(x + 1, y) << 4));
+        }
+    }
+    return bytes;
+}
+
+static std::vector<uint8_t> decode(const uint8_t *data, size_t length, painter_compression_t compression, size_t count) {
+    qp_memory_stream_t             stream      = qp_make_memory_stream((void *)data, length);
+    qp_internal_byte_input_state_t input_state = {.device = NULL, .src_stream = (qp_stream_t *)&stream};
+    qp_internal_byte_input_callback input      = qp_internal_prepare_input_state(&input_state, compression);
+
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < count; ++i) {
+        int16_t byteval = input(&input_state);
+        if (byteval < 0) {
+            break;
+        }
+        bytes.push_back(byteval);
+    }
+    return bytes;
+}
+
+TEST(QuantumPainterCodec, RLERoundTrip) {
+    std::vector<uint8_t> expected = test_image_bytes();
+    EXPECT_EQ(decode(test_image_rle, sizeof(test_image_rle), IMAGE_COMPRESSED_RLE, expected.size()), expected);
+}
+
+TEST(QuantumPainterCodec, LZRoundTrip) {
+    std::vector<uint8_t> expected = test_image_bytes();
+    EXPECT_EQ(decode(test_image_lz, sizeof(test_image_lz), IMAGE_COMPRESSED_LZ, expected.size()), expected);
+    EXPECT_LT(sizeof(test_image_lz), sizeof(test_image_rle));
+}
+
+TEST(QuantumPainterCodec, LZRestartsForEachBlock) {
+    // Glyphs and frames are decoded separately, and mustn't see each other's history.
+    std::vector<uint8_t> expected = test_image_bytes();
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(decode(test_image_lz, sizeof(test_image_lz), IMAGE_COMPRESSED_LZ, expected.size()), expected);
+    }
+}
+
+TEST(QuantumPainterCodec, LZLongOverlappingMatch) {
+    // One literal, then a maximum-length match copying it forwards one byte at a time.
+    const uint8_t data[] = {0x00, 0xAA, 0xFC, 0x00, 0xFF};
+    EXPECT_EQ(decode(data, sizeof(data), IMAGE_COMPRESSED_LZ, 1000), std::vector<uint8_t>(1 + 3 + 31 + 255, 0xAA));
+}
+
+TEST(QuantumPainterCodec, LZTruncated) {
+    std::vector<uint8_t> expected = test_image_bytes();
+    for (size_t length : {(size_t)0, (size_t)1, sizeof(test_image_lz) / 2, sizeof(test_image_lz) - 1}) {
+        EXPECT_LT(decode(test_image_lz, length, IMAGE_COMPRESSED_LZ, expected.size()).size(), expected.size());
+    }
+}
+
+TEST(QuantumPainterCodec, UnsupportedCompression) {
+    qp_internal_byte_input_state_t input_state = {};
+    EXPECT_EQ(qp_internal_prepare_input_state(&input_state, (painter_compression_t)0x7F), nullptr);
+}
+
+TEST(QuantumPainterCodec, DecodeSpeed) {
+    const int            iterations = 2000;
+    std::vector<uint8_t> expected   = test_image_bytes();
+
+    auto bytes_per_second = [&](const uint8_t *data, size_t length, painter_compression_t compression) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            EXPECT_EQ(decode(data, length, compression, expected.size()).size(), expected.size());
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return expected.size() * iterations / elapsed.count();
+    };
+
+    double rle = bytes_per_second(test_image_rle, sizeof(test_image_rle), IMAGE_COMPRESSED_RLE);
+    double lz  = bytes_per_second(test_image_lz, sizeof(test_image_lz), IMAGE_COMPRESSED_LZ);
+    std::printf("RLE: %4zu bytes, %8.1f MB/s decoded\n", sizeof(test_image_rle), rle / 1e6);
+    std::printf("LZ:  %4zu bytes, %8.1f MB/s decoded\n", sizeof(test_image_lz), lz / 1e6);
+}
+
+TEST(QuantumPainterStream, MemoryStreamBulkRead) {
+    uint8_t            data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint16_t           members[4];
+    qp_memory_stream_t stream = qp_make_memory_stream(data, sizeof(data));
+
+    ASSERT_EQ(qp_stream_read(members, sizeof(uint16_t), 2, &stream), 2);
+    EXPECT_EQ(memcmp(members, data, 4), 0);
+    EXPECT_FALSE(qp_stream_eof(&stream));
+
+    // Only whole members are counted, but the stream is still left at the end
+    ASSERT_EQ(qp_stream_read(members, sizeof(uint16_t), 4, &stream), 3);
+    EXPECT_EQ(memcmp(members, &data[4], 6), 0);
+    EXPECT_TRUE(qp_stream_eof(&stream));
+    EXPECT_EQ(qp_stream_tell(&stream), sizeof(data));
+    EXPECT_EQ(qp_stream_get(&stream), STREAM_EOF);
+}
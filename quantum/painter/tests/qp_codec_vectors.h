@@ -0,0 +1,86 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+
+// 64x64 4bpp test image, as generated by test_image_pixel(), encoded by `lib/python/qmk/painter.py`.
+
+static const uint8_t test_image_rle[878] = {
+    0x7F, 0x00, 0x7F, 0x00, 0x2F, 0x00, 0x02, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x05, 0x17, 0x00,
+    0x80, 0x40, 0x03, 0x44, 0x04, 0x55, 0x02, 0x66, 0x15, 0x00, 0x80, 0x40, 0x03, 0x44, 0x80, 0x54,
+    0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x13, 0x00, 0x80, 0x30, 0x04, 0x44, 0x04, 0x55, 0x04, 0x66,
+    0x80, 0x77, 0x12, 0x00, 0x80, 0x43, 0x03, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66,
+    0x82, 0x76, 0x77, 0x07, 0x10, 0x00, 0x80, 0x30, 0x04, 0x44, 0x04, 0x55, 0x04, 0x66, 0x03, 0x77,
+    0x10, 0x00, 0x80, 0x43, 0x03, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76,
+    0x03, 0x77, 0x80, 0x07, 0x0E, 0x00, 0x80, 0x30, 0x04, 0x44, 0x04, 0x55, 0x04, 0x66, 0x04, 0x77,
+    0x80, 0x88, 0x0E, 0x00, 0x80, 0x43, 0x03, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66,
+    0x80, 0x76, 0x03, 0x77, 0x82, 0x87, 0x88, 0x08, 0x0C, 0x00, 0x80, 0x30, 0x04, 0x44, 0x04, 0x55,
+    0x04, 0x66, 0x04, 0x77, 0x03, 0x88, 0x0C, 0x00, 0x80, 0x43, 0x03, 0x44, 0x80, 0x54, 0x03, 0x55,
+    0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x08, 0x0B, 0x00,
+    0x04, 0x44, 0x04, 0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x80, 0x09, 0x0A, 0x00, 0x80, 0x40,
+    0x03, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87,
+    0x03, 0x88, 0x81, 0x98, 0x99, 0x0A, 0x00, 0x80, 0x40, 0x03, 0x44, 0x04, 0x55, 0x04, 0x66, 0x04,
+    0x77, 0x04, 0x88, 0x02, 0x99, 0x0A, 0x00, 0x03, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03,
+    0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x02, 0x99, 0x80, 0x09, 0x09,
+    0x00, 0x03, 0x44, 0x04, 0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x03, 0x99, 0x80, 0x09, 0x09,
+    0x00, 0x02, 0x44, 0x80, 0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80,
+    0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0x09, 0x08, 0x00, 0x80, 0x40, 0x02, 0x44, 0x04,
+    0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x04, 0x99, 0x80, 0xAA, 0x08, 0x00, 0x82, 0x40, 0x44,
+    0x54, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80,
+    0x98, 0x03, 0x99, 0x81, 0xA9, 0xAA, 0x08, 0x00, 0x81, 0x40, 0x44, 0x04, 0x55, 0x04, 0x66, 0x04,
+    0x77, 0x04, 0x88, 0x04, 0x99, 0x02, 0xAA, 0x08, 0x00, 0x81, 0x40, 0x54, 0x03, 0x55, 0x80, 0x65,
+    0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9,
+    0x02, 0xAA, 0x08, 0x00, 0x80, 0x40, 0x04, 0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x04, 0x99,
+    0x03, 0xAA, 0x08, 0x00, 0x80, 0x50, 0x03, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77,
+    0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x08, 0x00, 0x80, 0x50,
+    0x03, 0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x08, 0x00, 0x80, 0x50,
+    0x02, 0x55, 0x80, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98,
+    0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80, 0xBA, 0x08, 0x00, 0x80, 0x50, 0x02, 0x55, 0x04, 0x66,
+    0x04, 0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x80, 0xBB, 0x08, 0x00, 0x82, 0x50, 0x55, 0x65,
+    0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9,
+    0x03, 0xAA, 0x81, 0xBA, 0xBB, 0x08, 0x00, 0x81, 0x50, 0x55, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88,
+    0x04, 0x99, 0x04, 0xAA, 0x02, 0xBB, 0x08, 0x00, 0x81, 0x50, 0x65, 0x03, 0x66, 0x80, 0x76, 0x03,
+    0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80, 0xBA, 0x02,
+    0xBB, 0x08, 0x00, 0x80, 0x50, 0x04, 0x66, 0x04, 0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x03,
+    0xBB, 0x09, 0x00, 0x03, 0x66, 0x80, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03,
+    0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80, 0xBA, 0x02, 0xBB, 0x80, 0x0B, 0x09, 0x00, 0x03, 0x66, 0x04,
+    0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x03, 0xBB, 0x80, 0x0B, 0x09, 0x00, 0x02, 0x66, 0x80,
+    0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80,
+    0xBA, 0x03, 0xBB, 0x80, 0x0B, 0x09, 0x00, 0x81, 0x60, 0x66, 0x04, 0x77, 0x04, 0x88, 0x04, 0x99,
+    0x04, 0xAA, 0x04, 0xBB, 0x0A, 0x00, 0x81, 0x60, 0x76, 0x03, 0x77, 0x80, 0x87, 0x03, 0x88, 0x80,
+    0x98, 0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80, 0xBA, 0x03, 0xBB, 0x80, 0xCB, 0x0B, 0x00, 0x04,
+    0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x04, 0xBB, 0x80, 0x0C, 0x0B, 0x00, 0x03, 0x77, 0x80,
+    0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80, 0xBA, 0x03, 0xBB, 0x81,
+    0xCB, 0x0C, 0x0B, 0x00, 0x80, 0x70, 0x02, 0x77, 0x04, 0x88, 0x04, 0x99, 0x04, 0xAA, 0x04, 0xBB,
+    0x80, 0xCC, 0x0D, 0x00, 0x81, 0x77, 0x87, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9, 0x03,
+    0xAA, 0x80, 0xBA, 0x03, 0xBB, 0x81, 0xCB, 0x0C, 0x0D, 0x00, 0x80, 0x70, 0x04, 0x88, 0x04, 0x99,
+    0x04, 0xAA, 0x04, 0xBB, 0x80, 0xCC, 0x0F, 0x00, 0x03, 0x88, 0x80, 0x98, 0x03, 0x99, 0x80, 0xA9,
+    0x03, 0xAA, 0x80, 0xBA, 0x03, 0xBB, 0x81, 0xCB, 0x0C, 0x0F, 0x00, 0x80, 0x80, 0x02, 0x88, 0x04,
+    0x99, 0x04, 0xAA, 0x04, 0xBB, 0x80, 0xCC, 0x11, 0x00, 0x81, 0x88, 0x98, 0x03, 0x99, 0x80, 0xA9,
+    0x03, 0xAA, 0x80, 0xBA, 0x03, 0xBB, 0x81, 0xCB, 0x0C, 0x11, 0x00, 0x80, 0x80, 0x04, 0x99, 0x04,
+    0xAA, 0x04, 0xBB, 0x80, 0xCC, 0x13, 0x00, 0x80, 0x90, 0x02, 0x99, 0x80, 0xA9, 0x03, 0xAA, 0x80,
+    0xBA, 0x03, 0xBB, 0x80, 0xCB, 0x15, 0x00, 0x81, 0x90, 0x99, 0x04, 0xAA, 0x04, 0xBB, 0x18, 0x00,
+    0x03, 0xAA, 0x80, 0xBA, 0x02, 0xBB, 0x80, 0x0B, 0x7F, 0x00, 0x7F, 0x00, 0x0E, 0x00,
+};
+
+static const uint8_t test_image_lz[288] = {
+    0x00, 0x00, 0xFC, 0x00, 0xFF, 0xA0, 0x00, 0x06, 0x44, 0x44, 0x54, 0x55, 0x55, 0x55, 0x05, 0xD0,
+    0x1D, 0x03, 0x40, 0x44, 0x44, 0x44, 0x80, 0x1E, 0x02, 0x55, 0x66, 0x66, 0xD8, 0x1E, 0x84, 0x3E,
+    0x01, 0x65, 0x66, 0xC8, 0x20, 0x00, 0x30, 0x80, 0x1E, 0x90, 0x3E, 0x02, 0x66, 0x66, 0x77, 0xBC,
+    0x1F, 0x00, 0x43, 0xA0, 0x3E, 0x02, 0x76, 0x77, 0x07, 0xEC, 0x3E, 0x00, 0x77, 0xB8, 0x40, 0xAC,
+    0x3E, 0x00, 0x77, 0xB4, 0x40, 0xB4, 0x3E, 0x01, 0x77, 0x88, 0xEC, 0x3E, 0x02, 0x87, 0x88, 0x08,
+    0xEC, 0x3E, 0x00, 0x88, 0xA8, 0x40, 0xBC, 0x3E, 0x00, 0x88, 0xA8, 0x40, 0xC0, 0x3E, 0x01, 0x88,
+    0x09, 0x9C, 0x1E, 0xA5, 0x3A, 0x94, 0x3E, 0x01, 0x98, 0x99, 0xAC, 0x1F, 0xB4, 0x3E, 0x00, 0x99,
+    0xA0, 0x1F, 0xC8, 0x3E, 0x00, 0x99, 0x9C, 0x60, 0xC8, 0x3E, 0xA8, 0x1F, 0xC0, 0x3E, 0x9C, 0x1F,
+    0x80, 0x7E, 0xC0, 0x3E, 0x01, 0x99, 0xAA, 0x9C, 0x1F, 0xC4, 0x3E, 0x00, 0xA9, 0xA0, 0x1F, 0xC8,
+    0x3E, 0x9C, 0x1F, 0xCC, 0x3E, 0x9C, 0x1F, 0xCC, 0x3E, 0x98, 0x1F, 0x00, 0x50, 0xCC, 0x3E, 0xA8,
+    0x1F, 0xC0, 0x3E, 0xA4, 0x1F, 0xC4, 0x3E, 0x00, 0xBA, 0xA0, 0x1F, 0xC4, 0x3E, 0x00, 0xBB, 0x9C,
+    0x1F, 0xC8, 0x3E, 0xA0, 0x1F, 0xC8, 0x3E, 0x9C, 0x1F, 0xCC, 0x3E, 0x9C, 0x1F, 0xCC, 0x3E, 0x98,
+    0x1F, 0x00, 0x00, 0xCC, 0x3E, 0x00, 0x0B, 0xA4, 0x1F, 0xC0, 0x3E, 0xA4, 0x1F, 0xC0, 0x3E, 0xA0,
+    0x1F, 0x00, 0x60, 0xC4, 0x3E, 0x9C, 0x7E, 0x01, 0x00, 0x60, 0xC4, 0x3E, 0x00, 0xCB, 0x9C, 0x1F,
+    0x00, 0x00, 0xC4, 0x3E, 0x00, 0x0C, 0xAC, 0x1F, 0xB8, 0x3E, 0xA4, 0x1F, 0x00, 0x70, 0xBC, 0x3E,
+    0x00, 0xCC, 0xA0, 0x1E, 0x80, 0x40, 0xE8, 0x3E, 0x80, 0x40, 0xEC, 0x3E, 0x01, 0x00, 0x00, 0xEC,
+    0x3E, 0x02, 0x00, 0x00, 0x80, 0xEC, 0x3E, 0x80, 0x40, 0xE8, 0x3E, 0x80, 0x40, 0xEC, 0x3E, 0x02,
+    0x00, 0x00, 0x90, 0xCD, 0x3A, 0xA4, 0x20, 0xBD, 0x79, 0xAC, 0x00, 0xB5, 0xF7, 0xFC, 0x00, 0xE1,
+};
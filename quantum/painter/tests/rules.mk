@@ -0,0 +1,9 @@
+qp_codec_DEFS := -DQUANTUM_PAINTER_ENABLE -DEEPROM_TEST_HARNESS
+qp_codec_CONFIG := $(QUANTUM_PATH)/painter/tests/config_mock.h
+
+qp_codec_SRC := \
+	$(QUANTUM_PATH)/painter/tests/qp_codec_tests.cpp \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c
+
+qp_codec_INC := $(QUANTUM_PATH)/painter
@@ -20,10 +20,14 @@
 #include <string.h>
 #include "timer.h"
 #include "gpio.h"
+#include "util.h"
 
 #ifdef MOUSEKEY_ENABLE
 #    include "mousekey.h"
 #endif
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+#    include "pointing_device_motion.h"
+#endif
 
 #if (defined(POINTING_DEVICE_ROTATION_90) + defined(POINTING_DEVICE_ROTATION_180) + defined(POINTING_DEVICE_ROTATION_270)) > 1
 #    error More than one rotation selected.  This is not supported.
@@ -81,6 +85,177 @@ static bool           pointing_device_force_send = false;
 
 extern const pointing_device_driver_t pointing_device_driver;
 
+#ifndef POINTING_DEVICE_SCALE_XY
+#    define POINTING_DEVICE_SCALE_XY POINTING_DEVICE_FIXED_ONE
+#endif
+#ifndef POINTING_DEVICE_SCALE_HV
+#    define POINTING_DEVICE_SCALE_HV POINTING_DEVICE_FIXED_ONE
+#endif
+
+static uint16_t pointing_device_scales[POINTING_DEVICE_AXIS_COUNT] = {POINTING_DEVICE_SCALE_XY, POINTING_DEVICE_SCALE_XY, POINTING_DEVICE_SCALE_HV, POINTING_DEVICE_SCALE_HV};
+// Fractional motion carried over to the next report, in units of 1/POINTING_DEVICE_FIXED_ONE.
+static int16_t pointing_device_remainders[POINTING_DEVICE_AXIS_COUNT] = {0};
+
+#ifdef POINTING_DEVICE_CURVE
+static const pointing_device_curve_point_t  pointing_device_default_curve[] = POINTING_DEVICE_CURVE;
+static const pointing_device_curve_point_t *pointing_device_curve           = pointing_device_default_curve;
+static uint8_t                              pointing_device_curve_count     = sizeof(pointing_device_default_curve) / sizeof(pointing_device_default_curve[0]);
+#else
+static const pointing_device_curve_point_t *pointing_device_curve       = NULL;
+static uint8_t                              pointing_device_curve_count = 0;
+#endif
+
+/**
+ * @brief clamps int16_t to int8_t
+ *
+ * @param[in] int16_t value
+ * @return int8_t clamped value
+ */
+static inline int8_t pointing_device_hv_clamp(int16_t value) {
+    if (value < INT8_MIN) {
+        return INT8_MIN;
+    } else if (value > INT8_MAX) {
+        return INT8_MAX;
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief clamps int16_t to int8_t
+ *
+ * @param[in] clamp_range_t value
+ * @return mouse_xy_report_t clamped value
+ */
+static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
+    if (value < XY_REPORT_MIN) {
+        return XY_REPORT_MIN;
+    } else if (value > XY_REPORT_MAX) {
+        return XY_REPORT_MAX;
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief Sets the scale applied to an axis
+ *
+ * Motion on the axis is multiplied by scale / POINTING_DEVICE_FIXED_ONE before being clamped to the report, with the
+ * fractional part carried over to the next report.
+ *
+ * @param[in] axis pointing_device_axis_t
+ * @param[in] scale uint16_t, POINTING_DEVICE_FIXED_ONE for no scaling
+ */
+void pointing_device_set_scale(pointing_device_axis_t axis, uint16_t scale) {
+    if (axis < POINTING_DEVICE_AXIS_COUNT) {
+        pointing_device_scales[axis]     = scale;
+        pointing_device_remainders[axis] = 0;
+    }
+}
+
+/**
+ * @brief Gets the scale applied to an axis
+ *
+ * @param[in] axis pointing_device_axis_t
+ * @return uint16_t scale, POINTING_DEVICE_FIXED_ONE for no scaling
+ */
+uint16_t pointing_device_get_scale(pointing_device_axis_t axis) {
+    return axis < POINTING_DEVICE_AXIS_COUNT ? pointing_device_scales[axis] : POINTING_DEVICE_FIXED_ONE;
+}
+
+/**
+ * @brief Sets the curve applied to X and Y motion on top of their scales
+ *
+ * The gain is interpolated between the points, which must be sorted by speed. The points are not copied.
+ *
+ * @param[in] points pointing_device_curve_point_t array, or NULL for no curve
+ * @param[in] count number of points
+ */
+void pointing_device_set_curve(const pointing_device_curve_point_t *points, uint8_t count) {
+    pointing_device_curve       = points;
+    pointing_device_curve_count = points ? count : 0;
+}
+
+/**
+ * @brief Gets the fractional motion carried over to the next report on an axis
+ *
+ * @param[in] axis pointing_device_axis_t
+ * @return int16_t remainder in units of 1/POINTING_DEVICE_FIXED_ONE
+ */
+int16_t pointing_device_get_remainder(pointing_device_axis_t axis) {
+    return axis < POINTING_DEVICE_AXIS_COUNT ? pointing_device_remainders[axis] : 0;
+}
+
+/**
+ * @brief Discards the fractional motion carried over on all axes
+ */
+void pointing_device_clear_remainders(void) {
+    memset(pointing_device_remainders, 0, sizeof(pointing_device_remainders));
+}
+
+static uint16_t pointing_device_curve_gain(uint16_t speed) {
+    if (pointing_device_curve_count == 0) {
+        return POINTING_DEVICE_FIXED_ONE;
+    }
+    if (speed <= pointing_device_curve[0].speed) {
+        return pointing_device_curve[0].gain;
+    }
+    for (uint8_t i = 1; i < pointing_device_curve_count; i++) {
+        const pointing_device_curve_point_t *prev = &pointing_device_curve[i - 1];
+        const pointing_device_curve_point_t *next = &pointing_device_curve[i];
+        if (speed < next->speed) {
+            return prev->gain + ((int32_t)next->gain - prev->gain) * (speed - prev->speed) / (next->speed - prev->speed);
+        }
+    }
+    return pointing_device_curve[pointing_device_curve_count - 1].gain;
+}
+
+static pointing_device_fixed_t pointing_device_accumulate(pointing_device_axis_t axis, pointing_device_fixed_t value, uint16_t gain) {
+    pointing_device_fixed_t scaled = value * gain + pointing_device_remainders[axis];
+    // Truncating towards zero keeps the remainder's sign with the motion, so slow motion in either direction behaves the same.
+    pointing_device_fixed_t whole    = scaled / POINTING_DEVICE_FIXED_ONE;
+    pointing_device_remainders[axis] = scaled - whole * POINTING_DEVICE_FIXED_ONE;
+    return whole;
+}
+
+/**
+ * @brief Scales motion through the sub-pixel accumulator and clamps it into a report
+ */
+static void pointing_device_scale_motion(report_mouse_t *mouse_report, clamp_range_t x, clamp_range_t y, int16_t h, int16_t v) {
+    uint16_t gain_x = pointing_device_scales[POINTING_DEVICE_AXIS_X];
+    uint16_t gain_y = pointing_device_scales[POINTING_DEVICE_AXIS_Y];
+
+    if (pointing_device_curve_count) {
+        // Approximates the length of the motion vector as max + min / 2.
+        uint32_t abs_x = x < 0 ? -(int32_t)x : x;
+        uint32_t abs_y = y < 0 ? -(int32_t)y : y;
+        uint32_t speed = abs_x > abs_y ? abs_x + abs_y / 2 : abs_y + abs_x / 2;
+        uint32_t curve = pointing_device_curve_gain(speed > UINT16_MAX ? UINT16_MAX : speed);
+
+        gain_x = MIN(((uint32_t)gain_x * curve) >> POINTING_DEVICE_FIXED_SHIFT, UINT16_MAX);
+        gain_y = MIN(((uint32_t)gain_y * curve) >> POINTING_DEVICE_FIXED_SHIFT, UINT16_MAX);
+    }
+
+    mouse_report->x = pointing_device_xy_clamp(pointing_device_accumulate(POINTING_DEVICE_AXIS_X, x, gain_x));
+    mouse_report->y = pointing_device_xy_clamp(pointing_device_accumulate(POINTING_DEVICE_AXIS_Y, y, gain_y));
+    mouse_report->h = pointing_device_hv_clamp(pointing_device_accumulate(POINTING_DEVICE_AXIS_H, h, pointing_device_scales[POINTING_DEVICE_AXIS_H]));
+    mouse_report->v = pointing_device_hv_clamp(pointing_device_accumulate(POINTING_DEVICE_AXIS_V, v, pointing_device_scales[POINTING_DEVICE_AXIS_V]));
+}
+
+/**
+ * @brief Scales a mouse report through the sub-pixel accumulator
+ *
+ * Applies the axis scales and curve, carrying fractional motion over to the next report. This is done for every report
+ * after pointing_device_task_kb, or in pointing_device_combine_reports for combined split pointing devices.
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @return report_mouse_t with scaled values
+ */
+report_mouse_t pointing_device_scale_report(report_mouse_t mouse_report) {
+    pointing_device_scale_motion(&mouse_report, mouse_report.x, mouse_report.y, mouse_report.h, mouse_report.v);
+    return mouse_report;
+}
+
 /**
  * @brief Keyboard level code pointing device initialisation
  *
@@ -153,6 +328,9 @@ __attribute__((weak)) void pointing_device_init(void) {
 #    else
         gpio_set_pin_input(POINTING_DEVICE_MOTION_PIN);
 #    endif
+#endif
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+        pointing_device_motion_init();
 #endif
     }
 
@@ -246,7 +424,9 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #    if defined(SPLIT_POINTING_ENABLE)
 #        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
 #    endif
-#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+#    if defined(POINTING_DEVICE_MOTION_INTERRUPT_ENABLE)
+    if (pointing_device_motion_pending())
+#    elif defined(POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW)
     if (!gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
 #    else
     if (gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
@@ -269,10 +449,26 @@ __attribute__((weak)) bool pointing_device_task(void) {
     local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
 #endif // defined(SPLIT_POINTING_ENABLE)
 
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+        pointing_device_motion_acquired();
+        pointing_device_motion_add(local_mouse_report.x, local_mouse_report.y);
+        local_mouse_report.x = 0;
+        local_mouse_report.y = 0;
+#endif
+
 #ifdef POINTING_DEVICE_MOTION_PIN
     }
 #endif
 
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+    // Accumulated motion goes out at the rate the host polls for it.
+    mouse_xy_report_t motion_x, motion_y;
+    if (pointing_device_motion_take(&motion_x, &motion_y)) {
+        local_mouse_report.x = motion_x;
+        local_mouse_report.y = motion_y;
+    }
+#endif
+
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
     if (is_keyboard_left()) {
@@ -286,6 +482,7 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #else
     local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
     local_mouse_report = pointing_device_task_kb(local_mouse_report);
+    local_mouse_report = pointing_device_scale_report(local_mouse_report);
 #endif
     // automatic mouse layer function
 #ifdef POINTING_DEVICE_AUTO_MOUSE_ENABLE
@@ -376,41 +573,11 @@ void pointing_device_set_cpi_on_side(bool left, uint16_t cpi) {
     }
 }
 
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] int16_t value
- * @return int8_t clamped value
- */
-static inline int8_t pointing_device_hv_clamp(int16_t value) {
-    if (value < INT8_MIN) {
-        return INT8_MIN;
-    } else if (value > INT8_MAX) {
-        return INT8_MAX;
-    } else {
-        return value;
-    }
-}
-
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] clamp_range_t value
- * @return mouse_xy_report_t clamped value
- */
-static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
-    if (value < XY_REPORT_MIN) {
-        return XY_REPORT_MIN;
-    } else if (value > XY_REPORT_MAX) {
-        return XY_REPORT_MAX;
-    } else {
-        return value;
-    }
-}
 /**
  * @brief combines 2 mouse reports and returns 2
  *
- * Combines 2 report_mouse_t structs, clamping movement values to int8_t and ignores report_id then returns the resulting report_mouse_t struct.
+ * Combines 2 report_mouse_t structs, scaling the summed movement through the sub-pixel accumulator and clamping it to the
+ * report, and ignores report_id then returns the resulting report_mouse_t struct.
  *
  * NOTE: Only available when using SPLIT_POINTING_ENABLE and POINTING_DEVICE_COMBINED
  *
@@ -419,10 +586,8 @@ static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
  * @return combined report_mouse_t of left_report and right_report
  */
 report_mouse_t pointing_device_combine_reports(report_mouse_t left_report, report_mouse_t right_report) {
-    left_report.x = pointing_device_xy_clamp((clamp_range_t)left_report.x + right_report.x);
-    left_report.y = pointing_device_xy_clamp((clamp_range_t)left_report.y + right_report.y);
-    left_report.h = pointing_device_hv_clamp((int16_t)left_report.h + right_report.h);
-    left_report.v = pointing_device_hv_clamp((int16_t)left_report.v + right_report.v);
+    // Summed before scaling, so that fractions of motion from both sides add up.
+    pointing_device_scale_motion(&left_report, (clamp_range_t)left_report.x + right_report.x, (clamp_range_t)left_report.y + right_report.y, (int16_t)left_report.h + right_report.h, (int16_t)left_report.v + right_report.v);
     left_report.buttons |= right_report.buttons;
     return left_report;
 }
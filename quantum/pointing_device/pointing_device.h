@@ -102,6 +102,30 @@ typedef int32_t clamp_range_t;
 typedef int16_t clamp_range_t;
 #endif
 
+// Motion is scaled in fixed point, with this many fractional bits.
+#define POINTING_DEVICE_FIXED_SHIFT 8
+#define POINTING_DEVICE_FIXED_ONE (1 << POINTING_DEVICE_FIXED_SHIFT)
+
+#ifdef MOUSE_EXTENDED_REPORT
+typedef int64_t pointing_device_fixed_t;
+#else
+typedef int32_t pointing_device_fixed_t;
+#endif
+
+typedef enum {
+    POINTING_DEVICE_AXIS_X,
+    POINTING_DEVICE_AXIS_Y,
+    POINTING_DEVICE_AXIS_H,
+    POINTING_DEVICE_AXIS_V,
+    POINTING_DEVICE_AXIS_COUNT,
+} pointing_device_axis_t;
+
+/* A point on a scaling curve: motion of at least `speed` counts per report is scaled by `gain`, interpolated between points. */
+typedef struct {
+    uint16_t speed;
+    uint16_t gain; // in units of 1/POINTING_DEVICE_FIXED_ONE
+} pointing_device_curve_point_t;
+
 void           pointing_device_init(void);
 bool           pointing_device_task(void);
 bool           pointing_device_send(void);
@@ -118,6 +142,13 @@ uint8_t        pointing_device_handle_buttons(uint8_t buttons, bool pressed, poi
 report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report);
 void           pointing_device_keycode_handler(uint16_t keycode, bool pressed);
 
+void           pointing_device_set_scale(pointing_device_axis_t axis, uint16_t scale);
+uint16_t       pointing_device_get_scale(pointing_device_axis_t axis);
+void           pointing_device_set_curve(const pointing_device_curve_point_t *points, uint8_t count);
+int16_t        pointing_device_get_remainder(pointing_device_axis_t axis);
+void           pointing_device_clear_remainders(void);
+report_mouse_t pointing_device_scale_report(report_mouse_t mouse_report);
+
 #if defined(SPLIT_POINTING_ENABLE)
 void     pointing_device_set_shared_report(report_mouse_t report);
 uint16_t pointing_device_get_shared_cpi(void);
@@ -0,0 +1,119 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "pointing_device_motion.h"
+#include "pointing_device.h"
+#include "timer.h"
+
+#if defined(__AVR__)
+#    include "atomic_util.h"
+#endif
+
+#ifndef POINTING_DEVICE_MOTION_PIN
+#    error POINTING_DEVICE_MOTION_INTERRUPT_ENABLE requires POINTING_DEVICE_MOTION_PIN
+#endif
+
+#ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+#    define MOTION_PIN_ACTIVE_LOW true
+#    define MOTION_PIN_ACTIVE() (!gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
+#else
+#    define MOTION_PIN_ACTIVE_LOW false
+#    define MOTION_PIN_ACTIVE() (gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
+#endif
+
+// Running totals of all motion, only ever written by the producer. The consumer keeps its own totals of what it has
+// taken, and the difference is what is pending. Both wrap around harmlessly.
+static volatile uint32_t motion_added_x = 0;
+static volatile uint32_t motion_added_y = 0;
+static uint32_t          motion_taken_x = 0;
+static uint32_t          motion_taken_y = 0;
+static uint32_t          motion_last_take;
+
+static volatile bool motion_signalled = false;
+static bool          motion_armed     = false;
+
+__attribute__((weak)) bool pointing_device_motion_arm_pin(pin_t pin, bool active_low) {
+    return false;
+}
+
+void pointing_device_motion_init(void) {
+    motion_taken_x   = motion_added_x;
+    motion_taken_y   = motion_added_y;
+    motion_last_take = timer_read32() - POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS;
+    motion_signalled = false;
+    motion_armed     = pointing_device_motion_arm_pin(POINTING_DEVICE_MOTION_PIN, MOTION_PIN_ACTIVE_LOW);
+
+    // The sensor may already have motion waiting, and won't produce another edge until it has been read.
+    pointing_device_motion_acquired();
+}
+
+void pointing_device_motion_signal(void) {
+    motion_signalled = true;
+}
+
+bool pointing_device_motion_pending(void) {
+    if (!motion_armed) {
+        return MOTION_PIN_ACTIVE();
+    }
+
+    // A signal raised between the check and the clear is covered by the read that follows.
+    if (motion_signalled) {
+        motion_signalled = false;
+        return true;
+    }
+    return false;
+}
+
+void pointing_device_motion_acquired(void) {
+    // Motion that arrived during the read keeps the pin active, without another edge to signal it.
+    if (motion_armed && MOTION_PIN_ACTIVE()) {
+        motion_signalled = true;
+    }
+}
+
+void pointing_device_motion_add(int16_t x, int16_t y) {
+    motion_added_x += (uint32_t)(int32_t)x;
+    motion_added_y += (uint32_t)(int32_t)y;
+}
+
+static inline uint32_t motion_load(volatile uint32_t *total) {
+#if defined(__AVR__)
+    // 32-bit loads take several instructions here, so keep an ISR producer out.
+    uint32_t value;
+    ATOMIC_BLOCK_FORCEON {
+        value = *total;
+    }
+    return value;
+#else
+    return *total;
+#endif
+}
+
+static mouse_xy_report_t motion_take_axis(volatile uint32_t *added, uint32_t *taken) {
+    int32_t pending = (int32_t)(motion_load(added) - *taken);
+
+    if (pending < XY_REPORT_MIN) {
+        pending = XY_REPORT_MIN;
+    } else if (pending > XY_REPORT_MAX) {
+        pending = XY_REPORT_MAX;
+    }
+    *taken += (uint32_t)pending;
+    return pending;
+}
+
+bool pointing_device_motion_take(mouse_xy_report_t *x, mouse_xy_report_t *y) {
+    if (timer_elapsed32(motion_last_take) < POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS) {
+        return false;
+    }
+
+    mouse_xy_report_t motion_x = motion_take_axis(&motion_added_x, &motion_taken_x);
+    mouse_xy_report_t motion_y = motion_take_axis(&motion_added_y, &motion_taken_y);
+    if (motion_x == 0 && motion_y == 0) {
+        return false;
+    }
+
+    *x               = motion_x;
+    *y               = motion_y;
+    motion_last_take = timer_read32();
+    return true;
+}
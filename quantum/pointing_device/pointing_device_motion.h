@@ -0,0 +1,83 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+#include "report.h"
+
+/**
+ * \file
+ *
+ * \defgroup pointing_device_motion Motion interrupt driven pointing device acquisition
+ *
+ * With POINTING_DEVICE_MOTION_INTERRUPT_ENABLE, the sensor is only read once its
+ * motion pin has raised an interrupt, rather than on every pass of the main
+ * loop. Deltas are gathered in an accumulator, and a report carrying all of
+ * the motion since the previous one is emitted at most once per USB polling
+ * interval. Reports are never queued up faster than the host collects them,
+ * and motion beyond the range of a single report is carried over to the
+ * next one instead of being clipped.
+ *
+ * Platforms that can raise an interrupt on a pin change implement
+ * pointing_device_motion_arm_pin() and call pointing_device_motion_signal()
+ * from the ISR. Otherwise the motion pin is polled as before.
+ *
+ * The accumulator is lock-free for a single producer, so a driver that
+ * receives sensor data in an interrupt may feed it straight from the ISR with
+ * pointing_device_motion_add(), as long as nothing else adds to it.
+ * \{
+ */
+
+#ifndef POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS USB_POLLING_INTERVAL_MS
+#    else
+#        define POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS 1
+#    endif
+#endif
+
+/**
+ * \brief Enable an interrupt on the motion pin becoming active. Nothing is armed if the pin's interrupt line is
+ * already in use elsewhere.
+ *
+ * \return true if the platform will call pointing_device_motion_signal() on motion, false if the pin needs to be polled.
+ */
+bool pointing_device_motion_arm_pin(pin_t pin, bool active_low);
+
+/**
+ * \brief Arm the motion pin, and clear the accumulator.
+ */
+void pointing_device_motion_init(void);
+
+/**
+ * \brief Notify that the sensor has motion to report. Safe to call from an interrupt.
+ */
+void pointing_device_motion_signal(void);
+
+/**
+ * \brief Check, and clear, whether the sensor should be read.
+ */
+bool pointing_device_motion_pending(void);
+
+/**
+ * \brief Called once the sensor has been read, to catch motion that arrived while it was.
+ */
+void pointing_device_motion_acquired(void);
+
+/**
+ * \brief Add sensor deltas to the accumulator. Safe to call from an interrupt, but only from one context.
+ */
+void pointing_device_motion_add(int16_t x, int16_t y);
+
+/**
+ * \brief Move the accumulated motion into a report, once per report interval.
+ *
+ * As much motion as fits in the report is taken, the rest is left for the next one.
+ *
+ * \return true if the report interval had elapsed and motion was taken.
+ */
+bool pointing_device_motion_take(mouse_xy_report_t *x, mouse_xy_report_t *y);
+
+/** \} */
@@ -0,0 +1,22 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint8_t pin_t;
+
+#define POINTING_DEVICE_MOTION_PIN 4
+#define POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+#define POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern bool motion_pin_level;
+#ifdef __cplusplus
+}
+#endif
+#define gpio_read_pin(pin) motion_pin_level
+#define gpio_set_pin_input_high(pin)
@@ -0,0 +1,126 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "pointing_device_motion.h"
+#include "pointing_device.h"
+#include "timer.h"
+
+void pointing_device_motion_simulate_interrupts_available(bool available);
+void pointing_device_motion_simulate_edge(void);
+void advance_time(uint32_t ms);
+
+// Active low, so high is idle.
+bool motion_pin_level = true;
+}
+
+class PointingDeviceMotion : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        motion_pin_level = true;
+        pointing_device_motion_simulate_interrupts_available(true);
+        pointing_device_motion_init();
+    }
+
+    bool take(mouse_xy_report_t *x, mouse_xy_report_t *y) {
+        return pointing_device_motion_take(x, y);
+    }
+};
+
+TEST_F(PointingDeviceMotion, IdleUntilSignalled) {
+    for (int i = 0; i < 100; i++) {
+        EXPECT_FALSE(pointing_device_motion_pending());
+    }
+
+    pointing_device_motion_simulate_edge();
+    EXPECT_TRUE(pointing_device_motion_pending());
+    // The signal is consumed once seen.
+    EXPECT_FALSE(pointing_device_motion_pending());
+}
+
+TEST_F(PointingDeviceMotion, MotionDuringReadIsNotMissed) {
+    pointing_device_motion_simulate_edge();
+    EXPECT_TRUE(pointing_device_motion_pending());
+
+    // The pin stays active as more motion arrives while the sensor is read, so there's no further edge.
+    motion_pin_level = false;
+    pointing_device_motion_acquired();
+    EXPECT_TRUE(pointing_device_motion_pending());
+
+    motion_pin_level = true;
+    pointing_device_motion_acquired();
+    EXPECT_FALSE(pointing_device_motion_pending());
+}
+
+TEST_F(PointingDeviceMotion, MotionWaitingAtInit) {
+    motion_pin_level = false;
+    pointing_device_motion_init();
+    EXPECT_TRUE(pointing_device_motion_pending());
+}
+
+TEST_F(PointingDeviceMotion, PollsPinWithoutInterrupts) {
+    pointing_device_motion_simulate_interrupts_available(false);
+    pointing_device_motion_init();
+
+    EXPECT_FALSE(pointing_device_motion_pending());
+    motion_pin_level = false;
+    EXPECT_TRUE(pointing_device_motion_pending());
+    EXPECT_TRUE(pointing_device_motion_pending());
+}
+
+TEST_F(PointingDeviceMotion, AccumulatesBetweenReports) {
+    mouse_xy_report_t x = 0, y = 0;
+
+    advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    EXPECT_FALSE(take(&x, &y));
+
+    pointing_device_motion_add(3, -2);
+    EXPECT_TRUE(take(&x, &y));
+    EXPECT_EQ(x, 3);
+    EXPECT_EQ(y, -2);
+
+    // Several sensor reads within one report interval are merged into one report.
+    pointing_device_motion_add(1, 1);
+    pointing_device_motion_add(2, -4);
+    pointing_device_motion_add(-1, 0);
+    EXPECT_FALSE(take(&x, &y));
+
+    advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    EXPECT_TRUE(take(&x, &y));
+    EXPECT_EQ(x, 2);
+    EXPECT_EQ(y, -3);
+
+    advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    EXPECT_FALSE(take(&x, &y));
+}
+
+TEST_F(PointingDeviceMotion, CarriesOverMotionBeyondReportRange) {
+    mouse_xy_report_t x = 0, y = 0;
+    int32_t           total_x = 0, total_y = 0;
+
+    advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    for (int i = 0; i < 5; i++) {
+        pointing_device_motion_add(INT16_MAX, INT16_MIN);
+    }
+
+    while (take(&x, &y)) {
+        EXPECT_GE(x, XY_REPORT_MIN);
+        EXPECT_LE(x, XY_REPORT_MAX);
+        total_x += x;
+        total_y += y;
+        advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    }
+    EXPECT_EQ(total_x, 5 * (int32_t)INT16_MAX);
+    EXPECT_EQ(total_y, 5 * (int32_t)INT16_MIN);
+}
+
+TEST_F(PointingDeviceMotion, OppositeMotionCancelsOut) {
+    mouse_xy_report_t x = 0, y = 0;
+
+    advance_time(POINTING_DEVICE_MOTION_REPORT_INTERVAL_MS);
+    pointing_device_motion_add(10, -7);
+    pointing_device_motion_add(-10, 7);
+    EXPECT_FALSE(take(&x, &y));
+}
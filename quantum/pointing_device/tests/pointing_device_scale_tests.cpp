@@ -0,0 +1,119 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "pointing_device.h"
+
+bool motion_pin_level = true;
+
+extern const pointing_device_driver_t pointing_device_driver = {};
+
+void host_mouse_send(report_mouse_t *report) {}
+
+bool has_mouse_report_changed(report_mouse_t *new_report, report_mouse_t *old_report) {
+    return false;
+}
+}
+
+class PointingDeviceScale : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        for (int axis = 0; axis < POINTING_DEVICE_AXIS_COUNT; axis++) {
+            pointing_device_set_scale((pointing_device_axis_t)axis, POINTING_DEVICE_FIXED_ONE);
+        }
+        pointing_device_set_curve(NULL, 0);
+        pointing_device_clear_remainders();
+    }
+
+    report_mouse_t scale(int16_t x, int16_t y, int8_t h = 0, int8_t v = 0) {
+        report_mouse_t report = {};
+        report.x              = x;
+        report.y              = y;
+        report.h              = h;
+        report.v              = v;
+        return pointing_device_scale_report(report);
+    }
+};
+
+TEST_F(PointingDeviceScale, UnityPassesThrough) {
+    report_mouse_t report = scale(5, -7, 1, -1);
+    EXPECT_EQ(report.x, 5);
+    EXPECT_EQ(report.y, -7);
+    EXPECT_EQ(report.h, 1);
+    EXPECT_EQ(report.v, -1);
+    for (int axis = 0; axis < POINTING_DEVICE_AXIS_COUNT; axis++) {
+        EXPECT_EQ(pointing_device_get_remainder((pointing_device_axis_t)axis), 0);
+    }
+}
+
+TEST_F(PointingDeviceScale, CarriesFractionsOver) {
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_X, POINTING_DEVICE_FIXED_ONE / 2);
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_Y, POINTING_DEVICE_FIXED_ONE / 2);
+
+    report_mouse_t report = scale(1, -1);
+    EXPECT_EQ(report.x, 0);
+    EXPECT_EQ(report.y, 0);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), POINTING_DEVICE_FIXED_ONE / 2);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_Y), -POINTING_DEVICE_FIXED_ONE / 2);
+
+    report = scale(1, -1);
+    EXPECT_EQ(report.x, 1);
+    EXPECT_EQ(report.y, -1);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), 0);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_Y), 0);
+}
+
+TEST_F(PointingDeviceScale, SlowScrollIsNotLost) {
+    // Drag scroll style divide by 8.
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_V, POINTING_DEVICE_FIXED_ONE / 8);
+
+    int total = 0;
+    for (int i = 0; i < 8; i++) {
+        total += scale(0, 0, 0, 1).v;
+    }
+    EXPECT_EQ(total, 1);
+}
+
+TEST_F(PointingDeviceScale, ReversingDirectionCancelsRemainder) {
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_X, POINTING_DEVICE_FIXED_ONE / 4);
+
+    EXPECT_EQ(scale(3, 0).x, 0);
+    EXPECT_EQ(scale(-3, 0).x, 0);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), 0);
+}
+
+TEST_F(PointingDeviceScale, ClampsAfterScaling) {
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_X, 4 * POINTING_DEVICE_FIXED_ONE);
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_H, 4 * POINTING_DEVICE_FIXED_ONE);
+
+    report_mouse_t report = scale(100, 0, 100);
+    EXPECT_EQ(report.x, MIN(400, XY_REPORT_MAX));
+    EXPECT_EQ(report.h, INT8_MAX);
+}
+
+TEST_F(PointingDeviceScale, CurveInterpolatesGain) {
+    static const pointing_device_curve_point_t curve[] = {{0, POINTING_DEVICE_FIXED_ONE / 2}, {10, 2 * POINTING_DEVICE_FIXED_ONE}};
+    pointing_device_set_curve(curve, 2);
+
+    // Halfway along the curve, 5 * 1.25.
+    report_mouse_t report = scale(5, 0);
+    EXPECT_EQ(report.x, 6);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), POINTING_DEVICE_FIXED_ONE / 4);
+
+    // Beyond the last point.
+    EXPECT_EQ(scale(0, -20).y, -40);
+
+    // Scroll is not affected by the curve.
+    EXPECT_EQ(scale(0, 0, 0, 20).v, 20);
+}
+
+TEST_F(PointingDeviceScale, SettingScaleClearsRemainder) {
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_X, POINTING_DEVICE_FIXED_ONE / 2);
+    scale(1, 0);
+    EXPECT_NE(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), 0);
+
+    pointing_device_set_scale(POINTING_DEVICE_AXIS_X, POINTING_DEVICE_FIXED_ONE / 2);
+    EXPECT_EQ(pointing_device_get_remainder(POINTING_DEVICE_AXIS_X), 0);
+}
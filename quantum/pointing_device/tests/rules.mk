@@ -0,0 +1,30 @@
+pointing_device_motion_DEFS := -DPOINTING_DEVICE_MOTION_INTERRUPT_ENABLE
+pointing_device_motion_CONFIG := $(QUANTUM_PATH)/pointing_device/tests/config_mock.h
+
+pointing_device_motion_SRC := \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_motion_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/pointing_device_motion.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_motion.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+pointing_device_motion_INC := $(QUANTUM_PATH)/pointing_device
+
+pointing_device_motion_extended_DEFS := $(pointing_device_motion_DEFS) -DMOUSE_EXTENDED_REPORT
+pointing_device_motion_extended_CONFIG := $(pointing_device_motion_CONFIG)
+pointing_device_motion_extended_SRC := $(pointing_device_motion_SRC)
+pointing_device_motion_extended_INC := $(pointing_device_motion_INC)
+
+pointing_device_scale_DEFS := -DPOINTING_DEVICE_ENABLE -DMOUSE_ENABLE
+pointing_device_scale_CONFIG := $(QUANTUM_PATH)/pointing_device/tests/config_mock.h
+
+pointing_device_scale_SRC := \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_scale_tests.cpp \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+pointing_device_scale_INC := $(QUANTUM_PATH)/pointing_device
+
+pointing_device_scale_extended_DEFS := $(pointing_device_scale_DEFS) -DMOUSE_EXTENDED_REPORT
+pointing_device_scale_extended_CONFIG := $(pointing_device_scale_CONFIG)
+pointing_device_scale_extended_SRC := $(pointing_device_scale_SRC)
+pointing_device_scale_extended_INC := $(pointing_device_scale_INC)
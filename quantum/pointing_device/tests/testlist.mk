@@ -0,0 +1 @@
+TEST_LIST += pointing_device_motion pointing_device_motion_extended pointing_device_scale pointing_device_scale_extended
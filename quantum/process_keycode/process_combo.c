@@ -26,6 +26,8 @@
 #include "action_tapping.h"
 #include "action_util.h"
 #include "keymap_introspection.h"
+#include "debug.h"
+#include "tracing.h"
 
 __attribute__((weak)) void process_combo_event(uint16_t combo_index, bool pressed) {}
 
@@ -94,6 +96,30 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+#    ifndef COMBO_DIRTY_BUFFER_LENGTH
+#        define COMBO_DIRTY_BUFFER_LENGTH 16
+#    endif
+
+/* Keycode -> combo lookup table, sorted by keycode then combo index, so that
+ * a key event only has to visit the combos that contain its keycode. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_index_entry_t;
+static combo_index_entry_t combo_keycode_index[COMBO_KEYCODE_INDEX_SIZE];
+static uint16_t            combo_keycode_index_length = 0;
+static bool                combo_keycode_index_built  = false;
+static bool                combo_keycode_index_full   = false;
+
+/* Keycodes processed since the last clear_combos(); only combos containing
+ * one of these can have any state to reset. If this overflows, clear_combos()
+ * falls back to visiting every combo. */
+static uint16_t combo_dirty_keycodes[COMBO_DIRTY_BUFFER_LENGTH];
+static uint8_t  combo_dirty_keycodes_size     = 0;
+static bool     combo_dirty_keycodes_overflow = true;
+#endif
+
 #ifndef EXTRA_SHORT_COMBOS
 /* flags are their own elements in combo_t struct. */
 #    define COMBO_ACTIVE(combo) (combo->active)
@@ -191,14 +217,137 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
     return COMBO_TERM;
 }
 
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+static inline bool combo_index_entry_less(const combo_index_entry_t *a, const combo_index_entry_t *b) {
+    return a->keycode < b->keycode || (a->keycode == b->keycode && a->combo_index < b->combo_index);
+}
+
+static void combo_keycode_index_build(void) {
+    uint16_t length = 0;
+
+    combo_keycode_index_built = true;
+    combo_keycode_index_full  = false;
+
+    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+        combo_t *combo = combo_get(idx);
+        uint16_t key;
+        for (uint8_t i = 0; (key = pgm_read_word(&combo->keys[i])) != COMBO_END; ++i) {
+            if (length == COMBO_KEYCODE_INDEX_SIZE) {
+                dprintf("COMBO_KEYCODE_INDEX_SIZE too small, falling back to scanning all combos\n");
+                combo_keycode_index_full = true;
+                return;
+            }
+            combo_keycode_index[length++] = (combo_index_entry_t){.keycode = key, .combo_index = idx};
+        }
+    }
+
+    // Shell sort, no recursion and no extra memory.
+    for (uint16_t gap = length / 2; gap > 0; gap /= 2) {
+        for (uint16_t i = gap; i < length; ++i) {
+            combo_index_entry_t entry = combo_keycode_index[i];
+            uint16_t            j     = i;
+            for (; j >= gap && combo_index_entry_less(&entry, &combo_keycode_index[j - gap]); j -= gap) {
+                combo_keycode_index[j] = combo_keycode_index[j - gap];
+            }
+            combo_keycode_index[j] = entry;
+        }
+    }
+
+    // Drop duplicates, in case a combo lists the same keycode twice.
+    uint16_t unique = 0;
+    for (uint16_t i = 0; i < length; ++i) {
+        if (unique == 0 || combo_index_entry_less(&combo_keycode_index[unique - 1], &combo_keycode_index[i])) {
+            combo_keycode_index[unique++] = combo_keycode_index[i];
+        }
+    }
+    combo_keycode_index_length = unique;
+}
+
+static inline bool combo_keycode_index_ready(void) {
+    if (!combo_keycode_index_built) {
+        combo_keycode_index_build();
+    }
+    return !combo_keycode_index_full;
+}
+
+/* Returns the position of the first index entry for keycode, if any. */
+static uint16_t combo_keycode_index_find(uint16_t keycode) {
+    uint16_t low = 0, high = combo_keycode_index_length;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_keycode_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void combo_mark_dirty(uint16_t keycode) {
+    if (combo_dirty_keycodes_overflow) {
+        return;
+    }
+    for (uint8_t i = 0; i < combo_dirty_keycodes_size; ++i) {
+        if (combo_dirty_keycodes[i] == keycode) {
+            return;
+        }
+    }
+    if (combo_dirty_keycodes_size < COMBO_DIRTY_BUFFER_LENGTH) {
+        combo_dirty_keycodes[combo_dirty_keycodes_size++] = keycode;
+    } else {
+        combo_dirty_keycodes_overflow = true;
+    }
+}
+
+void combo_keycode_index_invalidate(void) {
+    combo_keycode_index_built     = false;
+    combo_dirty_keycodes_overflow = true;
+}
+#endif
+
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+    if (!combo_dirty_keycodes_overflow && combo_keycode_index_ready()) {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < combo_dirty_keycodes_size; ++i) {
+            uint16_t keycode     = combo_dirty_keycodes[i];
+            bool     still_dirty = false;
+            for (uint16_t j = combo_keycode_index_find(keycode); j < combo_keycode_index_length && combo_keycode_index[j].keycode == keycode; ++j) {
+                combo_t *combo = combo_get(combo_keycode_index[j].combo_index);
+                if (!COMBO_ACTIVE(combo)) {
+                    RESET_COMBO_STATE(combo);
+                } else {
+                    still_dirty = true;
+                }
+            }
+            if (still_dirty) {
+                combo_dirty_keycodes[kept++] = keycode;
+            }
+        }
+        combo_dirty_keycodes_size = kept;
+        return;
+    }
+    combo_dirty_keycodes_size     = 0;
+    combo_dirty_keycodes_overflow = false;
+#endif
+
     for (index = 0; index < combo_count(); ++index) {
         combo_t *combo = combo_get(index);
         if (!COMBO_ACTIVE(combo)) {
             RESET_COMBO_STATE(combo);
         }
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+        else {
+            uint16_t key;
+            for (uint8_t i = 0; (key = pgm_read_word(&combo->keys[i])) != COMBO_END; ++i) {
+                combo_mark_dirty(key);
+            }
+        }
+#endif
     }
 }
 
@@ -227,9 +376,9 @@ static inline void dump_key_buffer(void) {
             process_combo_event(qrecord->combo_index, true);
         } else {
 #ifndef NO_ACTION_TAPPING
-            action_tapping_process(*record);
+            TRACE_LATENCY_HOLD(TRACE_LATENCY_COMBO, action_tapping_process(*record));
 #else
-            process_record(record);
+            TRACE_LATENCY_HOLD(TRACE_LATENCY_COMBO, process_record(record));
 #endif
         }
         record->event.type = TICK_EVENT;
@@ -564,10 +713,24 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+    if (combo_keycode_index_ready()) {
+        uint16_t i = combo_keycode_index_find(keycode);
+        if (i < combo_keycode_index_length && combo_keycode_index[i].keycode == keycode) {
+            combo_mark_dirty(keycode);
+        }
+        for (; i < combo_keycode_index_length && combo_keycode_index[i].keycode == keycode; ++i) {
+            uint16_t idx = combo_keycode_index[i].combo_index;
+            is_combo_key |= process_single_combo(combo_get(idx), keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+            combo_t *combo = combo_get(idx);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
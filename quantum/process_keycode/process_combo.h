@@ -81,3 +81,11 @@ void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
 bool is_combo_enabled(void);
+
+#ifdef COMBO_KEYCODE_INDEX_SIZE
+/* Rebuild the keycode -> combo index on the next key event. Call this after
+ * changing the combos returned by combo_count()/combo_get() at runtime. */
+void combo_keycode_index_invalidate(void);
+#else
+#    define combo_keycode_index_invalidate()
+#endif
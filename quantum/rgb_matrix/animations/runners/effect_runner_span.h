@@ -0,0 +1,33 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#ifndef RGB_MATRIX_HSV_BATCH_SIZE
+#    define RGB_MATRIX_HSV_BATCH_SIZE 16
+#endif
+
+// Collects the colors computed by a runner so they can be converted to RGB in batches.
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_HSV_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_BATCH_SIZE];
+} effect_span_t;
+
+static void effect_span_flush(effect_span_t* span) {
+    RGB rgb[RGB_MATRIX_HSV_BATCH_SIZE];
+
+    rgb_matrix_hsv_to_rgb_batch(span->hsv, rgb, span->count);
+    for (uint8_t n = 0; n < span->count; n++) {
+        rgb_matrix_set_color(span->index[n], rgb[n].r, rgb[n].g, rgb[n].b);
+    }
+    span->count = 0;
+}
+
+static inline void effect_span_push(effect_span_t* span, uint8_t i, HSV hsv) {
+    span->index[span->count] = i;
+    span->hsv[span->count]   = hsv;
+    if (++span->count == RGB_MATRIX_HSV_BATCH_SIZE) {
+        effect_span_flush(span);
+    }
+}
@@ -23,6 +23,7 @@
 #include "keyboard.h"
 #include "sync_timer.h"
 #include "debug.h"
+#include "util.h"
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -39,6 +40,11 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
 
+// If rgb_matrix_hsv_to_rgb() is overridden, this should be overridden to match.
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint16_t count) {
+    hsv_to_rgb_batch(hsv, rgb, count);
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -88,6 +94,32 @@ static last_hit_t last_hit_buffer;
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    include "timer.h"
+#    if defined(PROTOCOL_CHIBIOS)
+#        include <ch.h>
+typedef systime_t rgb_render_time_t;
+#        define RGB_RENDER_TIME_NOW() chVTGetSystemTimeX()
+#        define RGB_RENDER_ELAPSED_US(start) ((uint32_t)TIME_I2US(chTimeDiffX((start), chVTGetSystemTimeX())))
+#    else
+// Millisecond resolution only, so most slices measure zero and samples are pooled until the clock has ticked.
+typedef uint32_t rgb_render_time_t;
+#        define RGB_RENDER_TIME_NOW() timer_read32()
+#        define RGB_RENDER_ELAPSED_US(start) (timer_elapsed32(start) * 1000)
+#    endif
+
+// adaptive renderer
+static struct rgb_matrix_limits_t rgb_render_limits;
+static uint32_t                   rgb_render_cost_q8    = 0; // microseconds per LED, 24.8 fixed point
+static bool                       rgb_render_cost_known = false;
+static uint32_t                   rgb_render_sample_us;
+static uint16_t                   rgb_render_sample_leds;
+static uint32_t                   rgb_render_worst_stall_us;
+static uint16_t                   rgb_render_frames;
+static uint16_t                   rgb_render_fps;
+static uint32_t                   rgb_render_fps_timer;
+#endif
+
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, EECONFIG_RGB_MATRIX, rgb_matrix_config);
 
 void eeconfig_update_rgb_matrix(void) {
@@ -278,6 +310,66 @@ static void rgb_task_start(void) {
     rgb_task_state = RENDERING;
 }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static uint8_t rgb_render_plan_slice(void) {
+    // Continue from where the previous slice of this frame ended.
+    uint8_t led_min = rgb_effect_params.iter == 0 ? 0 : rgb_render_limits.led_max_index;
+    uint8_t led_end = RGB_MATRIX_LED_COUNT;
+#    if defined(RGB_MATRIX_SPLIT)
+    if (is_keyboard_left()) {
+        led_end = MIN(led_end, k_rgb_matrix_split[0]);
+    } else {
+        led_min = MAX(led_min, k_rgb_matrix_split[0]);
+    }
+#    endif
+
+    uint32_t size = RGB_MATRIX_LED_PROCESS_LIMIT;
+    if (rgb_render_cost_known) {
+        size = rgb_render_cost_q8 ? ((uint32_t)RGB_MATRIX_RENDER_BUDGET_US << 8) / rgb_render_cost_q8 : RGB_MATRIX_LED_COUNT;
+    }
+    size = MAX(size, 1);
+
+    rgb_render_limits.led_min_index = led_min;
+    rgb_render_limits.led_max_index = MIN(led_min + size, led_end);
+    return rgb_render_limits.led_max_index > led_min ? rgb_render_limits.led_max_index - led_min : 0;
+}
+
+static void rgb_render_record_slice(uint8_t slice, uint32_t elapsed_us) {
+    // Init frames do one-off work that says nothing about the steady state cost.
+    if (slice == 0 || rgb_effect_params.init) {
+        return;
+    }
+    // Slices that are shorter than the clock resolution mostly measure zero, with the odd one that straddles a tick
+    // measuring a whole tick. Pool them until the clock has moved, so the average over the pool is still right.
+    rgb_render_sample_us += elapsed_us;
+    rgb_render_sample_leds += slice;
+    if (rgb_render_sample_us == 0 && rgb_render_sample_leds < UINT16_MAX - UINT8_MAX) {
+        return;
+    }
+    uint32_t cost          = (rgb_render_sample_us << 8) / rgb_render_sample_leds;
+    rgb_render_sample_us   = 0;
+    rgb_render_sample_leds = 0;
+    // Exponential moving average, weighted 3:1 towards history.
+    rgb_render_cost_q8    = rgb_render_cost_known ? (rgb_render_cost_q8 * 3 + cost) / 4 : cost;
+    rgb_render_cost_known = true;
+}
+
+uint16_t rgb_matrix_get_render_fps(void) {
+    return rgb_render_fps;
+}
+
+uint32_t rgb_matrix_get_render_worst_stall_us(void) {
+    return rgb_render_worst_stall_us;
+}
+
+void rgb_matrix_reset_render_stats(void) {
+    rgb_render_worst_stall_us = 0;
+    rgb_render_frames         = 0;
+    rgb_render_fps            = 0;
+    rgb_render_fps_timer      = timer_read32();
+}
+#endif
+
 static void rgb_task_render(uint8_t effect) {
     bool rendering         = false;
     rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
@@ -286,6 +378,17 @@ static void rgb_task_render(uint8_t effect) {
         rgb_matrix_set_color_all(0, 0, 0);
     }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    if (rgb_effect_params.init) {
+        // New effect, its cost has to be learned again.
+        rgb_render_cost_known  = false;
+        rgb_render_sample_us   = 0;
+        rgb_render_sample_leds = 0;
+    }
+    uint8_t           slice        = rgb_render_plan_slice();
+    rgb_render_time_t render_start = RGB_RENDER_TIME_NOW();
+#endif
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
@@ -326,6 +429,10 @@ static void rgb_task_render(uint8_t effect) {
             return;
     }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_render_record_slice(slice, RGB_RENDER_ELAPSED_US(render_start));
+#endif
+
     rgb_effect_params.iter++;
 
     // next task
@@ -346,11 +453,18 @@ static void rgb_task_flush(uint8_t effect) {
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_render_frames++;
+#endif
+
     // next task
     rgb_task_state = SYNCING;
 }
 
 void rgb_matrix_task(void) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_render_time_t task_start = RGB_RENDER_TIME_NOW();
+#endif
     rgb_task_timers();
 
     // Ideally we would also stop sending zeros to the LED driver PWM buffers
@@ -383,6 +497,20 @@ void rgb_matrix_task(void) {
             rgb_task_sync();
             break;
     }
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    uint32_t stall = RGB_RENDER_ELAPSED_US(task_start);
+    if (stall > rgb_render_worst_stall_us) {
+        rgb_render_worst_stall_us = stall;
+    }
+
+    uint32_t window = timer_elapsed32(rgb_render_fps_timer);
+    if (window >= 1000) {
+        rgb_render_fps       = (uint32_t)rgb_render_frames * 1000 / window;
+        rgb_render_frames    = 0;
+        rgb_render_fps_timer = timer_read32();
+    }
+#endif
 }
 
 void rgb_matrix_indicators(void) {
@@ -397,7 +525,12 @@ __attribute__((weak)) bool rgb_matrix_indicators_user(void) {
     return true;
 }
 
-struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter) {
+struct rgb_matrix_limits_t rgb_matrix_get_limits(uint16_t iter) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // The adaptive renderer sizes each slice before running the effect.
+    (void)iter;
+    return rgb_render_limits;
+#endif
     struct rgb_matrix_limits_t limits = {0};
 #if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
 #    if defined(RGB_MATRIX_SPLIT)
@@ -460,6 +593,10 @@ void rgb_matrix_init(void) {
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_matrix_reset_render_stats();
+#endif
+
     eeconfig_init_rgb_matrix();
     if (!rgb_matrix_config.mode) {
         dprintf("rgb_matrix_init_drivers rgb_matrix_config.mode = 0. Write default values to EEPROM.\n");
@@ -473,6 +610,18 @@ void rgb_matrix_set_suspend_state(bool state) {
     if (state && !suspend_state) { // only run if turning off, and only once
         rgb_task_render(0);        // turn off all LEDs when suspending
         rgb_task_flush(0);         // and actually flash led state to LEDs
+#    ifdef RGB_MATRIX_WS2812
+        // The flush is skipped while a frame is still being sent, and nothing retries it while suspended.
+        // If the previous frame never finishes, send anyway and let the driver abort it.
+        uint16_t start = timer_read();
+        while (ws2812_is_busy() && timer_elapsed(start) < RGB_MATRIX_SUSPEND_TIMEOUT) {
+        }
+        if (ws2812_is_busy()) {
+            ws2812_setleds(rgb_matrix_ws2812_array, WS2812_LED_COUNT);
+        } else {
+            rgb_matrix_update_pwm_buffers();
+        }
+#    endif
     }
     suspend_state = state;
 #endif
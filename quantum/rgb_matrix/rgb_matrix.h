@@ -86,6 +86,11 @@
 #    define RGB_MATRIX_LED_FLUSH_LIMIT 16
 #endif
 
+// Longest wait for the previous frame when suspending, in milliseconds, before sending anyway
+#ifndef RGB_MATRIX_SUSPEND_TIMEOUT
+#    define RGB_MATRIX_SUSPEND_TIMEOUT 100
+#endif
+
 #ifndef RGB_MATRIX_LED_PROCESS_LIMIT
 #    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
 #endif
@@ -95,7 +100,7 @@ struct rgb_matrix_limits_t {
     uint8_t led_max_index;
 };
 
-struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter);
+struct rgb_matrix_limits_t rgb_matrix_get_limits(uint16_t iter);
 
 #define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter)                   \
     struct rgb_matrix_limits_t limits = rgb_matrix_get_limits(iter); \
@@ -211,6 +216,12 @@ led_flags_t rgb_matrix_get_flags(void);
 void        rgb_matrix_set_flags(led_flags_t flags);
 void        rgb_matrix_set_flags_noeeprom(led_flags_t flags);
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+uint16_t rgb_matrix_get_render_fps(void);
+uint32_t rgb_matrix_get_render_worst_stall_us(void);
+void     rgb_matrix_reset_render_stats(void);
+#endif
+
 #ifndef RGBLIGHT_ENABLE
 #    define eeconfig_update_rgblight_current eeconfig_update_rgb_matrix
 #    define rgblight_reload_from_eeprom rgb_matrix_reload_from_eeprom
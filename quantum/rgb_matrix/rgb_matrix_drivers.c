@@ -156,8 +156,14 @@ static void init(void) {
 }
 
 static void flush(void) {
+#    if defined(WS2812_SPI_DOUBLE_BUFFER)
+    // The next frame is encoded into the spare buffer while the previous one is still going out, so never skip it.
     if (ws2812_dirty) {
-        ws2812_setleds(rgb_matrix_ws2812_array, WS2812_LED_COUNT);
+#    else
+    // While the previous frame is still going out, leave this one dirty for the next flush rather than wait.
+    if (ws2812_dirty && !ws2812_is_busy()) {
+#    endif
+        ws2812_setleds_async(rgb_matrix_ws2812_array, WS2812_LED_COUNT);
         ws2812_dirty = false;
     }
 }
@@ -49,3 +49,7 @@ typedef struct {
 } rgb_matrix_driver_t;
 
 extern const rgb_matrix_driver_t rgb_matrix_driver;
+
+#if defined(RGB_MATRIX_WS2812)
+extern rgb_led_t rgb_matrix_ws2812_array[WS2812_LED_COUNT];
+#endif
@@ -45,7 +45,7 @@ typedef enum rgb_task_states { STARTING, RENDERING, FLUSHING, SYNCING } rgb_task
 typedef uint8_t led_flags_t;
 
 typedef struct PACKED {
-    uint8_t     iter;
+    uint16_t    iter;
     led_flags_t flags;
     bool        init;
 } effect_params_t;
@@ -126,6 +126,11 @@ rgblight_segment_t const *const *rgblight_layers = NULL;
 static bool deferred_set_layer_state = false;
 #endif
 
+// Set when rgblight_set() found the driver still busy with the previous frame, so rgblight_task() sends it instead.
+static bool deferred_set = false;
+
+static void rgblight_send(void);
+
 rgblight_ranges_t rgblight_ranges = {0, RGBLIGHT_LED_COUNT, 0, RGBLIGHT_LED_COUNT, RGBLIGHT_LED_COUNT};
 
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds) {
@@ -875,6 +880,17 @@ void rgblight_suspend(void) {
 #    endif
 
         rgblight_disable_noeeprom();
+
+        // Nothing retries a deferred update while suspended.
+        // If the previous frame never finishes, send anyway and let the driver abort it.
+        uint16_t start = timer_read();
+        while (deferred_set && timer_elapsed(start) < RGBLIGHT_SUSPEND_TIMEOUT) {
+            rgblight_set();
+        }
+        if (deferred_set) {
+            deferred_set = false;
+            rgblight_send();
+        }
     }
 }
 
@@ -897,6 +913,15 @@ void rgblight_wakeup(void) {
 #endif
 
 void rgblight_set(void) {
+    if (rgblight_driver.is_busy && rgblight_driver.is_busy()) {
+        deferred_set = true;
+        return;
+    }
+    deferred_set = false;
+    rgblight_send();
+}
+
+static void rgblight_send(void) {
     rgb_led_t *start_led;
     uint8_t    num_leds = rgblight_ranges.clipping_num_leds;
 
@@ -1525,6 +1550,10 @@ void rgblight_task(void) {
     rgblight_timer_task();
 #endif
 
+    if (deferred_set) {
+        rgblight_set();
+    }
+
 #ifdef VELOCIKEY_ENABLE
     if (rgblight_velocikey_enabled()) {
         rgblight_velocikey_decelerate();
@@ -151,6 +151,11 @@ enum RGBLIGHT_EFFECT_MODE {
 #    define RGBLIGHT_EFFECT_TWINKLE_PROBABILITY 1 / 127
 #endif
 
+// Longest wait for the previous frame when suspending, in milliseconds, before sending anyway
+#ifndef RGBLIGHT_SUSPEND_TIMEOUT
+#    define RGBLIGHT_SUSPEND_TIMEOUT 100
+#endif
+
 #ifndef RGBLIGHT_HUE_STEP
 #    define RGBLIGHT_HUE_STEP 8
 #endif
@@ -8,7 +8,11 @@
 
 const rgblight_driver_t rgblight_driver = {
     .init    = ws2812_init,
-    .setleds = ws2812_setleds,
+    .setleds = ws2812_setleds_async,
+#    if !defined(WS2812_SPI_DOUBLE_BUFFER)
+    // A double-buffered driver encodes into the spare buffer while busy, so frames are never deferred for it.
+    .is_busy = ws2812_is_busy,
+#    endif
 };
 
 #elif defined(RGBLIGHT_APA102)
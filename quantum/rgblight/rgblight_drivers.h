@@ -4,11 +4,14 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "color.h"
 
 typedef struct {
     void (*init)(void);
     void (*setleds)(rgb_led_t *ledarray, uint16_t number_of_leds);
+    // Optional, whether the previous setleds is still in progress.
+    bool (*is_busy)(void);
 } rgblight_driver_t;
 
 extern const rgblight_driver_t rgblight_driver;
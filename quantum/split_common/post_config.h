@@ -8,3 +8,8 @@
 #        define F_SCL 100000UL // SCL frequency
 #    endif
 #endif
+
+// The speed negotiator works off the link statistics.
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE) && !defined(SPLIT_LINK_STATS_ENABLE)
+#    define SPLIT_LINK_STATS_ENABLE
+#endif
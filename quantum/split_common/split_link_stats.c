@@ -0,0 +1,257 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "split_link_stats.h"
+#include "transaction_id_define.h"
+#include "timer.h"
+#include "debug.h"
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+#    include "serial.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+typedef systime_t split_link_time_t;
+#    define SPLIT_LINK_TIME_NOW() chVTGetSystemTimeX()
+#    define SPLIT_LINK_ELAPSED_US(start) ((uint32_t)TIME_I2US(chTimeDiffX((start), chVTGetSystemTimeX())))
+#else
+// Millisecond resolution only.
+typedef uint32_t split_link_time_t;
+#    define SPLIT_LINK_TIME_NOW() timer_read32()
+#    define SPLIT_LINK_ELAPSED_US(start) (timer_elapsed32(start) * 1000)
+#endif
+
+static split_link_stats_t  link_stats[NUM_TOTAL_TRANSACTIONS];
+static uint8_t             link_failed[(NUM_TOTAL_TRANSACTIONS + 7) / 8];
+static split_link_time_t   link_start;
+static split_link_status_t link_error;
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+static void speed_record(bool okay);
+#endif
+
+static inline void saturating_inc(uint16_t *counter) {
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+}
+
+void split_link_stats_begin(void) {
+    link_error = SPLIT_LINK_TIMEOUT;
+    link_start = SPLIT_LINK_TIME_NOW();
+}
+
+void split_link_stats_error(split_link_status_t status) {
+    link_error = status;
+}
+
+void split_link_stats_end(int8_t id, bool okay) {
+    if (id < 0 || id >= NUM_TOTAL_TRANSACTIONS) {
+        return;
+    }
+
+    split_link_stats_t *stats = &link_stats[id];
+    uint8_t             mask  = 1 << (id % 8);
+
+    // Any attempt following a failure of the same transaction is a retry.
+    if (link_failed[id / 8] & mask) {
+        saturating_inc(&stats->retry);
+    }
+
+    if (okay) {
+        uint32_t rtt = SPLIT_LINK_ELAPSED_US(link_start);
+        if (rtt > UINT16_MAX) {
+            rtt = UINT16_MAX;
+        }
+        stats->rtt_last_us = rtt;
+        if (rtt > stats->rtt_max_us) {
+            stats->rtt_max_us = rtt;
+        }
+        // Exponential moving average over roughly the last 8 transactions.
+        if (stats->success == 0) {
+            stats->rtt_avg_us = rtt;
+        } else {
+            stats->rtt_avg_us = (int32_t)stats->rtt_avg_us + ((int32_t)rtt - (int32_t)stats->rtt_avg_us) / 8;
+        }
+        saturating_inc(&stats->success);
+        link_failed[id / 8] &= ~mask;
+    } else {
+        saturating_inc(link_error == SPLIT_LINK_CRC_ERROR ? &stats->crc_error : &stats->timeout);
+        link_failed[id / 8] |= mask;
+    }
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+    speed_record(okay);
+#endif
+}
+
+const split_link_stats_t *split_link_stats_get(int8_t id) {
+    if (id < 0 || id >= NUM_TOTAL_TRANSACTIONS) {
+        return NULL;
+    }
+    return &link_stats[id];
+}
+
+static inline uint16_t saturating_add(uint16_t a, uint16_t b) {
+    return (uint32_t)a + b > UINT16_MAX ? UINT16_MAX : a + b;
+}
+
+void split_link_stats_total(split_link_stats_t *total) {
+    uint32_t rtt_sum   = 0;
+    uint32_t rtt_count = 0;
+
+    memset(total, 0, sizeof(*total));
+    for (uint8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        split_link_stats_t *stats = &link_stats[id];
+        total->success            = saturating_add(total->success, stats->success);
+        total->retry              = saturating_add(total->retry, stats->retry);
+        total->timeout            = saturating_add(total->timeout, stats->timeout);
+        total->crc_error          = saturating_add(total->crc_error, stats->crc_error);
+        if (stats->success) {
+            rtt_sum += (uint32_t)stats->rtt_avg_us * stats->success;
+            rtt_count += stats->success;
+            if (stats->rtt_max_us > total->rtt_max_us) {
+                total->rtt_max_us = stats->rtt_max_us;
+            }
+        }
+    }
+    if (rtt_count) {
+        total->rtt_avg_us = rtt_sum / rtt_count;
+    }
+}
+
+void split_link_stats_reset(void) {
+    memset(link_stats, 0, sizeof(link_stats));
+    memset(link_failed, 0, sizeof(link_failed));
+}
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
+#    if !defined(SERIAL_DRIVER_USART) && !defined(SERIAL_DRIVER_VENDOR)
+#        error SPLIT_SPEED_NEGOTIATION_ENABLE requires the usart or vendor serial driver
+#    endif
+
+typedef struct {
+    uint8_t  level;
+    uint8_t  ceiling;    // highest level that may be tried
+    uint8_t  errors;     // failed transactions in the current window
+    uint16_t window;     // transactions in the current window
+    uint16_t clean;      // consecutive successful transactions
+    uint32_t changed;    // when the level last changed
+    uint32_t backed_off; // when the ceiling was last lowered
+} speed_master_t;
+
+typedef struct {
+    uint8_t  level;
+    bool     sync_pending; // an announced level has yet to be followed
+    uint32_t synced;       // when the master last announced a level
+} speed_slave_t;
+
+static speed_master_t speed_master = {.ceiling = SPLIT_SPEED_NEGOTIATION_STEPS};
+static speed_slave_t  speed_slave;
+
+static void speed_master_apply(uint8_t level) {
+    dprintf("SPLIT: link speed level %u\n", level);
+    speed_master.level   = level;
+    speed_master.errors  = 0;
+    speed_master.window  = 0;
+    speed_master.clean   = 0;
+    speed_master.changed = timer_read32();
+    soft_serial_set_speed_level(level);
+}
+
+static void speed_slave_apply(uint8_t level) {
+    dprintf("SPLIT: link speed level %u\n", level);
+    speed_slave.level = level;
+    soft_serial_set_speed_level(level);
+}
+
+static void speed_record(bool okay) {
+    // The slave may not have followed a change yet.
+    if (timer_elapsed32(speed_master.changed) < SPLIT_SPEED_NEGOTIATION_SETTLE_MS) {
+        return;
+    }
+
+    if (okay) {
+        if (speed_master.clean < UINT16_MAX) {
+            speed_master.clean++;
+        }
+    } else {
+        if (speed_master.errors < UINT8_MAX) {
+            speed_master.errors++;
+        }
+        speed_master.clean = 0;
+    }
+    if (++speed_master.window >= SPLIT_SPEED_NEGOTIATION_PROBE) {
+        speed_master.window = 0;
+        speed_master.errors = 0;
+    }
+}
+
+uint8_t split_link_speed_level(void) {
+    return speed_master.level;
+}
+
+uint8_t split_link_speed_target(void) {
+    if (speed_master.ceiling < SPLIT_SPEED_NEGOTIATION_STEPS && timer_elapsed32(speed_master.backed_off) >= SPLIT_SPEED_NEGOTIATION_BACKOFF) {
+        speed_master.ceiling = SPLIT_SPEED_NEGOTIATION_STEPS;
+    }
+
+    if (speed_master.level > 0 && speed_master.errors >= SPLIT_SPEED_NEGOTIATION_MAX_ERRORS) {
+        return speed_master.level - 1;
+    }
+    if (speed_master.level < speed_master.ceiling && speed_master.clean >= SPLIT_SPEED_NEGOTIATION_PROBE) {
+        return speed_master.level + 1;
+    }
+    return speed_master.level;
+}
+
+void split_link_speed_announced(uint8_t level, bool okay) {
+    if (level == speed_master.level) {
+        return;
+    }
+
+    if (level < speed_master.level) {
+        speed_master.ceiling    = level;
+        speed_master.backed_off = timer_read32();
+        // If the slave can't even be told, fall back to the configured speed. The slave does the same once it stops hearing from us.
+        speed_master_apply(okay ? level : 0);
+    } else if (okay) {
+        speed_master_apply(level);
+    }
+}
+
+void split_link_speed_reset(void) {
+    bool changed = speed_master.level != 0 || speed_slave.level != 0;
+
+    speed_master = (speed_master_t){.ceiling = SPLIT_SPEED_NEGOTIATION_STEPS};
+    speed_slave  = (speed_slave_t){0};
+    if (changed) {
+        soft_serial_set_speed_level(0);
+    }
+}
+
+void split_link_speed_slave_sync(void) {
+    speed_slave.synced       = timer_read32();
+    speed_slave.sync_pending = true;
+}
+
+void split_link_speed_slave_task(uint8_t level) {
+    if (speed_slave.sync_pending) {
+        // Give the reply to the announcement time to leave at the old speed.
+        if (level != speed_slave.level && timer_elapsed32(speed_slave.synced) < 2) {
+            return;
+        }
+        speed_slave.sync_pending = false;
+        if (level != speed_slave.level && level <= SPLIT_SPEED_NEGOTIATION_STEPS) {
+            speed_slave_apply(level);
+        }
+    } else if (speed_slave.level > 0 && timer_elapsed32(speed_slave.synced) >= SPLIT_SPEED_NEGOTIATION_TIMEOUT) {
+        speed_slave_apply(0);
+    }
+}
+
+#endif // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
@@ -0,0 +1,120 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \file
+ *
+ * Split link statistics, gathered on the master for every transaction.
+ *
+ * With SPLIT_SPEED_NEGOTIATION_ENABLE, the statistics also drive a negotiator
+ * that steps the serial link up through faster speeds while it stays error
+ * free, and back down again when it gets noisy.
+ */
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+// Speed levels above the configured speed, each doubling it.
+#    ifndef SPLIT_SPEED_NEGOTIATION_STEPS
+#        define SPLIT_SPEED_NEGOTIATION_STEPS 3
+#    endif
+// Error-free transactions required before trying the next speed level.
+#    ifndef SPLIT_SPEED_NEGOTIATION_PROBE
+#        define SPLIT_SPEED_NEGOTIATION_PROBE 1000
+#    endif
+// Failed transactions within SPLIT_SPEED_NEGOTIATION_PROBE transactions that cause a step down.
+#    ifndef SPLIT_SPEED_NEGOTIATION_MAX_ERRORS
+#        define SPLIT_SPEED_NEGOTIATION_MAX_ERRORS 4
+#    endif
+// Time after a speed change in which errors are ignored, while the slave follows.
+#    ifndef SPLIT_SPEED_NEGOTIATION_SETTLE_MS
+#        define SPLIT_SPEED_NEGOTIATION_SETTLE_MS 20
+#    endif
+// Time without hearing from the master after which the slave falls back to the configured speed.
+#    ifndef SPLIT_SPEED_NEGOTIATION_TIMEOUT
+#        define SPLIT_SPEED_NEGOTIATION_TIMEOUT 250
+#    endif
+// Time before a speed level that had to be left is tried again.
+#    ifndef SPLIT_SPEED_NEGOTIATION_BACKOFF
+#        define SPLIT_SPEED_NEGOTIATION_BACKOFF 60000
+#    endif
+#endif // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
+typedef enum {
+    SPLIT_LINK_OK,
+    SPLIT_LINK_TIMEOUT,
+    SPLIT_LINK_CRC_ERROR,
+} split_link_status_t;
+
+/* Counters saturate rather than wrap. */
+typedef struct {
+    uint16_t success;
+    uint16_t retry;
+    uint16_t timeout;
+    uint16_t crc_error;
+    uint16_t rtt_last_us;
+    uint16_t rtt_avg_us;
+    uint16_t rtt_max_us;
+} split_link_stats_t;
+
+/**
+ * \brief Start timing a transaction on the master.
+ */
+void split_link_stats_begin(void);
+
+/**
+ * \brief Note why the current transaction failed, for drivers that can tell. Failures default to timeouts.
+ */
+void split_link_stats_error(split_link_status_t status);
+
+/**
+ * \brief Record the outcome of the transaction started by split_link_stats_begin().
+ */
+void split_link_stats_end(int8_t id, bool okay);
+
+/**
+ * \brief Get the statistics of a single transaction.
+ */
+const split_link_stats_t *split_link_stats_get(int8_t id);
+
+/**
+ * \brief Sum the statistics of all transactions, the round-trip times are those of the whole link.
+ */
+void split_link_stats_total(split_link_stats_t *total);
+
+void split_link_stats_reset(void);
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+/**
+ * \brief The speed level the master runs at, the link runs at 2^level times its configured speed.
+ */
+uint8_t split_link_speed_level(void);
+
+/**
+ * \brief The speed level the master wants both halves to run at next.
+ */
+uint8_t split_link_speed_target(void);
+
+/**
+ * \brief Tell the negotiator whether the slave received a new speed level, and switch the master to it.
+ */
+void split_link_speed_announced(uint8_t level, bool okay);
+
+/**
+ * \brief Forget what has been learned about the link, and return this half to the configured speed.
+ */
+void split_link_speed_reset(void);
+
+/**
+ * \brief Called on the slave whenever the master announces a speed level.
+ */
+void split_link_speed_slave_sync(void);
+
+/**
+ * \brief Slave housekeeping: follow the announced level, or fall back when the master has gone quiet.
+ */
+void split_link_speed_slave_task(uint8_t level);
+#endif // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
@@ -0,0 +1,20 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// The parts of the ChibiOS API used by the serial protocol, backed by the host loopback in serial_loopback.cpp.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define likely(x) __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+#define HIGHPRIO 0
+#define THD_WORKING_AREA(name, size) uint8_t name[size]
+#define THD_FUNCTION(name, arg) void name(void *arg)
+
+typedef void (*tfunc_t)(void *arg);
+
+void  chRegSetThreadName(const char *name);
+void *chThdCreateStatic(void *wsp, size_t size, int prio, tfunc_t pf, void *arg);
@@ -0,0 +1,17 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 8
+
+#define SPLIT_LAYER_STATE_ENABLE
+#define SPLIT_LED_STATE_ENABLE
+#define SPLIT_MODS_ENABLE
+#define SPLIT_WPM_ENABLE
+
+#define LAYER_STATE_32BIT
+
+// Model a link where waiting for the slave to respond costs a few byte times on top of the ID and handshake
+#define LOOPBACK_TRANSACTION_OVERHEAD 6
+#define SPLIT_BATCH_TRANSACTION_OVERHEAD LOOPBACK_TRANSACTION_OVERHEAD
@@ -0,0 +1,37 @@
+split_transactions_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transactions_DEFS := -DSPLIT_KEYBOARD -DWPM_ENABLE -DNO_DEBUG
+split_transactions_INC := $(QUANTUM_PATH)/split_common
+
+split_transactions_SRC := \
+    $(QUANTUM_PATH)/split_common/tests/split_transactions_tests.cpp \
+    $(QUANTUM_PATH)/split_common/tests/transport_loopback.cpp \
+    $(QUANTUM_PATH)/split_common/transactions.c \
+    $(QUANTUM_PATH)/crc.c \
+    $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+split_transactions_batching_CONFIG := $(split_transactions_CONFIG)
+split_transactions_batching_DEFS := $(split_transactions_DEFS) -DSPLIT_TRANSACTION_BATCHING -DSPLIT_BATCH_BUFFER_SIZE=16
+split_transactions_batching_INC := $(split_transactions_INC)
+split_transactions_batching_SRC := $(split_transactions_SRC)
+
+split_transactions_speed_CONFIG := $(split_transactions_CONFIG)
+split_transactions_speed_DEFS := $(split_transactions_DEFS) -DSPLIT_LINK_STATS_ENABLE -DSPLIT_SPEED_NEGOTIATION_ENABLE -DSPLIT_SPEED_NEGOTIATION_PROBE=50 -DSERIAL_DRIVER_USART
+split_transactions_speed_INC := $(split_transactions_INC) $(DRIVER_PATH)
+split_transactions_speed_SRC := $(split_transactions_SRC) $(QUANTUM_PATH)/split_common/split_link_stats.c
+
+split_serial_protocol_CONFIG := $(split_transactions_CONFIG)
+split_serial_protocol_DEFS := -DSPLIT_KEYBOARD -DWPM_ENABLE -DNO_DEBUG -DPLATFORM_SUPPORTS_SYNCHRONIZATION -DSERIAL_USART_FULL_DUPLEX
+split_serial_protocol_INC := \
+    $(QUANTUM_PATH)/split_common \
+    $(QUANTUM_PATH)/split_common/tests/chibios \
+    $(PLATFORM_PATH)/chibios/drivers
+
+split_serial_protocol_SRC := \
+    $(QUANTUM_PATH)/split_common/tests/serial_protocol_tests.cpp \
+    $(QUANTUM_PATH)/split_common/tests/serial_loopback.cpp \
+    $(PLATFORM_PATH)/chibios/drivers/serial_protocol.c
+
+split_serial_protocol_half_duplex_CONFIG := $(split_serial_protocol_CONFIG)
+split_serial_protocol_half_duplex_DEFS := $(filter-out -DSERIAL_USART_FULL_DUPLEX,$(split_serial_protocol_DEFS))
+split_serial_protocol_half_duplex_INC := $(split_serial_protocol_INC)
+split_serial_protocol_half_duplex_SRC := $(split_serial_protocol_SRC)
@@ -0,0 +1,175 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "serial_loopback.hpp"
+
+extern "C" {
+#include "ch.h"
+#include "serial.h"
+#include "serial_protocol.h"
+#include "synchronization_util.h"
+
+static split_shared_memory_t shared_memory;
+split_shared_memory_t *const split_shmem = &shared_memory;
+
+// Only one half runs at a time.
+void split_shared_memory_lock(void) {}
+void split_shared_memory_unlock(void) {}
+
+void serial_transport_driver_clear(void) {
+    SerialLoopback::instance().clear();
+}
+void serial_transport_driver_slave_init(void) {}
+void serial_transport_driver_master_init(void) {}
+
+bool serial_transport_receive(uint8_t *destination, const size_t size) {
+    return SerialLoopback::instance().receive(destination, size, false);
+}
+bool serial_transport_receive_blocking(uint8_t *destination, const size_t size) {
+    return SerialLoopback::instance().receive(destination, size, true);
+}
+bool serial_transport_send(const uint8_t *source, const size_t size) {
+    return SerialLoopback::instance().send(source, size);
+}
+
+void chRegSetThreadName(const char *name) {}
+void *chThdCreateStatic(void *wsp, size_t size, int prio, tfunc_t pf, void *arg) {
+    SerialLoopback::instance().create_slave_thread(pf, arg);
+    return NULL;
+}
+}
+
+// Half-duplex shares one line between both directions.
+#if defined(SERIAL_USART_FULL_DUPLEX)
+#    define SERIAL_LOOPBACK_LINE(receiver) (receiver)
+#else
+#    define SERIAL_LOOPBACK_LINE(receiver) 0
+#endif
+
+void SerialLoopback::start() {
+    if (!started_) {
+        started_ = true;
+        soft_serial_initiator_init();
+        soft_serial_target_init();
+    }
+}
+
+void SerialLoopback::reset() {
+    memset(&shared_memory, 0, sizeof(shared_memory));
+    memset(&slave_memory_, 0, sizeof(slave_memory_));
+    for (int i = 0; i < 2; i++) {
+        clock_ns_[i]  = 0;
+        line_free_[i] = 0;
+    }
+    wire_bytes_ = 0;
+    corrupt_at_ = -1;
+}
+
+void SerialLoopback::create_slave_thread(void (*function)(void *), void *arg) {
+    slave_function_ = function;
+    slave_arg_      = arg;
+    slave_stack_.resize(256 * 1024);
+    getcontext(&context_[1]);
+    context_[1].uc_stack.ss_sp   = slave_stack_.data();
+    context_[1].uc_stack.ss_size = slave_stack_.size();
+    context_[1].uc_link          = nullptr;
+    makecontext(&context_[1], slave_entry, 0);
+}
+
+void SerialLoopback::slave_entry() {
+    SerialLoopback &loopback = instance();
+    loopback.slave_function_(loopback.slave_arg_);
+}
+
+void SerialLoopback::switch_to(int side) {
+    int from = side_;
+    std::swap(shared_memory, slave_memory_);
+    side_ = side;
+    swapcontext(&context_[from], &context_[side]);
+}
+
+size_t SerialLoopback::available(int side, uint64_t deadline) const {
+    size_t count = 0;
+    for (auto &byte : queue_[side]) {
+        if (byte.arrival_ns > deadline) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+void SerialLoopback::drop_arrived(int side, uint64_t time) {
+    while (!queue_[side].empty() && queue_[side].front().arrival_ns <= time) {
+        queue_[side].pop_front();
+    }
+}
+
+void SerialLoopback::clear() {
+    drop_arrived(side_, clock_ns_[side_]);
+}
+
+bool SerialLoopback::send(const uint8_t *source, size_t size) {
+    int       from  = side_;
+    int       to    = 1 - from;
+    uint64_t &line  = line_free_[SERIAL_LOOPBACK_LINE(to)];
+    uint64_t  start = std::max(clock_ns_[from], line);
+
+    for (size_t i = 0; i < size; i++) {
+        uint8_t value = source[i];
+        if (from == 0 && corrupt_at_ == (int)i) {
+            value ^= 0x10;
+        }
+        start += byte_ns();
+        queue_[to].push_back({value, start});
+    }
+    line = start;
+    wire_bytes_ += size;
+    if (from == 0 && corrupt_at_ >= 0) {
+        corrupt_at_ = corrupt_at_ < (int)size ? -1 : corrupt_at_ - (int)size;
+    }
+
+#if defined(SERIAL_USART_FULL_DUPLEX)
+    // The send returns once the remainder fits in the transmit buffer.
+    uint64_t buffered = SERIAL_LOOPBACK_TX_BUFFER * byte_ns();
+    clock_ns_[from]   = std::max(clock_ns_[from], line > buffered ? line - buffered : 0);
+#else
+    // The sender reads back its own echo.
+    clock_ns_[from] = line;
+#endif
+    return true;
+}
+
+bool SerialLoopback::receive(uint8_t *destination, size_t size, bool blocking) {
+    int      self     = side_;
+    uint64_t deadline = blocking ? UINT64_MAX : clock_ns_[self] + (uint64_t)SERIAL_USART_TIMEOUT * 1000000;
+
+    // Let the other half run until it waits in turn. The master only runs the slave
+    // while waiting for it, so a slave blocked on the master is switched back repeatedly.
+    if (available(self, deadline) < size) {
+        do {
+            switch_to(1 - self);
+        } while (self == 1 && blocking && available(self, deadline) < size);
+    }
+
+    if (available(self, deadline) < size) {
+        // The half waits out the driver's timeout for data that does not come in time.
+        clock_ns_[self] = deadline;
+        drop_arrived(self, deadline);
+        return false;
+    }
+
+    uint64_t arrival = 0;
+    for (size_t i = 0; i < size; i++) {
+        destination[i] = queue_[self].front().value;
+        arrival        = queue_[self].front().arrival_ns;
+        queue_[self].pop_front();
+    }
+    if (arrival > clock_ns_[self]) {
+        clock_ns_[self] = arrival + SERIAL_LOOPBACK_WAKEUP_NS;
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <ucontext.h>
+
+extern "C" {
+#include "transport.h"
+}
+
+// Serial link speed and frame format used to convert wire bytes into time, matching the ChibiOS USART defaults.
+#ifndef SERIAL_USART_SPEED
+#    define SERIAL_USART_SPEED 460800
+#endif
+#define SERIAL_LOOPBACK_BITS_PER_BYTE 12 // start bit, 8 data bits, parity and 2 stop bits
+
+// Time for a thread blocked on the driver to be woken once its data has arrived.
+#ifndef SERIAL_LOOPBACK_WAKEUP_NS
+#    define SERIAL_LOOPBACK_WAKEUP_NS 5000
+#endif
+
+// Bytes the driver accepts for transmission before a send blocks.
+#ifndef SERIAL_LOOPBACK_TX_BUFFER
+#    define SERIAL_LOOPBACK_TX_BUFFER 16
+#endif
+
+#ifndef SERIAL_USART_TIMEOUT
+#    define SERIAL_USART_TIMEOUT 20
+#endif
+
+/**
+ * Host-side serial driver that connects the master and slave halves of the ChibiOS serial
+ * protocol in a single process. The slave thread runs as a coroutine: whenever one half
+ * waits for data it switches to the other, until that waits in turn. Each half has its own copy of the shared memory, which is swapped
+ * into `split_shmem` while that half runs.
+ *
+ * Time is simulated rather than measured: every byte is stamped with the time it would
+ * arrive at the other half given the link speed, and each half's clock advances as it
+ * waits for data, so the master's clock gives the wire time of a sequence of transactions.
+ */
+class SerialLoopback {
+   public:
+    static SerialLoopback& instance() {
+        static SerialLoopback loopback;
+        return loopback;
+    }
+
+    // Start both halves, the slave thread is only ever started once.
+    void start();
+    // Clear both copies of the shared memory, the clocks and the statistics.
+    void reset();
+
+    // The copies of the shared memory, for use while the master is running.
+    split_shared_memory_t& master_memory() {
+        return *split_shmem;
+    }
+    split_shared_memory_t& slave_memory() {
+        return slave_memory_;
+    }
+
+    // Simulated time on the master, in nanoseconds.
+    uint64_t master_time_ns() const {
+        return clock_ns_[0];
+    }
+    // Bytes sent in either direction.
+    uint32_t wire_bytes() const {
+        return wire_bytes_;
+    }
+    // Let time pass on the master, so that the slave gives up on anything it is waiting for.
+    void idle_master(uint64_t ns) {
+        clock_ns_[0] += ns;
+    }
+    // Flip a bit in the byte at the given offset of the master's next send.
+    void corrupt_next_send(size_t offset) {
+        corrupt_at_ = (int)offset;
+    }
+
+    void create_slave_thread(void (*function)(void*), void* arg);
+
+    void clear();
+    bool send(const uint8_t* source, size_t size);
+    bool receive(uint8_t* destination, size_t size, bool blocking);
+
+    static uint64_t byte_ns() {
+        return (uint64_t)SERIAL_LOOPBACK_BITS_PER_BYTE * 1000000000 / SERIAL_USART_SPEED;
+    }
+
+   private:
+    struct WireByte {
+        uint8_t  value;
+        uint64_t arrival_ns;
+    };
+
+    SerialLoopback() {}
+
+    static void slave_entry();
+    void        switch_to(int side);
+    size_t      available(int side, uint64_t deadline) const;
+    void        drop_arrived(int side, uint64_t time);
+
+    int                   side_ = 0; // the running half, 0 for the master and 1 for the slave
+    ucontext_t            context_[2];
+    std::vector<uint8_t>  slave_stack_;
+    void                  (*slave_function_)(void*) = nullptr;
+    void*                 slave_arg_                = nullptr;
+    split_shared_memory_t slave_memory_;
+
+    std::deque<WireByte> queue_[2]; // indexed by the receiving half
+    uint64_t             clock_ns_[2]  = {0, 0};
+    uint64_t             line_free_[2] = {0, 0}; // indexed by the receiving half
+    uint32_t             wire_bytes_   = 0;
+    int                  corrupt_at_   = -1;
+    bool                 started_      = false;
+};
@@ -0,0 +1,129 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdio>
+
+#include "serial_loopback.hpp"
+
+extern "C" {
+#include "serial.h"
+#include "transactions.h"
+
+split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
+}
+
+#if defined(SERIAL_USART_FULL_DUPLEX)
+#    define SERIAL_DUPLEX_NAME "full-duplex"
+#else
+#    define SERIAL_DUPLEX_NAME "half-duplex"
+#endif
+
+#define TRANSACTION_I2T(member) \
+    { sizeof(((split_shared_memory_t *)0)->member), offsetof(split_shared_memory_t, member), 0, 0, NULL }
+#define TRANSACTION_T2I(member) \
+    { 0, 0, sizeof(((split_shared_memory_t *)0)->member), offsetof(split_shared_memory_t, member), NULL }
+
+static uint8_t callback_wpm;
+
+static void record_wpm(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    callback_wpm = *(const uint8_t *)initiator2target_buffer;
+}
+
+/*
+ * Runs the ChibiOS serial protocol against the host loopback driver, with a transaction table
+ * holding the same buffers as the built-in split transactions.
+ */
+class SerialProtocol : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        split_transaction_table[GET_SLAVE_MATRIX_CHECKSUM] = TRANSACTION_T2I(smatrix.checksum);
+        split_transaction_table[GET_SLAVE_MATRIX_DATA]     = TRANSACTION_T2I(smatrix.matrix);
+        split_transaction_table[PUT_LAYER_STATE]           = TRANSACTION_I2T(layers);
+        split_transaction_table[PUT_MODS]                  = TRANSACTION_I2T(mods);
+        split_transaction_table[PUT_LED_STATE]             = TRANSACTION_I2T(led_state);
+        split_transaction_table[PUT_WPM]                   = TRANSACTION_I2T(current_wpm);
+
+        loopback.start();
+        // Collect the replies of anything left in flight by the previous test.
+        ASSERT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_CHECKSUM));
+        loopback.reset();
+    }
+
+    SerialLoopback &loopback = SerialLoopback::instance();
+};
+
+TEST_F(SerialProtocol, WriteReachesSlave) {
+    loopback.master_memory().layers.layer_state = 0x12345678;
+    loopback.master_memory().mods.real_mods     = 0x22;
+
+    EXPECT_TRUE(soft_serial_transaction(PUT_LAYER_STATE));
+    EXPECT_TRUE(soft_serial_transaction(PUT_MODS));
+    EXPECT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_CHECKSUM));
+
+    EXPECT_EQ(loopback.slave_memory().layers.layer_state, 0x12345678);
+    EXPECT_EQ(loopback.slave_memory().mods.real_mods, 0x22);
+}
+
+TEST_F(SerialProtocol, ReadReturnsSlaveData) {
+    loopback.slave_memory().smatrix.checksum  = 0xA5;
+    loopback.slave_memory().smatrix.matrix[0] = 0x81;
+    loopback.slave_memory().smatrix.matrix[3] = 0x18;
+
+    EXPECT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_CHECKSUM));
+    EXPECT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_DATA));
+
+    EXPECT_EQ(loopback.master_memory().smatrix.checksum, 0xA5);
+    EXPECT_EQ(loopback.master_memory().smatrix.matrix[0], 0x81);
+    EXPECT_EQ(loopback.master_memory().smatrix.matrix[3], 0x18);
+}
+
+TEST_F(SerialProtocol, SlaveCallbackRuns) {
+    split_transaction_table[PUT_WPM].slave_callback = record_wpm;
+    loopback.master_memory().current_wpm            = 120;
+    callback_wpm                                    = 0;
+
+    EXPECT_TRUE(soft_serial_transaction(PUT_WPM));
+    EXPECT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_CHECKSUM));
+    EXPECT_EQ(callback_wpm, 120);
+}
+
+TEST_F(SerialProtocol, IllegalTransactionFails) {
+    EXPECT_FALSE(soft_serial_transaction(NUM_TOTAL_TRANSACTIONS));
+}
+
+TEST_F(SerialProtocol, CorruptedHandshakeFails) {
+    loopback.slave_memory().smatrix.matrix[0] = 0x81;
+
+    loopback.corrupt_next_send(0);
+    EXPECT_FALSE(soft_serial_transaction(GET_SLAVE_MATRIX_DATA));
+    EXPECT_EQ(loopback.master_memory().smatrix.matrix[0], 0);
+
+    loopback.idle_master(SERIAL_USART_TIMEOUT * 1000000);
+    EXPECT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_DATA));
+    EXPECT_EQ(loopback.master_memory().smatrix.matrix[0], 0x81);
+}
+
+TEST_F(SerialProtocol, Benchmark) {
+    // Each cycle synchronises all state, as the master does after a change on every half.
+    const uint8_t  cycle[]      = {GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, PUT_LAYER_STATE, PUT_MODS, PUT_LED_STATE, PUT_WPM};
+    const uint32_t cycles       = 1000;
+    uint32_t       payload      = 0;
+    uint32_t       transactions = 0;
+
+    for (uint32_t i = 0; i < cycles; i++) {
+        loopback.master_memory().current_wpm = i;
+        for (uint8_t id : cycle) {
+            ASSERT_TRUE(soft_serial_transaction(id));
+            payload += split_transaction_table[id].initiator2target_buffer_size + split_transaction_table[id].target2initiator_buffer_size;
+            transactions++;
+        }
+    }
+    ASSERT_TRUE(soft_serial_transaction(GET_SLAVE_MATRIX_CHECKSUM));
+    EXPECT_EQ(loopback.slave_memory().current_wpm, (uint8_t)(cycles - 1));
+
+    double elapsed_s = loopback.master_time_ns() / 1e9;
+    printf("split serial benchmark: %s %u baud: %.1f us per cycle, %.0f transactions/s, %.0f payload bytes/s, %.1f wire bytes per transaction\n", SERIAL_DUPLEX_NAME, SERIAL_USART_SPEED, elapsed_s * 1e6 / cycles, transactions / elapsed_s, payload / elapsed_s, (double)loopback.wire_bytes() / transactions);
+    RecordProperty("transactions_per_second", (int)(transactions / elapsed_s));
+}
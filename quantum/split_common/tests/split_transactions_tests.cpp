@@ -0,0 +1,365 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "transport_loopback.hpp"
+
+extern "C" {
+#include "action_layer.h"
+#include "timer.h"
+#include "transactions.h"
+#ifdef SPLIT_LINK_STATS_ENABLE
+#    include "split_link_stats.h"
+#endif
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+layer_state_t layer_state;
+layer_state_t default_layer_state;
+
+// Both halves share the layer state globals in a single process, so the master's values are kept aside.
+static layer_state_t master_layer_state;
+static layer_state_t master_default_layer_state;
+static uint8_t       master_mods;
+static uint8_t master_weak_mods;
+static uint8_t master_oneshot_mods;
+static uint8_t master_oneshot_locked_mods;
+static uint8_t master_leds;
+static uint8_t master_wpm;
+
+static uint8_t slave_mods;
+static uint8_t slave_leds;
+static uint8_t slave_wpm;
+
+uint8_t get_mods(void) {
+    return master_mods;
+}
+uint8_t get_weak_mods(void) {
+    return master_weak_mods;
+}
+uint8_t get_oneshot_mods(void) {
+    return master_oneshot_mods;
+}
+uint8_t get_oneshot_locked_mods(void) {
+    return master_oneshot_locked_mods;
+}
+void set_mods(uint8_t mods) {
+    slave_mods = mods;
+}
+void set_weak_mods(uint8_t mods) {}
+void set_oneshot_mods(uint8_t mods) {}
+void set_oneshot_locked_mods(uint8_t mods) {}
+
+uint8_t host_keyboard_leds(void) {
+    return master_leds;
+}
+void set_split_host_keyboard_leds(uint8_t led_state) {
+    slave_leds = led_state;
+}
+
+uint8_t get_current_wpm(void) {
+    return master_wpm;
+}
+void set_current_wpm(uint8_t wpm) {
+    slave_wpm = wpm;
+}
+
+uint32_t sync_timer_read32(void) {
+    return timer_read32();
+}
+void sync_timer_update(uint32_t time) {}
+}
+
+#define SPLIT_TRANSACTIONS_STR2(x) #x
+#define SPLIT_TRANSACTIONS_STR(x) SPLIT_TRANSACTIONS_STR2(x)
+
+class SplitTransactions : public ::testing::Test {
+   protected:
+    void SetUp() override {
+#ifdef SPLIT_SPEED_NEGOTIATION_ENABLE
+        split_link_speed_reset();
+#endif
+        loopback.reset();
+        master_layer_state = master_default_layer_state = 0;
+        master_mods = master_weak_mods = master_oneshot_mods = master_oneshot_locked_mods = 0;
+        master_leds = master_wpm = 0;
+        std::fill(std::begin(master_matrix), std::end(master_matrix), 0);
+        std::fill(std::begin(slave_matrix), std::end(slave_matrix), 0);
+        std::fill(std::begin(received_matrix), std::end(received_matrix), 0);
+
+        // Let the initial forced sync of every region go through, so each test starts from a quiet link.
+        advance_time(1000);
+        for (int i = 0; i < 4; ++i) {
+            cycle();
+        }
+        loopback.stats = LoopbackStats();
+#ifdef SPLIT_LINK_STATS_ENABLE
+        split_link_stats_reset();
+#endif
+    }
+
+    // One scan on each half: the slave publishes its matrix, the master exchanges data, the slave applies it.
+    bool cycle() {
+        loopback.run_slave(slave_matrix, slave_matrix);
+        layer_state         = master_layer_state;
+        default_layer_state = master_default_layer_state;
+        bool okay           = loopback.run_master(master_matrix, received_matrix);
+        loopback.run_slave(slave_matrix, slave_matrix);
+        advance_time(1);
+        return okay;
+    }
+
+    TransportLoopback &loopback = TransportLoopback::instance();
+    matrix_row_t       master_matrix[MATRIX_ROWS / 2];
+    matrix_row_t       slave_matrix[MATRIX_ROWS / 2];
+    matrix_row_t       received_matrix[MATRIX_ROWS / 2];
+};
+
+TEST_F(SplitTransactions, SlaveMatrixReachesMaster) {
+    slave_matrix[1] = 0x24;
+    EXPECT_TRUE(cycle());
+    EXPECT_TRUE(std::equal(std::begin(slave_matrix), std::end(slave_matrix), std::begin(received_matrix)));
+}
+
+TEST_F(SplitTransactions, StateReachesSlave) {
+    master_layer_state = 0x00010004;
+    master_mods        = 0x02;
+    master_leds        = 0x01;
+    master_wpm         = 42;
+    slave_matrix[0]    = 0x80;
+    EXPECT_TRUE(cycle());
+
+    EXPECT_EQ(layer_state, 0x00010004);
+    EXPECT_EQ(slave_mods, 0x02);
+    EXPECT_EQ(slave_leds, 0x01);
+    EXPECT_EQ(slave_wpm, 42);
+    EXPECT_EQ(received_matrix[0], 0x80);
+}
+
+#ifdef SPLIT_TRANSACTION_BATCHING
+
+TEST_F(SplitTransactions, ChangesShareOneExchangeAfterTheMatrix) {
+    master_layer_state = 0x2;
+    master_mods        = 0x1;
+    master_leds        = 0x4;
+    master_wpm         = 10;
+    slave_matrix[2]    = 0x01;
+    EXPECT_TRUE(cycle());
+
+    // Matrix checksum and data first, then a single frame for all of the changes
+    EXPECT_EQ(loopback.stats.transactions, 3);
+    EXPECT_EQ(loopback.stats.matrix_ready_at, LOOPBACK_TRANSACTION_OVERHEAD + 1);
+    EXPECT_EQ(layer_state, 0x2);
+    EXPECT_EQ(slave_mods, 0x1);
+    EXPECT_EQ(slave_leds, 0x4);
+    EXPECT_EQ(slave_wpm, 10);
+    EXPECT_EQ(received_matrix[2], 0x01);
+}
+
+TEST_F(SplitTransactions, OnlyChangedBytesAreSent) {
+    master_layer_state = 0x01000000;
+    master_mods        = 0x2;
+    master_leds        = 0x2;
+    master_wpm         = 20;
+    EXPECT_TRUE(cycle());
+
+    // Partial records with the single changed byte of the layer state and the modifiers, then two whole one byte
+    // records, after the matrix checksum poll
+    EXPECT_EQ(loopback.stats.transactions, 2);
+    EXPECT_EQ(split_shmem->batch.length, (3 + 1) + (3 + 1) + (1 + 1) + (1 + 1));
+    EXPECT_EQ(layer_state, 0x01000000);
+}
+
+TEST_F(SplitTransactions, SmallChangeIsSentOnItsOwn) {
+    // A whole frame costs more than sending one byte separately
+    master_wpm = 30;
+    EXPECT_TRUE(cycle());
+
+    EXPECT_EQ(loopback.stats.transactions, 2);
+    EXPECT_EQ(loopback.stats.matrix_ready_at, LOOPBACK_TRANSACTION_OVERHEAD + 1);
+    EXPECT_EQ(slave_wpm, 30);
+}
+
+TEST_F(SplitTransactions, StateIsNeverDeferred) {
+    // More state than fits in a single frame
+    master_layer_state         = 0x11111111;
+    master_default_layer_state = 0x22222222;
+    master_mods                = 0x33;
+    master_weak_mods           = 0x44;
+    master_leds                = 0x55;
+    EXPECT_TRUE(cycle());
+
+    EXPECT_EQ(layer_state, 0x11111111);
+    EXPECT_EQ(default_layer_state, 0x22222222);
+    EXPECT_EQ(slave_mods, 0x33);
+    EXPECT_EQ(slave_leds, 0x55);
+}
+
+TEST_F(SplitTransactions, FailedExchangeIsRetried) {
+    master_mods        = 0x01;
+    loopback.connected = false;
+    EXPECT_FALSE(cycle());
+    EXPECT_EQ(slave_mods, 0);
+
+    loopback.connected = true;
+    EXPECT_TRUE(cycle());
+    EXPECT_EQ(slave_mods, 0x01);
+}
+
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_LINK_STATS_ENABLE
+
+TEST_F(SplitTransactions, LinkStatsCountOutcomes) {
+    split_link_stats_t total;
+
+    EXPECT_TRUE(cycle());
+    split_link_stats_total(&total);
+    EXPECT_GT(total.success, 0);
+    EXPECT_EQ(total.timeout, 0);
+    EXPECT_EQ(total.crc_error, 0);
+    EXPECT_EQ(total.retry, 0);
+
+    loopback.connected = false;
+    EXPECT_FALSE(cycle());
+    loopback.connected = true;
+    EXPECT_TRUE(cycle());
+
+    // Each failed transaction was attempted again on the next cycle.
+    split_link_stats_total(&total);
+    EXPECT_GT(total.timeout, 0);
+    EXPECT_EQ(total.retry, total.timeout);
+    EXPECT_EQ(total.crc_error, 0);
+}
+
+#endif // SPLIT_LINK_STATS_ENABLE
+
+#ifdef SPLIT_SPEED_NEGOTIATION_ENABLE
+
+TEST_F(SplitTransactions, SpeedStepsUpOnACleanLink) {
+    for (int i = 0; i < 2000; ++i) {
+        cycle();
+    }
+    EXPECT_EQ(split_link_speed_level(), SPLIT_SPEED_NEGOTIATION_STEPS);
+    EXPECT_EQ(loopback.master_speed_level, SPLIT_SPEED_NEGOTIATION_STEPS);
+    EXPECT_EQ(loopback.slave_speed_level, SPLIT_SPEED_NEGOTIATION_STEPS);
+
+    slave_matrix[0] = 0x11;
+    EXPECT_TRUE(cycle());
+    EXPECT_EQ(received_matrix[0], 0x11);
+}
+
+TEST_F(SplitTransactions, SpeedStaysBelowANoisyLevel) {
+    split_link_stats_t total;
+
+    loopback.clean_speed_levels = 1;
+    loopback.noisy_error_period = 5;
+    for (int i = 0; i < 5000; ++i) {
+        cycle();
+    }
+    EXPECT_EQ(split_link_speed_level(), 1);
+    EXPECT_EQ(loopback.master_speed_level, 1);
+    EXPECT_EQ(loopback.slave_speed_level, 1);
+
+    split_link_stats_total(&total);
+    EXPECT_GT(total.crc_error, 0);
+
+    // The noisy level isn't tried again until the back off has passed.
+    uint16_t crc_errors = total.crc_error;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(cycle());
+    }
+    split_link_stats_total(&total);
+    EXPECT_EQ(total.crc_error, crc_errors);
+}
+
+TEST_F(SplitTransactions, SpeedFallsBackWhenTheLinkDies) {
+    for (int i = 0; i < 2000; ++i) {
+        cycle();
+    }
+    ASSERT_EQ(split_link_speed_level(), SPLIT_SPEED_NEGOTIATION_STEPS);
+
+    // Nothing gets through above the configured speed any more. Both halves fall back, and
+    // once the lower levels have been probed without success, stay there.
+    loopback.clean_speed_levels = 0;
+    loopback.noisy_error_period = 1;
+    for (int i = 0; i < 2000; ++i) {
+        cycle();
+    }
+    EXPECT_EQ(loopback.master_speed_level, 0);
+    EXPECT_EQ(loopback.slave_speed_level, 0);
+
+    slave_matrix[0] = 0x22;
+    EXPECT_TRUE(cycle());
+    EXPECT_EQ(received_matrix[0], 0x22);
+}
+
+#endif // SPLIT_SPEED_NEGOTIATION_ENABLE
+
+TEST_F(SplitTransactions, Benchmark) {
+    const uint32_t cycles         = 20000;
+    const uint32_t scan_period_us = 1000;
+    uint32_t       seed           = 0x5eed;
+    uint32_t       total_bytes    = 0;
+    uint32_t       total_trans    = 0;
+    uint32_t       max_us         = 0;
+    uint64_t       latency_total  = 0;
+    uint32_t       latency_max    = 0;
+    uint32_t       latency_count  = 0;
+
+#ifdef SPLIT_SPEED_NEGOTIATION_ENABLE
+    // Let the link reach its final speed first, switching speeds costs a few failed cycles.
+    for (int i = 0; i < 2000; ++i) {
+        cycle();
+    }
+#endif
+
+    auto random = [&seed]() {
+        seed = seed * 1664525 + 1013904223;
+        return seed >> 8;
+    };
+
+    for (uint32_t i = 0; i < cycles; ++i) {
+        // Typing on both halves, with the occasional layer, modifier, lock and WPM change.
+        bool key_changed = random() % 25 == 0;
+        if (key_changed) {
+            slave_matrix[random() % (MATRIX_ROWS / 2)] ^= 1 << (random() % MATRIX_COLS);
+        }
+        if (random() % 500 == 0) master_layer_state ^= 1 << (random() % 4);
+        if (random() % 200 == 0) master_mods ^= 1 << (random() % 8);
+        if (random() % 2000 == 0) master_leds ^= 1 << (random() % 3);
+        if (i % 1000 == 0) master_wpm = random() % 120;
+
+        loopback.stats = LoopbackStats();
+        ASSERT_TRUE(cycle());
+        ASSERT_TRUE(std::equal(std::begin(slave_matrix), std::end(slave_matrix), std::begin(received_matrix)));
+
+        // The master can only act on the slave matrix once the whole exchange has finished.
+        uint32_t busy_us = LoopbackStats::bytes_to_us(loopback.stats.wire_bytes);
+        total_bytes += loopback.stats.wire_bytes;
+        total_trans += loopback.stats.transactions;
+        max_us = std::max(max_us, busy_us);
+        if (key_changed) {
+            latency_total += busy_us;
+            latency_max = std::max(latency_max, busy_us);
+            latency_count++;
+        }
+    }
+
+    double   bytes_per_cycle = (double)total_bytes / cycles;
+    double   utilization     = 100.0 * LoopbackStats::bytes_to_us(total_bytes) / ((double)cycles * scan_period_us);
+    uint32_t latency_avg     = latency_count ? (uint32_t)(latency_total / latency_count) : 0;
+    printf("split transactions benchmark: %s: %.2f transactions, %.1f bytes per cycle, link %.1f%% busy at %u baud, max %u us per cycle, slave matrix latency avg %u us max %u us\n",
+#ifdef SPLIT_TRANSACTION_BATCHING
+           "batched (" SPLIT_TRANSACTIONS_STR(SPLIT_BATCH_BUFFER_SIZE) " byte frames)",
+#else
+           "unbatched",
+#endif
+           (double)total_trans / cycles, bytes_per_cycle, utilization, LOOPBACK_BAUD_RATE, max_us, latency_avg, latency_max);
+    RecordProperty("bytes_per_cycle", (int)(bytes_per_cycle + 0.5));
+    RecordProperty("matrix_latency_us", (int)latency_avg);
+}
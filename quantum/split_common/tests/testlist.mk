@@ -0,0 +1,6 @@
+TEST_LIST += \
+	split_transactions \
+	split_transactions_batching \
+	split_transactions_speed \
+	split_serial_protocol \
+	split_serial_protocol_half_duplex
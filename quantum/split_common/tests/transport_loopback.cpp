@@ -0,0 +1,119 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "transport_loopback.hpp"
+
+extern "C" {
+#include "transactions.h"
+#ifdef SPLIT_LINK_STATS_ENABLE
+#    include "split_link_stats.h"
+#endif
+
+static split_shared_memory_t master_memory;
+split_shared_memory_t *const split_shmem = &master_memory;
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+#ifdef SPLIT_LINK_STATS_ENABLE
+    split_link_stats_begin();
+    bool okay = TransportLoopback::instance().execute(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+    split_link_stats_end(id, okay);
+    return okay;
+#else
+    return TransportLoopback::instance().execute(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+#endif
+}
+
+void soft_serial_set_speed_level(uint8_t level) {
+    TransportLoopback::instance().set_speed_level(level);
+}
+
+bool is_transport_connected(void) {
+    return TransportLoopback::instance().connected;
+}
+
+void split_shared_memory_lock(void) {}
+void split_shared_memory_unlock(void) {}
+}
+
+void TransportLoopback::reset() {
+    memset(&master_memory, 0, sizeof(master_memory));
+    memset(&slave_memory, 0, sizeof(slave_memory));
+    stats              = LoopbackStats();
+    connected          = true;
+    master_speed_level = 0;
+    slave_speed_level  = 0;
+    clean_speed_levels = UINT8_MAX;
+    noisy_error_period = 50;
+    noisy_transactions = 0;
+}
+
+void TransportLoopback::set_speed_level(uint8_t level) {
+    (in_slave ? slave_speed_level : master_speed_level) = level;
+}
+
+void TransportLoopback::swap_to_slave() {
+    std::swap(master_memory, slave_memory);
+    in_slave = true;
+}
+
+void TransportLoopback::swap_to_master() {
+    std::swap(master_memory, slave_memory);
+    in_slave = false;
+}
+
+bool TransportLoopback::run_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return transactions_master(master_matrix, slave_matrix);
+}
+
+void TransportLoopback::run_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    swap_to_slave();
+    transactions_slave(master_matrix, slave_matrix);
+    swap_to_master();
+}
+
+bool TransportLoopback::execute(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    if (!connected || master_speed_level != slave_speed_level) {
+        return false;
+    }
+    if (master_speed_level > clean_speed_levels && ++noisy_transactions % noisy_error_period == 0) {
+#ifdef SPLIT_LINK_STATS_ENABLE
+        split_link_stats_error(SPLIT_LINK_CRC_ERROR);
+#endif
+        return false;
+    }
+
+    split_transaction_desc_t *trans   = &split_transaction_table[id];
+    uint8_t                  *master  = (uint8_t *)&master_memory;
+    uint8_t                  *slave   = (uint8_t *)&slave_memory;
+    uint16_t                  i2t_off = trans->initiator2target_offset;
+    uint16_t                  t2i_off = trans->target2initiator_offset;
+
+    if (initiator2target_length > 0) {
+        memcpy(master + i2t_off, initiator2target_buf, std::min<uint16_t>(trans->initiator2target_buffer_size, initiator2target_length));
+    }
+    memcpy(slave + i2t_off, master + i2t_off, trans->initiator2target_buffer_size);
+
+    if (trans->slave_callback) {
+        swap_to_slave();
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        swap_to_master();
+    }
+
+    memcpy(master + t2i_off, slave + t2i_off, trans->target2initiator_buffer_size);
+    if (target2initiator_length > 0) {
+        memcpy(target2initiator_buf, master + t2i_off, std::min<uint16_t>(trans->target2initiator_buffer_size, target2initiator_length));
+    }
+
+    stats.transactions++;
+    stats.wire_bytes += LOOPBACK_TRANSACTION_OVERHEAD + trans->initiator2target_buffer_size + trans->target2initiator_buffer_size;
+
+    // Anything returning part of the slave matrix region counts as the matrix arriving
+    uint16_t smatrix_off = offsetof(split_shared_memory_t, smatrix);
+    if (stats.matrix_ready_at == 0 && trans->target2initiator_buffer_size > 0 && t2i_off < smatrix_off + sizeof(split_slave_matrix_sync_t) && t2i_off + trans->target2initiator_buffer_size > smatrix_off) {
+        stats.matrix_ready_at = stats.wire_bytes;
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+extern "C" {
+#include "transport.h"
+}
+
+// Serial link speed used to convert wire bytes into time, matching the ChibiOS USART default.
+#ifndef LOOPBACK_BAUD_RATE
+#    define LOOPBACK_BAUD_RATE 460800
+#endif
+
+// Byte times charged per transaction: the transaction ID and the slave's handshake, plus any turnaround delay.
+#ifndef LOOPBACK_TRANSACTION_OVERHEAD
+#    define LOOPBACK_TRANSACTION_OVERHEAD 2
+#endif
+
+/**
+ * Link statistics gathered by the loopback transport. Every transaction is costed as it
+ * would be on the serial driver: LOOPBACK_TRANSACTION_OVERHEAD, followed by both
+ * registered buffers in full.
+ */
+struct LoopbackStats {
+    uint32_t transactions    = 0;
+    uint32_t wire_bytes      = 0;
+    uint32_t matrix_ready_at = 0; // wire_bytes when the slave matrix first arrived at the master
+
+    static uint32_t bytes_to_us(uint32_t bytes) {
+        return (uint32_t)((uint64_t)bytes * 10 * 1000000 / LOOPBACK_BAUD_RATE);
+    }
+};
+
+/**
+ * Host-side transport that connects the master and slave halves of the split transactions in
+ * a single process. `split_shmem` always holds the master's copy of the shared memory; the
+ * slave's copy is swapped in while slave code runs.
+ */
+class TransportLoopback {
+   public:
+    static TransportLoopback& instance() {
+        static TransportLoopback loopback;
+        return loopback;
+    }
+
+    void reset();
+
+    // Run one master cycle, as split_common's matrix task would.
+    bool run_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+    // Run one slave cycle, as split_common's matrix task would.
+    void run_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+    bool execute(int8_t id, const void* initiator2target_buf, uint16_t initiator2target_length, void* target2initiator_buf, uint16_t target2initiator_length);
+
+    // Speed level each half runs at. Transactions fail while they differ, or at levels above
+    // clean_speed_levels, where every noisy_error_period'th transaction is corrupted.
+    void set_speed_level(uint8_t level);
+
+    LoopbackStats stats;
+    bool          connected          = true;
+    uint8_t       master_speed_level = 0;
+    uint8_t       slave_speed_level  = 0;
+    uint8_t       clean_speed_levels = UINT8_MAX;
+    uint32_t      noisy_error_period = 50;
+
+   private:
+    TransportLoopback() {
+        reset();
+    }
+
+    void swap_to_slave();
+    void swap_to_master();
+
+    split_shared_memory_t slave_memory;
+    bool                  in_slave           = false;
+    uint32_t              noisy_transactions = 0;
+};
@@ -25,12 +25,18 @@
 #include "action_util.h"
 #include "sync_timer.h"
 #include "wait.h"
+#include "util.h"
 #include "transactions.h"
 #include "transport.h"
 #include "transaction_id_define.h"
+#include "tracing.h"
 #include "split_util.h"
 #include "synchronization_util.h"
 
+#ifdef SPLIT_LINK_STATS_ENABLE
+#    include "split_link_stats.h"
+#endif
+
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -84,10 +90,19 @@
 #define trans_initiator2target_cb(cb) \
     { 0, 0, 0, 0, cb }
 
+#define trans_bidirectional_initializer_cb(initiator2target_member, target2initiator_member, cb) \
+    { sizeof_member(split_shared_memory_t, initiator2target_member), offsetof(split_shared_memory_t, initiator2target_member), sizeof_member(split_shared_memory_t, target2initiator_member), offsetof(split_shared_memory_t, target2initiator_member), cb }
+
 #define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
 #define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
 #define transport_exec(id) transport_execute_transaction(id, NULL, 0, NULL, 0)
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+#    define transport_put(id, data, length) split_batch_put(id, data, length)
+#else // SPLIT_TRANSACTION_BATCHING
+#    define transport_put(id, data, length) transport_write(id, data, length)
+#endif // SPLIT_TRANSACTION_BATCHING
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
 void slave_rpc_info_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
@@ -159,10 +174,231 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     return okay;
 }
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+
+#    if defined(__AVR__) && !defined(USE_I2C)
+#        error "SPLIT_TRANSACTION_BATCHING is not supported by the AVR soft serial driver, as it runs slave callbacks before receiving data from the master"
+#    endif
+
+#    ifndef SPLIT_BATCH_MAX_FRAMES
+#        define SPLIT_BATCH_MAX_FRAMES 1
+#    endif // SPLIT_BATCH_MAX_FRAMES
+
+// Fixed cost of a transaction in byte times: the transaction ID and handshake, plus any turnaround delay of the link
+#    ifndef SPLIT_BATCH_TRANSACTION_OVERHEAD
+#        define SPLIT_BATCH_TRANSACTION_OVERHEAD 2
+#    endif // SPLIT_BATCH_TRANSACTION_OVERHEAD
+
+_Static_assert(SPLIT_BATCH_BUFFER_SIZE >= 8 && SPLIT_BATCH_BUFFER_SIZE <= 253, "SPLIT_BATCH_BUFFER_SIZE must be between 8 and 253");
+_Static_assert(SPLIT_BATCH_MAX_FRAMES >= 1, "SPLIT_BATCH_MAX_FRAMES must be at least 1");
+
+// Record header: the transaction ID, and whether an offset and length follow.
+// Records without the flag carry the transaction's whole shared memory region.
+#    define SPLIT_BATCH_RECORD_ID_MASK 0x1F
+#    define SPLIT_BATCH_RECORD_PARTIAL 0x80
+
+typedef enum split_batch_priority_t {
+    SPLIT_BATCH_PRIORITY_STATE,    // affects keycode processing on the slave, always sent in the current cycle
+    SPLIT_BATCH_PRIORITY_COSMETIC, // lighting and display state, may be deferred to a later cycle
+    SPLIT_BATCH_PRIORITY_REFRESH,  // periodic resync of unchanged data
+} split_batch_priority_t;
+
+// The range of each transaction's region that still needs to be sent. end == 0 when nothing is pending.
+typedef struct split_batch_pending_t {
+    uint8_t start;
+    uint8_t end;
+    uint8_t priority;
+} split_batch_pending_t;
+
+static split_batch_pending_t split_batch_pending[NUM_TOTAL_TRANSACTIONS];
+
+static split_batch_priority_t split_batch_priority(int8_t trans_id) {
+    switch (trans_id) {
+#    ifdef BACKLIGHT_ENABLE
+        case PUT_BACKLIGHT:
+#    endif
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+        case PUT_RGBLIGHT:
+#    endif
+#    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+        case PUT_LED_MATRIX:
+#    endif
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+        case PUT_RGB_MATRIX:
+#    endif
+#    if defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
+        case PUT_WPM:
+#    endif
+#    if defined(OLED_ENABLE) && defined(SPLIT_OLED_ENABLE)
+        case PUT_OLED:
+#    endif
+#    if defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
+        case PUT_ST7565:
+#    endif
+#    if defined(HAPTIC_ENABLE) && defined(SPLIT_HAPTIC_ENABLE)
+        case PUT_HAPTIC:
+#    endif
+#    if defined(SPLIT_ACTIVITY_ENABLE)
+        case PUT_ACTIVITY:
+#    endif
+            return SPLIT_BATCH_PRIORITY_COSMETIC;
+        default:
+            return SPLIT_BATCH_PRIORITY_STATE;
+    }
+}
+
+/**
+ * \brief Update the local copy of a transaction's shared memory, and queue the changed bytes for the next batch exchange.
+ *
+ * If nothing changed, the whole region is queued as a low priority refresh.
+ */
+static bool split_batch_put(int8_t trans_id, const void *data, size_t length) {
+    split_transaction_desc_t *trans = &split_transaction_table[trans_id];
+    if (trans->slave_callback) {
+        // The slave needs to act on this transaction as it arrives, so it can't be batched.
+        return transport_write(trans_id, data, length);
+    }
+
+    const uint8_t *source   = data;
+    uint8_t       *shmem    = split_trans_initiator2target_buffer(trans);
+    uint8_t        size     = MIN(length, trans->initiator2target_buffer_size);
+    uint8_t        start    = 0;
+    uint8_t        end      = size;
+    uint8_t        priority = split_batch_priority(trans_id);
+
+    if (source != shmem) {
+        while (start < size && source[start] == shmem[start]) {
+            ++start;
+        }
+        if (start == size) {
+            start    = 0;
+            priority = SPLIT_BATCH_PRIORITY_REFRESH;
+        } else {
+            while (source[end - 1] == shmem[end - 1]) {
+                --end;
+            }
+            memcpy(&shmem[start], &source[start], end - start);
+        }
+    }
+
+    split_batch_pending_t *pending = &split_batch_pending[trans_id];
+    if (pending->end == 0) {
+        pending->start    = start;
+        pending->end      = end;
+        pending->priority = priority;
+    } else {
+        pending->start    = MIN(pending->start, start);
+        pending->end      = MAX(pending->end, end);
+        pending->priority = MIN(pending->priority, priority);
+    }
+    return true;
+}
+
+static bool split_batch_has_pending(split_batch_priority_t max_priority) {
+    for (int8_t i = 0; i < NUM_TOTAL_TRANSACTIONS; ++i) {
+        if (split_batch_pending[i].end != 0 && split_batch_pending[i].priority <= max_priority) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Estimate whether batching the pending data costs less link time than sending it separately.
+ *
+ * Frames are always transferred in full, so a single small change is cheaper to send on its own.
+ */
+static bool split_batch_is_cheaper(void) {
+    uint16_t separate = 0;
+    uint16_t records  = 0;
+    for (int8_t i = 0; i < NUM_TOTAL_TRANSACTIONS; ++i) {
+        split_batch_pending_t *pending = &split_batch_pending[i];
+        if (pending->end == 0) {
+            continue;
+        }
+        uint8_t size  = split_transaction_table[i].initiator2target_buffer_size;
+        uint8_t count = pending->end - pending->start;
+        separate += SPLIT_BATCH_TRANSACTION_OVERHEAD + size;
+        records += (count == size) ? 1 + count : 3 + count;
+    }
+    if (records == 0) {
+        return false;
+    }
+
+    uint16_t frames = (records + SPLIT_BATCH_BUFFER_SIZE - 1) / SPLIT_BATCH_BUFFER_SIZE;
+    return frames * (SPLIT_BATCH_TRANSACTION_OVERHEAD + sizeof(split_batch_frame_t)) < separate;
+}
+
+/**
+ * \brief Send each pending region in its own transaction, highest priority first.
+ */
+static bool split_batch_send_separately(void) {
+    for (uint8_t priority = SPLIT_BATCH_PRIORITY_STATE; priority <= SPLIT_BATCH_PRIORITY_REFRESH; ++priority) {
+        for (int8_t i = 0; i < NUM_TOTAL_TRANSACTIONS; ++i) {
+            split_batch_pending_t *pending = &split_batch_pending[i];
+            if (pending->end == 0 || pending->priority != priority) {
+                continue;
+            }
+            split_transaction_desc_t *trans = &split_transaction_table[i];
+            if (!transport_write(i, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size)) {
+                return false;
+            }
+            pending->start = pending->end = 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Pack as much pending data as fits into a frame, highest priority first.
+ *
+ * \return false if there was nothing to send.
+ */
+static bool split_batch_fill(split_batch_frame_t *frame) {
+    frame->length = 0;
+    for (uint8_t priority = SPLIT_BATCH_PRIORITY_STATE; priority <= SPLIT_BATCH_PRIORITY_REFRESH; ++priority) {
+        for (int8_t i = 0; i < NUM_TOTAL_TRANSACTIONS; ++i) {
+            split_batch_pending_t *pending = &split_batch_pending[i];
+            if (pending->end == 0 || pending->priority != priority) {
+                continue;
+            }
+
+            split_transaction_desc_t *trans  = &split_transaction_table[i];
+            uint8_t                  *record = &frame->data[frame->length];
+            uint8_t                   room   = sizeof(frame->data) - frame->length;
+            uint8_t                   count  = pending->end - pending->start;
+            if (count == trans->initiator2target_buffer_size && count + 1 <= room) {
+                record[0] = i;
+                memcpy(&record[1], split_trans_initiator2target_buffer(trans), count);
+                frame->length += 1 + count;
+            } else if (room > 3) {
+                // Large regions are split across frames if need be.
+                count     = MIN(count, room - 3);
+                record[0] = i | SPLIT_BATCH_RECORD_PARTIAL;
+                record[1] = pending->start;
+                record[2] = count;
+                memcpy(&record[3], split_trans_initiator2target_buffer(trans) + pending->start, count);
+                frame->length += 3 + count;
+            } else {
+                continue;
+            }
+
+            pending->start += count;
+            if (pending->start == pending->end) {
+                pending->start = pending->end = 0;
+            }
+        }
+    }
+    frame->checksum = crc8(&frame->length, sizeof(frame->length) + frame->length);
+    return frame->length > 0;
+}
+
+#endif // SPLIT_TRANSACTION_BATCHING
+
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
     if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
-        okay &= transport_write(trans_id, source, length);
+        okay &= transport_put(trans_id, source, length);
         if (okay) {
             *last_update = timer_read32();
         }
@@ -178,18 +414,19 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
 ////////////////////////////////////////////////////
 // Slave matrix
 
+static uint32_t     slave_matrix_last_update                    = 0;
+static matrix_row_t slave_matrix_last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
-    static uint32_t     last_update                    = 0;
-    static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
-    matrix_row_t        temp_matrix[(MATRIX_ROWS) / 2];       // holding area while we test whether or not checksum is correct
+    matrix_row_t temp_matrix[(MATRIX_ROWS) / 2]; // holding area while we test whether or not checksum is correct
 
-    bool okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    bool okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &slave_matrix_last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
     if (okay) {
         // Checksum matches the received data, save as the last matrix state
-        memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
+        memcpy(slave_matrix_last_matrix, temp_matrix, sizeof(temp_matrix));
     }
     // Copy out the last-known-good matrix state to the slave matrix
-    memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+    memcpy(slave_matrix, slave_matrix_last_matrix, sizeof(slave_matrix_last_matrix));
     return okay;
 }
 
@@ -206,6 +443,81 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+////////////////////////////////////////////////////
+// Batched exchange
+
+#ifdef SPLIT_TRANSACTION_BATCHING
+
+// Runs last in each cycle: everything the other handlers queued is sent in as few frames as possible. The slave
+// matrix has already been polled at the start of the cycle, so none of this delays it.
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    if (!split_batch_is_cheaper()) {
+        return split_batch_send_separately();
+    }
+
+    uint8_t frames = 0;
+    // Lower priority data is limited to SPLIT_BATCH_MAX_FRAMES per cycle, and is otherwise only sent to fill up frames
+    while (frames < SPLIT_BATCH_MAX_FRAMES || split_batch_has_pending(SPLIT_BATCH_PRIORITY_STATE)) {
+        split_batch_pending_t backup[NUM_TOTAL_TRANSACTIONS];
+        split_batch_frame_t   frame;
+
+        memcpy(backup, split_batch_pending, sizeof(backup));
+        if (!split_batch_fill(&frame)) {
+            break;
+        }
+        if (!transport_write(PUT_BATCH, &frame, sizeof(frame))) {
+            // Put the data back so a retry sends it again
+            memcpy(split_batch_pending, backup, sizeof(backup));
+            return false;
+        }
+        ++frames;
+    }
+    return true;
+}
+
+static void batch_handlers_slave_unpack(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    const split_batch_frame_t *frame = (const split_batch_frame_t *)initiator2target_buffer;
+    if (frame->length > sizeof(frame->data) || frame->checksum != crc8(&frame->length, sizeof(frame->length) + frame->length)) {
+        return;
+    }
+
+    uint8_t pos = 0;
+    while (pos < frame->length) {
+        uint8_t header   = frame->data[pos++];
+        int8_t  trans_id = header & SPLIT_BATCH_RECORD_ID_MASK;
+        if (trans_id >= NUM_TOTAL_TRANSACTIONS) {
+            return;
+        }
+
+        split_transaction_desc_t *trans  = &split_transaction_table[trans_id];
+        uint8_t                   offset = 0;
+        uint8_t                   count  = trans->initiator2target_buffer_size;
+        if (header & SPLIT_BATCH_RECORD_PARTIAL) {
+            if (pos + 2 > frame->length) {
+                return;
+            }
+            offset = frame->data[pos++];
+            count  = frame->data[pos++];
+        }
+        if (trans->slave_callback || count == 0 || offset + count > trans->initiator2target_buffer_size || pos + count > frame->length) {
+            return;
+        }
+
+        memcpy(split_trans_initiator2target_buffer(trans) + offset, &frame->data[pos], count);
+        pos += count;
+    }
+}
+
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS [PUT_BATCH] = trans_initiator2target_initializer_cb(batch, batch_handlers_slave_unpack),
+
+#else // SPLIT_TRANSACTION_BATCHING
+
+#    define TRANSACTIONS_BATCH_MASTER()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTION_BATCHING
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -427,7 +739,7 @@ static bool mods_handlers_master(matrix_row_t master_matrix[], matrix_row_t slav
 
     bool okay = true;
     if (mods_need_sync) {
-        okay &= transport_write(PUT_MODS, &new_mods, sizeof(new_mods));
+        okay &= transport_put(PUT_MODS, &new_mods, sizeof(new_mods));
         if (okay) {
             last_update = timer_read32();
         }
@@ -914,6 +1226,47 @@ static void detected_os_handlers_slave(matrix_row_t master_matrix[], matrix_row_
 
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
 
+////////////////////////////////////////////////////
+// LINK SPEED
+
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
+static bool speed_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t last_update = 0;
+    uint8_t         level       = split_link_speed_target();
+    bool            okay        = true;
+
+    // Announced periodically as well, so the slave can tell the master is still reaching it at this speed.
+    if (level != split_link_speed_level() || timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS) {
+        okay = transport_write(PUT_SPEED_LEVEL, &level, sizeof(level));
+        if (okay) {
+            last_update = timer_read32();
+        }
+        split_link_speed_announced(level, okay);
+    }
+    return okay;
+}
+
+static void speed_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    split_link_speed_slave_task(split_shmem->speed_level);
+}
+
+static void speed_level_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    split_link_speed_slave_sync();
+}
+
+#    define TRANSACTIONS_SPEED_MASTER() TRANSACTION_HANDLER_MASTER(speed)
+#    define TRANSACTIONS_SPEED_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(speed)
+#    define TRANSACTIONS_SPEED_REGISTRATIONS [PUT_SPEED_LEVEL] = trans_initiator2target_initializer_cb(speed_level, speed_level_callback),
+
+#else // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
+#    define TRANSACTIONS_SPEED_MASTER()
+#    define TRANSACTIONS_SPEED_SLAVE()
+#    define TRANSACTIONS_SPEED_REGISTRATIONS
+
+#endif // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
 ////////////////////////////////////////////////////
 
 split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
@@ -926,6 +1279,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 
     // clang-format off
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
     TRANSACTIONS_SYNC_TIMER_REGISTRATIONS
@@ -944,6 +1298,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_HAPTIC_REGISTRATIONS
     TRANSACTIONS_ACTIVITY_REGISTRATIONS
     TRANSACTIONS_DETECTED_OS_REGISTRATIONS
+    TRANSACTIONS_SPEED_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -955,6 +1310,9 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRACE_BEGIN(TRACE_TRANSACTIONS_MASTER);
+    // First, so that a link that has stopped working at a higher speed can still fall back.
+    TRANSACTIONS_SPEED_MASTER();
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -974,6 +1332,8 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_HAPTIC_MASTER();
     TRANSACTIONS_ACTIVITY_MASTER();
     TRANSACTIONS_DETECTED_OS_MASTER();
+    TRANSACTIONS_BATCH_MASTER();
+    TRACE_END(TRACE_TRANSACTIONS_MASTER);
     return true;
 }
 
@@ -997,6 +1357,7 @@ void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[
     TRANSACTIONS_HAPTIC_SLAVE();
     TRANSACTIONS_ACTIVITY_SLAVE();
     TRANSACTIONS_DETECTED_OS_SLAVE();
+    TRANSACTIONS_SPEED_SLAVE();
 }
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
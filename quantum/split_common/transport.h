@@ -57,6 +57,18 @@ typedef struct _split_slave_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+#    ifndef SPLIT_BATCH_BUFFER_SIZE
+#        define SPLIT_BATCH_BUFFER_SIZE 32
+#    endif // SPLIT_BATCH_BUFFER_SIZE
+
+typedef struct _split_batch_frame_t {
+    uint8_t checksum;
+    uint8_t length;
+    uint8_t data[SPLIT_BATCH_BUFFER_SIZE];
+} split_batch_frame_t;
+#endif // SPLIT_TRANSACTION_BATCHING
+
 #ifdef SPLIT_TRANSPORT_MIRROR
 typedef struct _split_master_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
@@ -153,6 +165,9 @@ typedef struct _split_shared_memory_t {
 #endif // USE_I2C
 
     split_slave_matrix_sync_t smatrix;
+#ifdef SPLIT_TRANSACTION_BATCHING
+    split_batch_frame_t batch;
+#endif // SPLIT_TRANSACTION_BATCHING
 
 #ifdef SPLIT_TRANSPORT_MIRROR
     split_master_matrix_sync_t mmatrix;
@@ -222,6 +237,10 @@ typedef struct _split_shared_memory_t {
     split_slave_activity_sync_t activity_sync;
 #endif // defined(SPLIT_ACTIVITY_ENABLE)
 
+#if defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+    uint8_t speed_level;
+#endif // defined(SPLIT_SPEED_NEGOTIATION_ENABLE)
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
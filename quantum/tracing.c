@@ -0,0 +1,342 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "tracing.h"
+#include "timer.h"
+#include "print.h"
+#include "util.h"
+
+#if defined(TRACING_TIMESTAMP)
+// Supplied by the keyboard or user.
+#elif defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    define TRACING_TIMESTAMP() ((uint32_t)chSysGetRealtimeCounterX())
+#elif defined(PROTOCOL_ARM_ATSAM)
+#    include "samd51j18a.h"
+#    define TRACING_TIMESTAMP() (DWT->CYCCNT)
+#    define TRACING_NEEDS_DWT_INIT
+#elif defined(__AVR__)
+#    include "timer_avr.h"
+static uint32_t tracing_avr_timestamp(void) {
+    uint32_t ms;
+    uint8_t  raw;
+    // Re-read if the millisecond interrupt fired between the two reads.
+    do {
+        ms  = timer_read32();
+        raw = TIMER_RAW;
+    } while (ms != timer_read32());
+    // In CTC mode the counter runs from 0 to TIMER_RAW_TOP inclusive, so each millisecond is TIMER_RAW_TOP + 1 ticks.
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+}
+#    define TRACING_TIMESTAMP() tracing_avr_timestamp()
+#else
+#    define TRACING_TIMESTAMP() timer_read32()
+#endif
+
+_Static_assert(TRACE_POINT_COUNT <= 255, "Too many trace points");
+_Static_assert(TRACING_HISTOGRAM_BUCKETS <= 33, "TRACING_HISTOGRAM_BUCKETS must not exceed 33");
+_Static_assert(TRACING_LATENCY_PENDING_EDGES > 0, "TRACING_LATENCY_PENDING_EDGES must be at least 1");
+_Static_assert(TRACING_SAMPLE_BUFFER_SIZE > 0 && TRACING_SAMPLE_BUFFER_SIZE <= 255, "TRACING_SAMPLE_BUFFER_SIZE must be between 1 and 255");
+
+typedef struct trace_point_state_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+    uint16_t histogram[TRACING_HISTOGRAM_BUCKETS];
+} trace_point_state_t;
+
+#define TRACING_POINT_NAME(id, name) [TRACE_##id] = name,
+
+static const char *const trace_point_names[TRACE_POINT_COUNT] = {TRACING_BUILTIN_POINTS(TRACING_POINT_NAME) TRACING_USER_POINTS(TRACING_POINT_NAME)};
+
+static trace_point_state_t trace_points[TRACE_POINT_COUNT];
+static trace_sample_t      trace_samples[TRACING_SAMPLE_BUFFER_SIZE];
+static uint8_t             trace_sample_head  = 0;
+static uint8_t             trace_sample_count = 0;
+static uint32_t            trace_window_start = 0;
+
+typedef struct latency_edge_t {
+    uint32_t timestamp;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed : 1;
+    bool     pending : 1;
+    bool     fresh : 1;
+} latency_edge_t;
+
+static latency_edge_t  latency_edges[TRACING_LATENCY_PENDING_EDGES];
+static latency_edge_t *latency_current     = NULL;
+static trace_point_t   latency_source      = TRACE_LATENCY_MATRIX;
+static trace_point_t   latency_held_source = TRACE_LATENCY_TAP_HOLD;
+static uint8_t         latency_depth       = 0;
+
+uint32_t tracing_timestamp(void) {
+    return TRACING_TIMESTAMP();
+}
+
+void tracing_reset(void) {
+    memset(trace_points, 0, sizeof(trace_points));
+    for (uint8_t i = 0; i < TRACE_POINT_COUNT; ++i) {
+        trace_points[i].min = UINT32_MAX;
+    }
+    trace_sample_head  = 0;
+    trace_sample_count = 0;
+    trace_window_start = tracing_timestamp();
+
+    memset(latency_edges, 0, sizeof(latency_edges));
+    latency_current = NULL;
+}
+
+void tracing_init(void) {
+#ifdef TRACING_NEEDS_DWT_INIT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    tracing_reset();
+}
+
+static uint8_t tracing_bucket(uint32_t ticks) {
+    // Bucket n holds values in [2^(n-1), 2^n), bucket 0 holds zero.
+    uint8_t bucket = 0;
+    while (ticks) {
+        ticks >>= 1;
+        ++bucket;
+    }
+    return MIN(bucket, TRACING_HISTOGRAM_BUCKETS - 1);
+}
+
+void tracing_record(trace_point_t point, uint32_t ticks) {
+    if (point >= TRACE_POINT_COUNT) {
+        return;
+    }
+
+    trace_point_state_t *state = &trace_points[point];
+    state->count++;
+    state->total += ticks;
+    if (ticks < state->min) state->min = ticks;
+    if (ticks > state->max) state->max = ticks;
+
+    uint16_t *bucket = &state->histogram[tracing_bucket(ticks)];
+    if (*bucket == UINT16_MAX) {
+        // Halve the whole histogram so the distribution is preserved without overflowing.
+        for (uint8_t i = 0; i < TRACING_HISTOGRAM_BUCKETS; ++i) {
+            state->histogram[i] >>= 1;
+        }
+    }
+    (*bucket)++;
+
+    trace_samples[trace_sample_head] = (trace_sample_t){.point = point, .ticks = ticks};
+    trace_sample_head                = (trace_sample_head + 1) % TRACING_SAMPLE_BUFFER_SIZE;
+    if (trace_sample_count < TRACING_SAMPLE_BUFFER_SIZE) {
+        trace_sample_count++;
+    }
+}
+
+static uint32_t tracing_percentile(const trace_point_state_t *state, uint8_t percent) {
+    uint32_t population = 0;
+    for (uint8_t i = 0; i < TRACING_HISTOGRAM_BUCKETS; ++i) {
+        population += state->histogram[i];
+    }
+    uint32_t target = (population * percent + 99) / 100;
+    uint32_t seen   = 0;
+    for (uint8_t i = 0; i < TRACING_HISTOGRAM_BUCKETS; ++i) {
+        seen += state->histogram[i];
+        if (seen >= target && state->histogram[i]) {
+            // Report the upper bound of the bucket, but never beyond what was actually observed.
+            uint32_t upper = (i == 0) ? 0 : (i >= 32 ? UINT32_MAX : ((uint32_t)1 << i) - 1);
+            return MIN(upper, state->max);
+        }
+    }
+    return state->max;
+}
+
+bool tracing_get_stats(trace_point_t point, trace_stats_t *stats) {
+    if (point >= TRACE_POINT_COUNT) {
+        return false;
+    }
+
+    const trace_point_state_t *state = &trace_points[point];
+    if (state->count == 0) {
+        memset(stats, 0, sizeof(trace_stats_t));
+        return true;
+    }
+
+    stats->count = state->count;
+    stats->min   = state->min;
+    stats->max   = state->max;
+    stats->total = state->total;
+    stats->avg   = state->total / state->count;
+    stats->p99   = tracing_percentile(state, 99);
+    return true;
+}
+
+uint32_t tracing_get_window(void) {
+    return tracing_timestamp() - trace_window_start;
+}
+
+bool tracing_get_sample(uint8_t index, trace_sample_t *sample) {
+    if (index >= trace_sample_count) {
+        return false;
+    }
+    uint8_t slot = (trace_sample_head + TRACING_SAMPLE_BUFFER_SIZE - 1 - index) % TRACING_SAMPLE_BUFFER_SIZE;
+    *sample      = trace_samples[slot];
+    return true;
+}
+
+const char *tracing_get_name(trace_point_t point) {
+    if (point >= TRACE_POINT_COUNT) {
+        return "unknown";
+    }
+    return trace_point_names[point];
+}
+
+void tracing_dump(void) {
+#ifdef CONSOLE_ENABLE
+    uint32_t window = tracing_get_window();
+    uprintf("tracing: window %lu ticks\n", (unsigned long)window);
+    for (uint8_t i = 0; i < TRACE_POINT_COUNT; ++i) {
+        trace_stats_t stats;
+        tracing_get_stats(i, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+        uint8_t share = window ? (uint8_t)MIN(100, ((uint64_t)stats.total * 100) / window) : 0;
+        uprintf("%s: n=%lu min=%lu avg=%lu p99=%lu max=%lu share=%u%%\n", tracing_get_name(i), (unsigned long)stats.count, (unsigned long)stats.min, (unsigned long)stats.avg, (unsigned long)stats.p99, (unsigned long)stats.max, share);
+    }
+#endif
+}
+
+static latency_edge_t *tracing_latency_slot(uint8_t row, uint8_t col, bool pressed, uint32_t now) {
+    latency_edge_t *unused = NULL;
+    latency_edge_t *oldest = &latency_edges[0];
+    for (uint8_t i = 0; i < TRACING_LATENCY_PENDING_EDGES; ++i) {
+        latency_edge_t *edge = &latency_edges[i];
+        if (!edge->pending) {
+            if (!unused) unused = edge;
+            continue;
+        }
+        // A repeated edge supersedes one that was never reported, eg. the key press eaten by a combo.
+        if (edge->row == row && edge->col == col && edge->pressed == pressed) {
+            return edge;
+        }
+        if (now - edge->timestamp > now - oldest->timestamp) {
+            oldest = edge;
+        }
+    }
+    return unused ? unused : oldest;
+}
+
+void tracing_latency_edge(uint8_t row, uint8_t col, bool pressed) {
+    uint32_t        now  = tracing_timestamp();
+    latency_edge_t *edge = tracing_latency_slot(row, col, pressed, now);
+    *edge                = (latency_edge_t){.timestamp = now, .row = row, .col = col, .pressed = pressed, .pending = true, .fresh = true};
+}
+
+void tracing_latency_settle(void) {
+    for (uint8_t i = 0; i < TRACING_LATENCY_PENDING_EDGES; ++i) {
+        latency_edges[i].fresh = false;
+    }
+}
+
+void tracing_latency_begin(uint8_t row, uint8_t col, bool pressed, bool combo) {
+    // Records processed from within another record belong to the outer one.
+    if (latency_depth++ > 0) {
+        return;
+    }
+
+    latency_current = NULL;
+    uint32_t now    = tracing_timestamp();
+    for (uint8_t i = 0; i < TRACING_LATENCY_PENDING_EDGES; ++i) {
+        latency_edge_t *edge = &latency_edges[i];
+        if (!edge->pending || edge->pressed != pressed) {
+            continue;
+        }
+        if (combo) {
+            // The combo fires on the edge that completed it.
+            if (!latency_current || now - edge->timestamp < now - latency_current->timestamp) {
+                latency_current = edge;
+            }
+        } else if (edge->row == row && edge->col == col) {
+            latency_current = edge;
+            break;
+        }
+    }
+
+    if (!latency_current) {
+        return;
+    }
+    if (combo) {
+        latency_source = TRACE_LATENCY_COMBO;
+    } else if (latency_current->fresh) {
+        latency_source = TRACE_LATENCY_MATRIX;
+    } else {
+        latency_source = latency_held_source;
+    }
+}
+
+void tracing_latency_end(void) {
+    if (latency_depth == 0 || --latency_depth > 0) {
+        return;
+    }
+    if (latency_current) {
+        latency_current->pending = false;
+        latency_current          = NULL;
+    }
+}
+
+trace_point_t tracing_latency_hold(trace_point_t point) {
+    trace_point_t previous = latency_held_source;
+    latency_held_source    = point;
+    return previous;
+}
+
+void tracing_latency_report(void) {
+    if (!latency_current || !latency_current->pending) {
+        return;
+    }
+    tracing_record(latency_source, tracing_timestamp() - latency_current->timestamp);
+    latency_current->pending = false;
+}
+
+static void tracing_pack_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value & 0xFF;
+    dest[1] = (value >> 8) & 0xFF;
+    dest[2] = (value >> 16) & 0xFF;
+    dest[3] = (value >> 24) & 0xFF;
+}
+
+void tracing_raw_hid_fill(uint8_t *data, uint8_t length) {
+    if (length < 23) {
+        return;
+    }
+
+    trace_point_t point = data[1];
+    trace_stats_t stats = {0};
+    tracing_get_stats(point, &stats);
+
+    data[2] = TRACE_POINT_COUNT;
+    tracing_pack_u32(&data[3], stats.count);
+    tracing_pack_u32(&data[7], stats.min);
+    tracing_pack_u32(&data[11], stats.max);
+    tracing_pack_u32(&data[15], stats.avg);
+    tracing_pack_u32(&data[19], stats.p99);
+
+    memset(&data[23], 0, length - 23);
+    if (point < TRACE_POINT_COUNT) {
+        strncpy((char *)&data[23], tracing_get_name(point), length - 23);
+    }
+}
+
+void tracing_task(void) {
+#ifdef TRACING_DUMP_INTERVAL
+    static uint32_t last_dump = 0;
+    if (timer_elapsed32(last_dump) >= TRACING_DUMP_INTERVAL) {
+        last_dump = timer_read32();
+        tracing_dump();
+        tracing_reset();
+    }
+#endif
+}
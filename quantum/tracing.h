@@ -0,0 +1,258 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \file
+ *
+ * \defgroup tracing Hot-path tracing
+ *
+ * Statically registered trace points that record how many timestamp ticks are
+ * spent in a region of code. Each trace point keeps min/max/average figures as
+ * well as a log2 histogram used to estimate the 99th percentile, and every
+ * sample is also pushed into a fixed-size ring buffer so the most recent raw
+ * durations can be inspected.
+ *
+ * Ticks are CPU cycles on ChibiOS and arm_atsam, raw timer0 ticks on AVR, and
+ * milliseconds on the test platform. Define `TRACING_TIMESTAMP()` to supply a
+ * different source.
+ *
+ * Usage example:
+ *
+ *     TRACE_CALL(TRACE_MATRIX_SCAN, matrix_scan());
+ *
+ *     TRACE_BEGIN(TRACE_DEBOUNCE);
+ *     changed = debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+ *     TRACE_END(TRACE_DEBOUNCE);
+ *
+ * Additional trace points can be registered from `config.h`:
+ *
+ *     #define TRACING_USER_POINTS(X) X(OLED_TASK, "oled_task") X(MY_HOOK, "my_hook")
+ *
+ * which makes `TRACE_OLED_TASK` and `TRACE_MY_HOOK` available.
+ *
+ * The `TRACE_LATENCY_*` points are not durations of a region of code, but the
+ * time from a debounced matrix edge to the first keyboard report it caused,
+ * split by whether the key went straight through, was resolved as part of a
+ * combo, or was held back by tap-hold processing.
+ * \{
+ */
+
+#ifndef TRACING_HISTOGRAM_BUCKETS
+#    define TRACING_HISTOGRAM_BUCKETS 24
+#endif // TRACING_HISTOGRAM_BUCKETS
+
+#ifndef TRACING_SAMPLE_BUFFER_SIZE
+#    define TRACING_SAMPLE_BUFFER_SIZE 32
+#endif // TRACING_SAMPLE_BUFFER_SIZE
+
+#define TRACING_BUILTIN_POINTS(X)                 \
+    X(MATRIX_SCAN, "matrix_scan")                 \
+    X(DEBOUNCE, "debounce")                       \
+    X(ACTION_EXEC, "action_exec")                 \
+    X(PROCESS_RECORD, "process_record")           \
+    X(RGB_MATRIX_TASK, "rgb_matrix_task")         \
+    X(TRANSACTIONS_MASTER, "transactions_master") \
+    X(LATENCY_MATRIX, "latency_matrix")           \
+    X(LATENCY_COMBO, "latency_combo")             \
+    X(LATENCY_TAP_HOLD, "latency_tap_hold")
+
+#ifndef TRACING_LATENCY_PENDING_EDGES
+#    define TRACING_LATENCY_PENDING_EDGES 8
+#endif // TRACING_LATENCY_PENDING_EDGES
+
+#ifndef TRACING_USER_POINTS
+#    define TRACING_USER_POINTS(X)
+#endif // TRACING_USER_POINTS
+
+#define TRACING_POINT_ENUM(id, name) TRACE_##id,
+
+// clang-format off
+typedef enum trace_point_t {
+    TRACING_BUILTIN_POINTS(TRACING_POINT_ENUM)
+    TRACING_USER_POINTS(TRACING_POINT_ENUM)
+    TRACE_POINT_COUNT
+} trace_point_t;
+// clang-format on
+
+/**
+ * \brief Aggregated statistics for a single trace point, in timestamp ticks.
+ */
+typedef struct trace_stats_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t avg;
+    uint32_t p99;
+    uint32_t total;
+} trace_stats_t;
+
+/**
+ * \brief A raw sample, as stored in the ring buffer.
+ */
+typedef struct trace_sample_t {
+    uint8_t  point;
+    uint32_t ticks;
+} trace_sample_t;
+
+#ifdef TRACING_ENABLE
+
+/**
+ * \brief Read the current timestamp, in ticks.
+ */
+uint32_t tracing_timestamp(void);
+
+/**
+ * \brief Initialise the tracing subsystem, including the timestamp source.
+ */
+void tracing_init(void);
+
+/**
+ * \brief Periodic housekeeping. Dumps statistics to the console every `TRACING_DUMP_INTERVAL` milliseconds, if defined.
+ */
+void tracing_task(void);
+
+/**
+ * \brief Record a single sample against a trace point.
+ *
+ * \param point The trace point to record against.
+ * \param ticks The duration of the sample, in timestamp ticks.
+ */
+void tracing_record(trace_point_t point, uint32_t ticks);
+
+/**
+ * \brief Clear all recorded statistics and the sample ring buffer.
+ */
+void tracing_reset(void);
+
+/**
+ * \brief Retrieve the aggregated statistics for a trace point.
+ *
+ * \return false if the trace point is invalid.
+ */
+bool tracing_get_stats(trace_point_t point, trace_stats_t *stats);
+
+/**
+ * \brief Number of timestamp ticks elapsed since the statistics were last reset.
+ */
+uint32_t tracing_get_window(void);
+
+/**
+ * \brief Retrieve a sample from the ring buffer.
+ *
+ * \param index 0 is the most recent sample, 1 the one before it, and so on.
+ * \return false if there is no sample at that index.
+ */
+bool tracing_get_sample(uint8_t index, trace_sample_t *sample);
+
+/**
+ * \brief The printable name of a trace point.
+ */
+const char *tracing_get_name(trace_point_t point);
+
+/**
+ * \brief Print the statistics for every trace point over console.
+ */
+void tracing_dump(void);
+
+/**
+ * \brief Fill a raw HID report with the statistics for the trace point given in `data[1]`.
+ *
+ * The reply layout is: `data[1]` trace point, `data[2]` trace point count, followed
+ * by count, min, max, avg and p99 as little-endian uint32_t, then as much of the
+ * trace point's name as fits. Intended to be called from `raw_hid_receive()` or
+ * `via_command_kb()`, before calling `raw_hid_send()`.
+ */
+void tracing_raw_hid_fill(uint8_t *data, uint8_t length);
+
+/**
+ * \brief Note a debounced matrix edge, before it is passed to `action_exec()`.
+ */
+void tracing_latency_edge(uint8_t row, uint8_t col, bool pressed);
+
+/**
+ * \brief Note that `action_exec()` has returned for the edges noted so far. Edges still pending after this were held back.
+ */
+void tracing_latency_settle(void);
+
+/**
+ * \brief Associate the record about to be processed with the matrix edge that caused it.
+ *
+ * \param combo true for combo events, which are matched against the most recent pending edge rather than by position.
+ */
+void tracing_latency_begin(uint8_t row, uint8_t col, bool pressed, bool combo);
+
+/**
+ * \brief Finish processing a record. Its edge is dropped whether or not it caused a report.
+ */
+void tracing_latency_end(void);
+
+/**
+ * \brief Set the latency trace point for edges held back and released by a buffer other than the tapping code.
+ *
+ * \return The previous trace point, to be restored afterwards.
+ */
+trace_point_t tracing_latency_hold(trace_point_t point);
+
+/**
+ * \brief Record the latency of the record being processed, if this is the first report it has caused.
+ */
+void tracing_latency_report(void);
+
+#    define TRACE_BEGIN(point) uint32_t trace_start_##point = tracing_timestamp()
+#    define TRACE_END(point) tracing_record((point), tracing_timestamp() - trace_start_##point)
+#    define TRACE_CALL(point, call)  \
+        do {                         \
+            TRACE_BEGIN(point);      \
+            do {                     \
+                call;                \
+            } while (0);             \
+            TRACE_END(point);        \
+        } while (0)
+
+#    define TRACE_KEY_EDGE(row, col, pressed, call)  \
+        do {                                         \
+            tracing_latency_edge(row, col, pressed); \
+            do {                                     \
+                call;                                \
+            } while (0);                             \
+            tracing_latency_settle();                \
+        } while (0)
+#    define TRACE_LATENCY_BEGIN(row, col, pressed, combo) tracing_latency_begin(row, col, pressed, combo)
+#    define TRACE_LATENCY_END() tracing_latency_end()
+#    define TRACE_LATENCY_HOLD(point, call)                                      \
+        do {                                                                     \
+            trace_point_t trace_latency_hold_prev = tracing_latency_hold(point); \
+            do {                                                                 \
+                call;                                                            \
+            } while (0);                                                         \
+            tracing_latency_hold(trace_latency_hold_prev);                       \
+        } while (0)
+#    define TRACE_LATENCY_REPORT() tracing_latency_report()
+
+#else
+
+#    define TRACE_BEGIN(point)
+#    define TRACE_END(point)
+#    define TRACE_CALL(point, call) \
+        do {                        \
+            call;                   \
+        } while (0)
+#    define TRACE_KEY_EDGE(row, col, pressed, call) \
+        do {                                        \
+            call;                                   \
+        } while (0)
+#    define TRACE_LATENCY_BEGIN(row, col, pressed, combo)
+#    define TRACE_LATENCY_END()
+#    define TRACE_LATENCY_HOLD(point, call) \
+        do {                                \
+            call;                           \
+        } while (0)
+#    define TRACE_LATENCY_REPORT()
+
+#endif // TRACING_ENABLE
+
+/** \} */
@@ -106,12 +106,15 @@ void via_init(void) {
 void eeconfig_init_via(void) {
     // set the magic number to false, in case this gets interrupted
     via_eeprom_set_valid(false);
+    eeprom_txn_begin();
     // This resets the layout options
     via_set_layout_options(VIA_EEPROM_LAYOUT_OPTIONS_DEFAULT);
     // This resets the keymaps in EEPROM to what is in flash.
     dynamic_keymap_reset();
     // This resets the macros in EEPROM to nothing.
     dynamic_keymap_macro_reset();
+    // Everything else has to have been written back before the magic number is saved
+    eeprom_txn_commit();
     // Save the magic number last, in case saving was interrupted
     via_eeprom_set_valid(true);
 }
@@ -20,9 +20,12 @@ void MockBackingStore::reset_instance() {
 
     backing_init_invoke_count   = 0;
     backing_unlock_invoke_count = 0;
-    backing_erase_invoke_count  = 0;
-    backing_write_invoke_count  = 0;
-    backing_lock_invoke_count   = 0;
+    backing_erase_invoke_count       = 0;
+    backing_erase_block_invoke_count = 0;
+    backing_write_invoke_count       = 0;
+    backing_lock_invoke_count        = 0;
+    backing_read_invoke_count        = 0;
+    backing_read_element_count       = 0;
 
     init_success_callback   = [](std::uint64_t) { return true; };
     erase_success_callback  = [](std::uint64_t) { return true; };
@@ -75,6 +78,28 @@ bool MockBackingStore::erase(void) {
     return true;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+bool MockBackingStore::erase_block(uint32_t address) {
+    ++backing_erase_block_invoke_count;
+
+    EXPECT_TRUE(address % BACKING_STORE_ERASE_SIZE == 0) << "Supplied address was not aligned with the erase size";
+    EXPECT_TRUE(address + BACKING_STORE_ERASE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
+    EXPECT_FALSE(is_locked()) << "Erase was attempted without being unlocked first";
+
+    // Erase each slot within the block
+    for (std::size_t i = address / BACKING_STORE_WRITE_SIZE; i < (address + BACKING_STORE_ERASE_SIZE) / BACKING_STORE_WRITE_SIZE; ++i) {
+        // Drop out of erase early with failure if we need to
+        if (erase_success_callback && !erase_success_callback(backing_erase_block_invoke_count)) {
+            return false;
+        }
+
+        backing_storage[i].erase();
+    }
+
+    return true;
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
     ++backing_write_invoke_count;
 
@@ -122,6 +147,28 @@ bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const
     std::size_t index = address / BACKING_STORE_WRITE_SIZE;
     value             = ~backing_storage[index].get();
 
+    // Keep track of the number of transactions and amount of data read
+    ++backing_read_invoke_count;
+    ++backing_read_element_count;
+
+    return true;
+}
+
+bool MockBackingStore::read_bulk(uint32_t address, backing_store_int_t* values, std::size_t item_count) const {
+    // precondition: value's buffer size already matches BACKING_STORE_WRITE_SIZE
+    EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0) << "Supplied address was not aligned with the backing store integral size";
+    EXPECT_TRUE(address + item_count * BACKING_STORE_WRITE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
+
+    // Read and take the complement as we're simulating flash memory -- 0xFF means 0x00
+    std::size_t index = address / BACKING_STORE_WRITE_SIZE;
+    for (std::size_t i = 0; i < item_count; ++i) {
+        values[i] = ~backing_storage[index + i].get();
+    }
+
+    // Keep track of the number of transactions and amount of data read
+    ++backing_read_invoke_count;
+    backing_read_element_count += item_count;
+
     return true;
 }
 
@@ -141,6 +188,12 @@ extern "C" bool backing_store_erase(void) {
     return MockBackingStore::Instance().erase();
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+extern "C" bool backing_store_erase_block(uint32_t address) {
+    return MockBackingStore::Instance().erase_block(address);
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 extern "C" bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return MockBackingStore::Instance().write(address, value);
 }
@@ -152,3 +205,7 @@ extern "C" bool backing_store_lock(void) {
 extern "C" bool backing_store_read(uint32_t address, backing_store_int_t* value) {
     return MockBackingStore::Instance().read(address, *value);
 }
+
+extern "C" bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count) {
+    return MockBackingStore::Instance().read_bulk(address, values, item_count);
+}
@@ -94,8 +94,12 @@ class MockBackingStore {
     std::uint64_t backing_init_invoke_count;
     std::uint64_t backing_unlock_invoke_count;
     std::uint64_t backing_erase_invoke_count;
+    std::uint64_t backing_erase_block_invoke_count;
     std::uint64_t backing_write_invoke_count;
     std::uint64_t backing_lock_invoke_count;
+    mutable std::uint64_t backing_read_invoke_count;
+    // The total number of elements read from the backing store
+    mutable std::uint64_t backing_read_element_count;
 
     // Whether init should succeed
     std::function<bool(std::uint64_t)> init_success_callback;
@@ -141,12 +145,25 @@ class MockBackingStore {
     std::uint64_t erase_invoke_count() const {
         return backing_erase_invoke_count;
     }
+    std::uint64_t erase_block_invoke_count() const {
+        return backing_erase_block_invoke_count;
+    }
     std::uint64_t write_invoke_count() const {
         return backing_write_invoke_count;
     }
     std::uint64_t lock_invoke_count() const {
         return backing_lock_invoke_count;
     }
+    std::uint64_t read_invoke_count() const {
+        return backing_read_invoke_count;
+    }
+    std::uint64_t read_element_count() const {
+        return backing_read_element_count;
+    }
+    void reset_read_counts() {
+        backing_read_invoke_count  = 0;
+        backing_read_element_count = 0;
+    }
 
     // Clear out the internal data for the next run
     void reset_instance();
@@ -159,9 +176,13 @@ class MockBackingStore {
     bool init();
     bool unlock();
     bool erase();
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    bool erase_block(std::uint32_t address);
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
     bool write(std::uint32_t address, backing_store_int_t value);
     bool lock();
     bool read(std::uint32_t address, backing_store_int_t& value) const;
+    bool read_bulk(std::uint32_t address, backing_store_int_t* values, std::size_t item_count) const;
 
     // Control over when init/writes/erases should succeed
     void set_init_callback(std::function<bool(std::uint64_t)> callback) {
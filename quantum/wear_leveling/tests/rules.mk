@@ -63,4 +63,29 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+wear_leveling_background_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DWEAR_LEVELING_BACKGROUND_CONSOLIDATION \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DBACKING_STORE_ERASE_SIZE=32 \
+	-DWEAR_LEVELING_BACKING_SIZE=256 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=32 \
+	-DWEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE=8
+wear_leveling_background_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_background.cpp
+wear_leveling_background_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_playback_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=32768 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=4096
+wear_leveling_playback_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_playback.cpp
+wear_leveling_playback_INC := \
+	$(wear_leveling_common_INC)
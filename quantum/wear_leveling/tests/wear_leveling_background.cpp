@@ -0,0 +1,221 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <cstring>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+extern "C" {
+#include "timer.h"
+void advance_time(uint32_t ms);
+}
+
+// Each erased element costs a millisecond, so that erase time is proportional to the amount erased
+using MOCK_ERASE_TIME_PER_ELEMENT = std::integral_constant<std::uint32_t, 1>;
+// Number of tasks needed to erase a region, copy into it, and erase the old region
+using CONSOLIDATION_TASK_COUNT = std::integral_constant<std::size_t, 2 * (WEAR_LEVELING_REGION_SIZE / BACKING_STORE_ERASE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE / WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE)>;
+
+class WearLevelingBackground : public ::testing::Test {
+   protected:
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected;
+    std::uint32_t                                        seed;
+
+    void SetUp() override {
+        auto& inst = MockBackingStore::Instance();
+        inst.reset_instance();
+        inst.set_erase_callback([](std::uint64_t) {
+            advance_time(MOCK_ERASE_TIME_PER_ELEMENT::value);
+            return true;
+        });
+        expected.fill(0);
+        seed = 1;
+        wear_leveling_init();
+    }
+
+    // Performs a pseudo-random write, keeping track of the expected logical contents
+    wear_leveling_status_t random_write() {
+        seed                  = seed * 1103515245 + 12345;
+        std::uint32_t address = (seed >> 8) % (WEAR_LEVELING_LOGICAL_SIZE - 1);
+        std::uint8_t  value[] = {(std::uint8_t)(seed >> 16), (std::uint8_t)(seed >> 24)};
+        std::memcpy(&expected[address], value, sizeof(value));
+        return wear_leveling_write(address, value, sizeof(value));
+    }
+
+    // Writes until a background consolidation has been kicked off, without letting it progress
+    void fill_to_headroom() {
+        auto& inst = MockBackingStore::Instance();
+        while (inst.erase_block_invoke_count() == 0) {
+            EXPECT_EQ(random_write(), WEAR_LEVELING_SUCCESS) << "Write should not have needed to consolidate";
+            wear_leveling_task();
+        }
+    }
+
+    void expect_contents() {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(actual, expected) << "Invalid readback";
+    }
+};
+
+/**
+ * This test verifies that with the housekeeping task running, writes never erase the backing store themselves.
+ */
+TEST_F(WearLevelingBackground, WritesDoNotBlockOnErase) {
+    auto& inst = MockBackingStore::Instance();
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(random_write(), WEAR_LEVELING_SUCCESS) << "Write should not have needed to consolidate";
+        wear_leveling_task();
+    }
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    EXPECT_GT(stats.consolidations, 0) << "Background consolidation should have occurred";
+    EXPECT_EQ(stats.max_write_time, 0) << "Writes should never have waited on an erase";
+    EXPECT_EQ(stats.max_task_time, MOCK_ERASE_TIME_PER_ELEMENT::value * (BACKING_STORE_ERASE_SIZE / BACKING_STORE_WRITE_SIZE)) << "Each task should erase at most one block";
+    EXPECT_EQ(inst.erase_invoke_count(), 0) << "The whole backing store should never have been erased";
+
+    expect_contents();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that without the housekeeping task, consolidation still occurs inline once the write log is full.
+ */
+TEST_F(WearLevelingBackground, InlineFallbackWhenLogFull) {
+    bool consolidated = false;
+    for (int i = 0; i < 1000 && !consolidated; ++i) {
+        wear_leveling_status_t status = random_write();
+        EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Write should not have failed";
+        consolidated = status == WEAR_LEVELING_CONSOLIDATED;
+    }
+    EXPECT_TRUE(consolidated) << "Write should have consolidated";
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    EXPECT_EQ(stats.consolidations, 1) << "Exactly one consolidation should have occurred";
+    EXPECT_EQ(stats.max_write_time, MOCK_ERASE_TIME_PER_ELEMENT::value * (WEAR_LEVELING_REGION_SIZE / BACKING_STORE_WRITE_SIZE)) << "Inline consolidation should have waited for the inactive region to be erased";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that writes made while the cache is being copied are not lost, including those to already-copied areas.
+ */
+TEST_F(WearLevelingBackground, WritesDuringCopyArePreserved) {
+    fill_to_headroom();
+
+    wear_leveling_stats_t stats;
+    do {
+        EXPECT_EQ(random_write(), WEAR_LEVELING_SUCCESS) << "Write should not have needed to consolidate";
+        wear_leveling_task();
+        wear_leveling_get_stats(&stats);
+    } while (stats.consolidations == 0);
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that writes to already-copied areas are not lost if the write log fills part-way through a copy.
+ */
+TEST_F(WearLevelingBackground, LogFullDuringCopy) {
+    fill_to_headroom();
+
+    // Finish erasing, then copy the first chunk only
+    for (std::size_t i = 1; i < (WEAR_LEVELING_REGION_SIZE / BACKING_STORE_ERASE_SIZE) + 1; ++i) {
+        EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task should not have failed";
+    }
+
+    wear_leveling_status_t status;
+    std::uint8_t           value = 0;
+    do {
+        expected[0] = ++value;
+        status      = wear_leveling_write(0, &value, sizeof(value));
+        EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Write should not have failed";
+    } while (status != WEAR_LEVELING_CONSOLIDATED);
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that once the write log is full and consolidation keeps failing, writes fail rather than running past the end of the log.
+ */
+TEST_F(WearLevelingBackground, FailedConsolidationDoesNotOverrunLog) {
+    auto&         inst              = MockBackingStore::Instance();
+    bool          erase_fails       = true;
+    std::uint32_t max_write_address = 0;
+    inst.set_erase_callback([&erase_fails](std::uint64_t) { return !erase_fails; });
+    inst.set_write_callback([&max_write_address](std::uint64_t, std::uint32_t address) {
+        max_write_address = std::max(max_write_address, address);
+        return true;
+    });
+
+    wear_leveling_status_t status;
+    do {
+        status = random_write();
+    } while (status == WEAR_LEVELING_SUCCESS);
+    EXPECT_EQ(status, WEAR_LEVELING_FAILED) << "Write should have failed to consolidate";
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(random_write(), WEAR_LEVELING_FAILED) << "Write should have failed to consolidate";
+    }
+    EXPECT_LT(max_write_address, WEAR_LEVELING_REGION_SIZE) << "Write went past the end of the active write log";
+
+    erase_fails = false;
+    EXPECT_EQ(random_write(), WEAR_LEVELING_CONSOLIDATED) << "Write should have consolidated";
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that losing power at any point during a background consolidation does not lose data.
+ */
+TEST_F(WearLevelingBackground, PowerLossDuringConsolidation) {
+    for (std::size_t steps = 0; steps <= CONSOLIDATION_TASK_COUNT::value; ++steps) {
+        SetUp();
+        fill_to_headroom();
+        for (std::size_t i = 0; i < steps; ++i) {
+            EXPECT_EQ(random_write(), WEAR_LEVELING_SUCCESS) << "Write should not have needed to consolidate";
+            wear_leveling_task();
+        }
+
+        // Re-init, as if power was lost mid-way through
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        expect_contents();
+
+        // Carry on as normal afterwards -- any erase progress was lost, so the log may fill before it catches up again
+        for (int i = 0; i < 200; ++i) {
+            EXPECT_NE(random_write(), WEAR_LEVELING_FAILED) << "Write should not have failed";
+            wear_leveling_task();
+        }
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        expect_contents();
+    }
+}
+
+/**
+ * This test verifies that if the newest region's checksum is corrupted, the previous region and its write log are used instead.
+ */
+TEST_F(WearLevelingBackground, CorruptNewestRegionFallsBack) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to_headroom();
+
+    // Run the consolidation up until the previous region would start to be erased
+    wear_leveling_status_t status;
+    do {
+        status = wear_leveling_task();
+        EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Task should not have failed";
+    } while (status != WEAR_LEVELING_CONSOLIDATED);
+
+    // A clean backing store starts with the first region, so the first consolidation is into the second region
+    auto checksum = inst.storage_begin() + (WEAR_LEVELING_REGION_SIZE + WEAR_LEVELING_LOGICAL_SIZE + 8) / sizeof(backing_store_int_t);
+    checksum->erase();
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
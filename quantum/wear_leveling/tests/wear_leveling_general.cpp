@@ -202,3 +202,36 @@ TEST_F(WearLevelingGeneral, WriteFailure_NoSubsequentWrites) {
     wear_leveling_read(0x04, &test_val, sizeof(test_val));
     EXPECT_EQ(test_val, 0x14) << "Readback should come from cache regardless of unlock failure";
 }
+
+/**
+ * This test verifies that once the write log is full and consolidation keeps failing, writes fail rather than running past the end of the backing store.
+ */
+TEST_F(WearLevelingGeneral, ConsolidationFailure_NoWritesPastLog) {
+    auto& inst        = MockBackingStore::Instance();
+    bool  erase_fails = true;
+    inst.set_erase_callback([&erase_fails](std::uint64_t) { return !erase_fails; });
+
+    wear_leveling_status_t status;
+    uint8_t                test_val = 0;
+    do {
+        ++test_val;
+        status = wear_leveling_write(0x04, &test_val, sizeof(test_val));
+    } while (status == WEAR_LEVELING_SUCCESS);
+    EXPECT_EQ(status, WEAR_LEVELING_FAILED) << "Write should have failed to consolidate";
+
+    std::uint64_t write_count = inst.write_invoke_count();
+    for (int i = 0; i < 10; ++i) {
+        ++test_val;
+        EXPECT_EQ(wear_leveling_write(0x04, &test_val, sizeof(test_val)), WEAR_LEVELING_FAILED) << "Write should have failed to consolidate";
+    }
+    EXPECT_EQ(inst.write_invoke_count(), write_count) << "Nothing should have been written past the end of the write log";
+
+    erase_fails = false;
+    ++test_val;
+    EXPECT_EQ(wear_leveling_write(0x04, &test_val, sizeof(test_val)), WEAR_LEVELING_CONSOLIDATED) << "Write should have consolidated";
+
+    uint8_t readback = 0;
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    wear_leveling_read(0x04, &readback, sizeof(readback));
+    EXPECT_EQ(readback, test_val) << "Readback should match the last write";
+}
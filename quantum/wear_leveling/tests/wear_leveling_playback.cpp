@@ -0,0 +1,96 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+// Number of bytes available to the write log
+using LOG_SIZE = std::integral_constant<std::size_t, WEAR_LEVELING_BACKING_SIZE - WEAR_LEVELING_LOGICAL_SIZE - 8>;
+
+class WearLevelingPlayback : public ::testing::Test {
+   protected:
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected;
+    std::uint32_t                                        seed;
+
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        expected.fill(0);
+        seed = 1;
+        wear_leveling_init();
+    }
+
+    // Performs pseudo-random writes of varying length until the write log has reached the supplied size
+    void fill_log(std::size_t log_bytes) {
+        auto& inst = MockBackingStore::Instance();
+        while (inst.total_write_count() * BACKING_STORE_WRITE_SIZE < log_bytes) {
+            seed                  = seed * 1103515245 + 12345;
+            std::size_t   length  = 1 + (seed >> 28) % 8;
+            std::uint32_t address = (seed >> 8) % (WEAR_LEVELING_LOGICAL_SIZE - length);
+            std::uint8_t  value[8];
+            for (std::size_t i = 0; i < length; ++i) {
+                value[i] = (std::uint8_t)(seed >> (i * 3));
+            }
+            std::memcpy(&expected[address], value, length);
+            EXPECT_EQ(wear_leveling_write(address, value, length), WEAR_LEVELING_SUCCESS) << "Write should not have needed to consolidate";
+        }
+    }
+
+    void expect_contents() {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(actual, expected) << "Invalid readback";
+    }
+};
+
+/**
+ * This test verifies that a nearly full write log is played back correctly.
+ */
+TEST_F(WearLevelingPlayback, NearlyFullLog) {
+    fill_log(LOG_SIZE::value * 95 / 100);
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+}
+
+/**
+ * This test verifies that playback reads the write log in bulk, rather than an item at a time.
+ */
+TEST_F(WearLevelingPlayback, ReadsInBulk) {
+    auto& inst = MockBackingStore::Instance();
+    fill_log(LOG_SIZE::value * 95 / 100);
+    std::size_t log_bytes = inst.total_write_count() * BACKING_STORE_WRITE_SIZE;
+
+    inst.reset_read_counts();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_contents();
+
+    // Consolidated data and checksum, then each buffer's worth of write log, plus the buffer containing the end of the log
+    EXPECT_LE(inst.read_invoke_count(), 2 + log_bytes / WEAR_LEVELING_PLAYBACK_BUFFER_SIZE + 1) << "Write log should have been read in bulk";
+}
+
+/**
+ * Reports the cost of playback on startup at varying write log fill levels.
+ */
+TEST_F(WearLevelingPlayback, ReplayCostByFillLevel) {
+    auto&     inst       = MockBackingStore::Instance();
+    const int iterations = 20;
+
+    std::printf("Fill | Log bytes | Read calls | Items read | Item-at-a-time calls | Init time\n");
+    for (int fill : {0, 25, 50, 75, 95}) {
+        SetUp();
+        fill_log(LOG_SIZE::value * fill / 100);
+        std::size_t log_bytes = inst.total_write_count() * BACKING_STORE_WRITE_SIZE;
+
+        inst.reset_read_counts();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        expect_contents();
+
+        std::printf("%3d%% | %9zu | %10llu | %10llu | %20zu | %7.1fus\n", fill, log_bytes, (unsigned long long)(inst.read_invoke_count() / iterations), (unsigned long long)(inst.read_element_count() / iterations), (WEAR_LEVELING_LOGICAL_SIZE + 8 + log_bytes) / BACKING_STORE_WRITE_SIZE + 1, elapsed.count() / iterations);
+    }
+}
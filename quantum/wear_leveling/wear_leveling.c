@@ -5,6 +5,10 @@
 #include "wear_leveling.h"
 #include "wear_leveling_internal.h"
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+#    include "timer.h"
+#endif
+
 /*
     This wear leveling algorithm is adapted from algorithms from previous
     implementations in QMK, namely:
@@ -66,7 +70,8 @@
         During initialization:
             * The contents of the consolidated data section are read into cache.
             * The contents of the write log are "played back" and update the
-                cache accordingly.
+                cache accordingly. The write log is read from the backing store
+                WEAR_LEVELING_PLAYBACK_BUFFER_SIZE bytes at a time.
 
         During reads:
             * Logical data is served from the cache.
@@ -153,17 +158,75 @@
         ║  │Address >> 1 ║
         ║  └── Value: 1  ║
         ╚════════════════╝
-        0 <= Address <= 0x3FFE (16382) */
+        0 <= Address <= 0x3FFE (16382)
+
+    Background consolidation:
+
+        With WEAR_LEVELING_BACKGROUND_CONSOLIDATION defined, the backing store
+        is split into two equally-sized regions. Each region has the same
+        layout as above, except that an 8-byte sequence number (a uint32_t
+        followed by its complement) is placed between the consolidated data
+        and the FNV1a_64, which now covers both. On startup, the region with a
+        valid checksum and the newest sequence number is the active region.
+
+        Once the active write log has less than
+        WEAR_LEVELING_CONSOLIDATION_HEADROOM bytes remaining, consolidation
+        into the inactive region is performed in bounded steps by
+        wear_leveling_task():
+            * The inactive region is erased, one BACKING_STORE_ERASE_SIZE
+                block per step.
+            * The cache is copied across, WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE
+                bytes per step. Writes made while copying are appended to the
+                write logs of both regions, so anything missed by chunks which
+                were already copied is played back from the new write log.
+            * The sequence number and then the checksum are written, making
+                the inactive region the active one.
+            * The previously active region is erased, one block per step, so
+                that it's ready for the next consolidation.
+
+        Up until the checksum is written, the previously active region remains
+        intact and complete, so a power loss at any point does not lose data.
+        If the active write log fills before the steps have completed, the
+        remaining steps are performed inline. */
 
 /**
  * Storage area for the wear-leveling cache.
  */
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+typedef enum wear_leveling_consolidation_state_t {
+    CONSOLIDATION_IDLE,  //< Nothing in progress
+    CONSOLIDATION_ERASE, //< Erasing the inactive region
+    CONSOLIDATION_COPY,  //< Copying the cache into the inactive region
+} wear_leveling_consolidation_state_t;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    uint32_t                            region;               // Base address of the active region
+    uint32_t                            sequence;             // Sequence number of the active region
+    uint32_t                            progress;             // Erase or copy offset within the inactive region
+    uint32_t                            spare_write_address;  // Write log position within the inactive region, while copying
+    uint64_t                            spare_hash;           // FNV1a_64 of the data copied so far
+    wear_leveling_consolidation_state_t state;                // Current consolidation step
+    bool                                spare_erased;         // Whether the inactive region is known to be erased
+    bool                                consolidation_needed; // Whether the active write log is due to be consolidated
+    wear_leveling_stats_t               stats;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
 } wear_leveling;
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+#    define WEAR_LEVELING_ACTIVE_REGION (wear_leveling.region)
+#    define WEAR_LEVELING_SPARE_REGION ((WEAR_LEVELING_REGION_SIZE) - wear_leveling.region)
+#else
+#    define WEAR_LEVELING_ACTIVE_REGION 0
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
+#define WEAR_LEVELING_LOG_START (WEAR_LEVELING_ACTIVE_REGION + (WEAR_LEVELING_LOG_OFFSET))
+#define WEAR_LEVELING_LOG_END (WEAR_LEVELING_ACTIVE_REGION + (WEAR_LEVELING_REGION_SIZE))
+
 /**
  * Locking helper: status
  */
@@ -202,9 +265,248 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+    wear_leveling.write_address = WEAR_LEVELING_LOG_START;
+}
+
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+/**
+ * Reads a full 8-byte entry from the backing store.
+ */
+static bool wear_leveling_read_entry(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_read_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_read_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_read(address, &entry->raw64);
+#    endif
+}
+
+/**
+ * Writes a full 8-byte entry to the backing store.
+ */
+static bool wear_leveling_write_entry(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry->raw64);
+#    endif
+}
+
+/**
+ * Keeps track of the longest time spent blocked in an API call.
+ */
+static inline void wear_leveling_update_max_time(uint32_t *max_time, uint32_t start) {
+    uint32_t elapsed = timer_elapsed32(start);
+    if (elapsed > *max_time) {
+        *max_time = elapsed;
+    }
+}
+
+/**
+ * Loads the consolidated data of the supplied region into the cache, and verifies it against the region's checksum.
+ *
+ * @return true if the region is valid
+ */
+static bool wear_leveling_load_region(uint32_t region, write_log_entry_t sequence) {
+    write_log_entry_t entry;
+    if (!backing_store_read_bulk(region, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) || !wear_leveling_read_entry(region + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &entry)) {
+        wl_dprintf("Failed to read from backing store\n");
+        return false;
+    }
+
+    uint64_t expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+    expected          = fnv_64a_buf(sequence.raw8, sizeof(sequence.raw8), expected);
+    return entry.raw64 == expected;
+}
+
+/**
+ * Reads the consolidated data from the newest valid region into the cache, making it the active region.
+ * Does not consider the write log.
+ */
+static wear_leveling_status_t wear_leveling_read_consolidated(void) {
+    wl_dprintf("Reading consolidated data\n");
+
+    write_log_entry_t sequence[2];
+    bool              valid[2];
+    for (int i = 0; i < 2; ++i) {
+        if (!wear_leveling_read_entry(i * (WEAR_LEVELING_REGION_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), &sequence[i])) {
+            wl_dprintf("Failed to read from backing store\n");
+            wear_leveling_clear_cache();
+            return WEAR_LEVELING_FAILED;
+        }
+        valid[i] = sequence[i].raw32[0] == ~sequence[i].raw32[1];
+    }
+
+    // Try the newest region first, falling back to the older one if its checksum doesn't match
+    int newest = (valid[0] && valid[1]) ? ((int32_t)(sequence[1].raw32[0] - sequence[0].raw32[0]) > 0 ? 1 : 0) : (valid[1] ? 1 : 0);
+    for (int i = 0; i < 2; ++i) {
+        int candidate = i == 0 ? newest : !newest;
+        if (valid[candidate] && wear_leveling_load_region(candidate * (WEAR_LEVELING_REGION_SIZE), sequence[candidate])) {
+            wl_dprintf("Checksum matches, consolidated data in region %d is correct\n", candidate);
+            wear_leveling.region        = candidate * (WEAR_LEVELING_REGION_SIZE);
+            wear_leveling.sequence      = sequence[candidate].raw32[0];
+            wear_leveling.write_address = WEAR_LEVELING_LOG_START;
+            return WEAR_LEVELING_SUCCESS;
+        }
+    }
+
+    // Neither region is valid, which will cater for the completely clean MCU case.
+    wl_dprintf("No valid consolidated data, clearing cache\n");
+    wear_leveling.region   = 0;
+    wear_leveling.sequence = 0;
+    wear_leveling_clear_cache();
+    return WEAR_LEVELING_SUCCESS;
+}
+
+/**
+ * Starts copying the cache into the inactive region, which must already be erased.
+ */
+static void wear_leveling_consolidation_start_copy(void) {
+    wear_leveling.state               = CONSOLIDATION_COPY;
+    wear_leveling.progress            = 0;
+    wear_leveling.spare_write_address = WEAR_LEVELING_SPARE_REGION + (WEAR_LEVELING_LOG_OFFSET);
+    wear_leveling.spare_hash          = FNV1A_64_INIT;
+    wear_leveling.spare_erased        = false;
+}
+
+/**
+ * Starts erasing the inactive region.
+ */
+static void wear_leveling_consolidation_start_erase(void) {
+    wear_leveling.state        = CONSOLIDATION_ERASE;
+    wear_leveling.progress     = 0;
+    wear_leveling.spare_erased = false;
+}
+
+/**
+ * Writes the sequence number and checksum of the inactive region, then swaps it with the active region.
+ */
+static wear_leveling_status_t wear_leveling_consolidation_commit(void) {
+    write_log_entry_t entry;
+    entry.raw32[0] = wear_leveling.sequence + 1;
+    entry.raw32[1] = ~entry.raw32[0];
+    if (!wear_leveling_write_entry(WEAR_LEVELING_SPARE_REGION + (WEAR_LEVELING_LOGICAL_SIZE), &entry)) {
+        return WEAR_LEVELING_FAILED;
+    }
+
+    // The checksum goes last -- until it's written, the active region is still the valid one
+    entry.raw64 = fnv_64a_buf(entry.raw8, sizeof(entry.raw8), wear_leveling.spare_hash);
+    if (!wear_leveling_write_entry(WEAR_LEVELING_SPARE_REGION + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &entry)) {
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wl_dprintf("Consolidated into region at 0x%04X\n", (int)WEAR_LEVELING_SPARE_REGION);
+    wear_leveling.region               = WEAR_LEVELING_SPARE_REGION;
+    wear_leveling.sequence             = wear_leveling.sequence + 1;
+    wear_leveling.write_address        = wear_leveling.spare_write_address;
+    wear_leveling.consolidation_needed = false;
+    ++wear_leveling.stats.consolidations;
+
+    // Get the previously active region ready for the next consolidation
+    wear_leveling_consolidation_start_erase();
+    return WEAR_LEVELING_CONSOLIDATED;
+}
+
+/**
+ * Performs a single bounded step of consolidation, if any is pending.
+ * Pre-condition: the backing store is unlocked.
+ *
+ * @return WEAR_LEVELING_CONSOLIDATED if this step completed a consolidation
+ */
+static wear_leveling_status_t wear_leveling_consolidation_step(void) {
+    switch (wear_leveling.state) {
+        case CONSOLIDATION_IDLE:
+            if (wear_leveling.consolidation_needed) {
+                if (wear_leveling.spare_erased) {
+                    wear_leveling_consolidation_start_copy();
+                } else {
+                    wear_leveling_consolidation_start_erase();
+                }
+            }
+            return WEAR_LEVELING_SUCCESS;
+
+        case CONSOLIDATION_ERASE:
+            if (!backing_store_erase_block(WEAR_LEVELING_SPARE_REGION + wear_leveling.progress)) {
+                wl_dprintf("Failed to erase backing store\n");
+                return WEAR_LEVELING_FAILED;
+            }
+            wear_leveling.progress += (BACKING_STORE_ERASE_SIZE);
+            if (wear_leveling.progress >= (WEAR_LEVELING_REGION_SIZE)) {
+                wear_leveling.state        = CONSOLIDATION_IDLE;
+                wear_leveling.spare_erased = true;
+                if (wear_leveling.consolidation_needed) {
+                    wear_leveling_consolidation_start_copy();
+                }
+            }
+            return WEAR_LEVELING_SUCCESS;
+
+        case CONSOLIDATION_COPY: {
+            uint32_t remaining = (WEAR_LEVELING_LOGICAL_SIZE) - wear_leveling.progress;
+            uint32_t length    = remaining < (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE) ? remaining : (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE);
+            uint8_t *chunk     = &wear_leveling.cache[wear_leveling.progress];
+            if (!backing_store_write_bulk(WEAR_LEVELING_SPARE_REGION + wear_leveling.progress, (backing_store_int_t *)chunk, length / sizeof(backing_store_int_t))) {
+                // Partially-written data can't be written over, so start again from a clean slate
+                wl_dprintf("Failed to write to backing store\n");
+                wear_leveling_consolidation_start_erase();
+                return WEAR_LEVELING_FAILED;
+            }
+            wear_leveling.spare_hash = fnv_64a_buf(chunk, length, wear_leveling.spare_hash);
+            wear_leveling.progress += length;
+            if (wear_leveling.progress >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                wear_leveling_status_t status = wear_leveling_consolidation_commit();
+                if (status == WEAR_LEVELING_FAILED) {
+                    wl_dprintf("Failed to write to backing store\n");
+                    wear_leveling_consolidation_start_erase();
+                }
+                return status;
+            }
+            return WEAR_LEVELING_SUCCESS;
+        }
+    }
+
+    return WEAR_LEVELING_FAILED;
 }
 
+/**
+ * Forces a write of the current cache, performing any remaining consolidation steps inline.
+ * The active region is left intact until the new one is complete, so a power loss does not lose data.
+ */
+static wear_leveling_status_t wear_leveling_consolidate_force(void) {
+    wl_dprintf("Forcing consolidation\n");
+
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    wear_leveling_status_t      status      = WEAR_LEVELING_SUCCESS;
+    wear_leveling.consolidation_needed      = true;
+    while (status == WEAR_LEVELING_SUCCESS) {
+        status = wear_leveling_consolidation_step();
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        wear_leveling_lock();
+    }
+    return status;
+}
+
+/**
+ * Kicks off a background consolidation once the active write log is nearly full, forcing one if it is full.
+ *
+ * @return true if consolidation occurred
+ */
+static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
+    if (wear_leveling.write_address >= WEAR_LEVELING_LOG_END) {
+        return wear_leveling_consolidate_force();
+    }
+
+    if (wear_leveling.write_address >= WEAR_LEVELING_LOG_END - (WEAR_LEVELING_CONSOLIDATION_HEADROOM)) {
+        wear_leveling.consolidation_needed = true;
+    }
+    return WEAR_LEVELING_SUCCESS;
+}
+#else
+
 /**
  * Reads the consolidated data from the backing store into the cache.
  * Does not consider the write log.
@@ -316,7 +618,7 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
     }
 
     // Next write of the log occurs after the consolidated values at the start of the backing store.
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling.write_address = WEAR_LEVELING_LOG_START;
 
     return status;
 }
@@ -335,20 +637,35 @@ static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
 
     return WEAR_LEVELING_SUCCESS;
 }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
 
 /**
- * Appends the supplied fixed-width entry to the write log, optionally consolidating if the log is full.
+ * Appends the supplied fixed-width entry to a write log, optionally consolidating if the active write log is full.
  *
  * @return true if consolidation occurred
  */
-static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value) {
-    bool ok = backing_store_write(wear_leveling.write_address, value);
+static wear_leveling_status_t wear_leveling_append_raw(uint32_t *write_address, backing_store_int_t value) {
+    bool active = write_address == &wear_leveling.write_address;
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    uint32_t end = active ? WEAR_LEVELING_LOG_END : WEAR_LEVELING_SPARE_REGION + (WEAR_LEVELING_REGION_SIZE);
+#else
+    uint32_t end = WEAR_LEVELING_LOG_END;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
+    // A previously failed consolidation leaves the write log full -- never write past its end
+    if (*write_address + (BACKING_STORE_WRITE_SIZE) > end) {
+        wl_dprintf("Write log is full\n");
+        // The cache already holds the new value, so a successful consolidation persists it
+        return active ? wear_leveling_consolidate_force() : WEAR_LEVELING_FAILED;
+    }
+
+    bool ok = backing_store_write(*write_address, value);
     if (!ok) {
         wl_dprintf("Failed to write to backing store\n");
         return WEAR_LEVELING_FAILED;
     }
-    wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
-    return wear_leveling_consolidate_if_needed();
+    *write_address += (BACKING_STORE_WRITE_SIZE);
+    return active ? wear_leveling_consolidate_if_needed() : WEAR_LEVELING_SUCCESS;
 }
 
 /**
@@ -356,7 +673,7 @@ static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value
  *
  * @return true if consolidation occurred
  */
-static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address, const void *value, size_t length) {
+static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t *write_address, uint32_t address, const void *value, size_t length) {
     const uint8_t *   p   = value;
     write_log_entry_t log = LOG_ENTRY_MAKE_MULTIBYTE(address, length);
     for (size_t i = 0; i < length; ++i) {
@@ -366,43 +683,43 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
     // Write to the backing store. See the multi-byte log format in the documentation header at the top of the file.
     wear_leveling_status_t status;
 #if BACKING_STORE_WRITE_SIZE == 2
-    status = wear_leveling_append_raw(log.raw16[0]);
+    status = wear_leveling_append_raw(write_address, log.raw16[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
     }
 
-    status = wear_leveling_append_raw(log.raw16[1]);
+    status = wear_leveling_append_raw(write_address, log.raw16[1]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
     }
 
     if (length > 1) {
-        status = wear_leveling_append_raw(log.raw16[2]);
+        status = wear_leveling_append_raw(write_address, log.raw16[2]);
         if (status != WEAR_LEVELING_SUCCESS) {
             return status;
         }
     }
 
     if (length > 3) {
-        status = wear_leveling_append_raw(log.raw16[3]);
+        status = wear_leveling_append_raw(write_address, log.raw16[3]);
         if (status != WEAR_LEVELING_SUCCESS) {
             return status;
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 4
-    status = wear_leveling_append_raw(log.raw32[0]);
+    status = wear_leveling_append_raw(write_address, log.raw32[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
     }
 
     if (length > 1) {
-        status = wear_leveling_append_raw(log.raw32[1]);
+        status = wear_leveling_append_raw(write_address, log.raw32[1]);
         if (status != WEAR_LEVELING_SUCCESS) {
             return status;
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 8
-    status = wear_leveling_append_raw(log.raw64);
+    status = wear_leveling_append_raw(write_address, log.raw64);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
     }
@@ -411,9 +728,9 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
 }
 
 /**
- * Handles the actual writing of logical data into the write log section of the backing store.
+ * Handles the actual writing of logical data into a write log section of the backing store.
  */
-static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const void *value, size_t length) {
+static wear_leveling_status_t wear_leveling_write_raw(uint32_t *write_address, uint32_t address, const void *value, size_t length) {
     const uint8_t *        p         = value;
     size_t                 remaining = length;
     wear_leveling_status_t status    = WEAR_LEVELING_SUCCESS;
@@ -424,7 +741,7 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
             const uint16_t v = ((uint16_t)p[1]) << 8 | p[0]; // don't just dereference a uint16_t here -- if unaligned it generates faults on some MCUs
             if (v == 0 || v == 1) {
                 const write_log_entry_t log = LOG_ENTRY_MAKE_WORD_01(address, v);
-                status                      = wear_leveling_append_raw(log.raw16[0]);
+                status                      = wear_leveling_append_raw(write_address, log.raw16[0]);
                 if (status != WEAR_LEVELING_SUCCESS) {
                     // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                     // If a failure occurred, pass it on.
@@ -441,7 +758,7 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
         // Small-write optimizations - address<64:
         if (address < 64) {
             const write_log_entry_t log = LOG_ENTRY_MAKE_OPTIMIZED_64(address, *p);
-            status                      = wear_leveling_append_raw(log.raw16[0]);
+            status                      = wear_leveling_append_raw(write_address, log.raw16[0]);
             if (status != WEAR_LEVELING_SUCCESS) {
                 // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                 // If a failure occurred, pass it on.
@@ -455,7 +772,7 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
         }
 #endif // BACKING_STORE_WRITE_SIZE == 2
         const size_t this_length = remaining >= LOG_ENTRY_MULTIBYTE_MAX_BYTES ? LOG_ENTRY_MULTIBYTE_MAX_BYTES : remaining;
-        status                   = wear_leveling_write_raw_multibyte(address, p, this_length);
+        status                   = wear_leveling_write_raw_multibyte(write_address, address, p, this_length);
         if (status != WEAR_LEVELING_SUCCESS) {
             // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
             // If a failure occurred, pass it on.
@@ -469,18 +786,70 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
     return status;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+/**
+ * Mirrors a write into the write log of the inactive region while the cache is being copied into it, so that chunks
+ * which were already copied are brought up to date when the new write log is played back.
+ */
+static wear_leveling_status_t wear_leveling_write_spare(uint32_t address, const void *value, size_t length) {
+    if (wear_leveling.state != CONSOLIDATION_COPY) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Each logical byte needs at most one full log entry. If it doesn't fit, the copy is started again from scratch.
+    if (wear_leveling.spare_write_address + length * sizeof(write_log_entry_t) > WEAR_LEVELING_SPARE_REGION + (WEAR_LEVELING_REGION_SIZE)) {
+        wl_dprintf("Inactive write log is full, restarting consolidation\n");
+        wear_leveling_consolidation_start_erase();
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    return wear_leveling_write_raw(&wear_leveling.spare_write_address, address, value, length);
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
+#define WEAR_LEVELING_PLAYBACK_BUFFER_ITEMS ((WEAR_LEVELING_PLAYBACK_BUFFER_SIZE) / sizeof(backing_store_int_t))
+
+/**
+ * Buffered reader for the write log, so that playback reads the backing store in bulk rather than an item at a time.
+ */
+typedef struct wear_leveling_log_reader_t {
+    backing_store_int_t buffer[WEAR_LEVELING_PLAYBACK_BUFFER_ITEMS];
+    uint32_t            start; // Backing store address of the first buffered item
+    uint32_t            end;   // Backing store address after the last buffered item
+} wear_leveling_log_reader_t;
+
+/**
+ * Reads an item of the write log, refilling the buffer from the backing store if needed.
+ */
+static bool wear_leveling_log_read(wear_leveling_log_reader_t *reader, uint32_t address, backing_store_int_t *value) {
+    if (address < reader->start || address >= reader->end) {
+        uint32_t remaining = WEAR_LEVELING_LOG_END > address ? (WEAR_LEVELING_LOG_END - address) / sizeof(backing_store_int_t) : 0;
+        uint32_t count     = remaining < WEAR_LEVELING_PLAYBACK_BUFFER_ITEMS ? remaining : WEAR_LEVELING_PLAYBACK_BUFFER_ITEMS;
+        reader->start      = reader->end = 0;
+        if (count == 0 || !backing_store_read_bulk(address, reader->buffer, count)) {
+            return false;
+        }
+        reader->start = address;
+        reader->end   = address + count * sizeof(backing_store_int_t);
+    }
+
+    *value = reader->buffer[(address - reader->start) / sizeof(backing_store_int_t)];
+    return true;
+}
+
 /**
  * "Replays" the write log from the backing store, updating the local cache with updated values.
  */
 static wear_leveling_status_t wear_leveling_playback_log(void) {
     wl_dprintf("Playback write log\n");
 
-    wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
-    bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
-    while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
+    wear_leveling_log_reader_t reader          = {.start = 0, .end = 0};
+    wear_leveling_status_t     status          = WEAR_LEVELING_SUCCESS;
+    bool                       cancel_playback = false;
+    uint32_t                   address         = WEAR_LEVELING_LOG_START;
+    while (!cancel_playback && address < WEAR_LEVELING_LOG_END) {
         backing_store_int_t value;
-        bool                ok = backing_store_read(address, &value);
+        bool                ok = wear_leveling_log_read(&reader, address, &value);
         if (!ok) {
             wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
             cancel_playback = true;
@@ -509,7 +878,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
         switch (LOG_ENTRY_GET_TYPE(log)) {
             case LOG_ENTRY_TYPE_MULTIBYTE: {
 #if BACKING_STORE_WRITE_SIZE == 2
-                ok = backing_store_read(address, &log.raw16[1]);
+                ok = wear_leveling_log_read(&reader, address, &log.raw16[1]);
                 if (!ok) {
                     wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                     cancel_playback = true;
@@ -529,7 +898,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
 #if BACKING_STORE_WRITE_SIZE == 2
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw16[2]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw16[2]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -539,7 +908,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                     address += (BACKING_STORE_WRITE_SIZE);
                 }
                 if (l > 3) {
-                    ok = backing_store_read(address, &log.raw16[3]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw16[3]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -550,7 +919,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                 }
 #elif BACKING_STORE_WRITE_SIZE == 4
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw32[1]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw32[1]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -620,6 +989,14 @@ wear_leveling_status_t wear_leveling_init(void) {
     // Reset the cache
     wear_leveling_clear_cache();
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    // The state of the inactive region is unknown, so it needs to be erased before it is next used
+    wear_leveling.state                = CONSOLIDATION_IDLE;
+    wear_leveling.spare_erased         = false;
+    wear_leveling.consolidation_needed = false;
+    memset(&wear_leveling.stats, 0, sizeof(wear_leveling.stats));
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
     // Initialise the backing store
     if (!backing_store_init()) {
         // If it failed, clear the cache and return with failure
@@ -661,6 +1038,13 @@ wear_leveling_status_t wear_leveling_erase(void) {
 
     // Perform the erase
     bool ret = backing_store_erase();
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    wear_leveling.region               = 0;
+    wear_leveling.sequence             = 0;
+    wear_leveling.state                = CONSOLIDATION_IDLE;
+    wear_leveling.spare_erased         = ret;
+    wear_leveling.consolidation_needed = false;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
     wear_leveling_clear_cache();
 
     // Lock the backing store if we acquired the lock successfully
@@ -688,6 +1072,11 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
         return true;
     }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    uint32_t start   = timer_read32();
+    bool     copying = wear_leveling.state == CONSOLIDATION_COPY;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
     // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
     memcpy(&wear_leveling.cache[address], value, length);
 
@@ -699,9 +1088,16 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     }
 
     // Perform the actual write
-    wear_leveling_status_t status = wear_leveling_write_raw(address, value, length);
+    wear_leveling_status_t status = wear_leveling_write_raw(&wear_leveling.write_address, address, value, length);
     switch (status) {
         case WEAR_LEVELING_CONSOLIDATED:
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+            // If a copy that was already underway got finished off, the chunks copied before this write don't include it.
+            if (copying && wear_leveling_write_raw(&wear_leveling.write_address, address, value, length) == WEAR_LEVELING_FAILED) {
+                status = WEAR_LEVELING_FAILED;
+            }
+            break;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
         case WEAR_LEVELING_FAILED:
             // If the write triggered consolidation, or the write failed, then nothing else needs to occur.
             break;
@@ -709,6 +1105,11 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
         case WEAR_LEVELING_SUCCESS:
             // Consolidate the cache + write log if required
             status = wear_leveling_consolidate_if_needed();
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+            if (status == WEAR_LEVELING_SUCCESS) {
+                status = wear_leveling_write_spare(address, value, length);
+            }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
             break;
 
         default:
@@ -723,6 +1124,9 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
         }
     }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    wear_leveling_update_max_time(&wear_leveling.stats.max_write_time, start);
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
     return status;
 }
 
@@ -743,6 +1147,44 @@ wear_leveling_status_t wear_leveling_read(const uint32_t address, void *value, s
     return WEAR_LEVELING_SUCCESS;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+/**
+ * Performs a single bounded step of any pending consolidation.
+ */
+wear_leveling_status_t wear_leveling_task(void) {
+    if (wear_leveling.state == CONSOLIDATION_IDLE && !wear_leveling.consolidation_needed) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    uint32_t start = timer_read32();
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = wear_leveling_consolidation_step();
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    wear_leveling_update_max_time(&wear_leveling.stats.max_task_time, start);
+    return status;
+}
+
+/**
+ * Retrieves the timing and progress of the wear-leveling subsystem since init.
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t *stats) {
+    memcpy(stats, &wear_leveling.stats, sizeof(wear_leveling.stats));
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 /**
  * Weak implementation of bulk read, drivers can implement more optimised implementations.
  */
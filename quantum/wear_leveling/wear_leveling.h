@@ -52,3 +52,31 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
+/**
+ * @typedef Timing and progress of the wear-leveling subsystem since init.
+ */
+typedef struct wear_leveling_stats_t {
+    uint32_t max_write_time; //< Longest time spent blocked in a single wear_leveling_write(), in milliseconds
+    uint32_t max_task_time;  //< Longest time spent blocked in a single wear_leveling_task(), in milliseconds
+    uint32_t consolidations; //< Number of consolidations completed
+} wear_leveling_stats_t;
+
+/**
+ * Performs a single bounded step of any pending consolidation, such as erasing one block or copying one chunk of the
+ * consolidated data. Intended to be called periodically from the main loop.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_task(void);
+
+/**
+ * Retrieves the timing and progress of the wear-leveling subsystem since init.
+ *
+ * @param stats[out] pointer to the destination stats
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t* stats);
+
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
@@ -66,6 +66,44 @@ _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
 
+// Number of bytes of write log read from the backing store at a time during playback
+#ifndef WEAR_LEVELING_PLAYBACK_BUFFER_SIZE
+#    define WEAR_LEVELING_PLAYBACK_BUFFER_SIZE 64
+#endif
+
+_Static_assert(WEAR_LEVELING_PLAYBACK_BUFFER_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Playback buffer size must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_PLAYBACK_BUFFER_SIZE >= 8, "Playback buffer size must fit a full write log entry");
+
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+#    ifndef BACKING_STORE_ERASE_SIZE
+#        error BACKING_STORE_ERASE_SIZE was not set, background consolidation is not supported by this backing store.
+#    endif
+
+// The backing store is split into two regions, each holding consolidated data followed by a write log
+#    define WEAR_LEVELING_REGION_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+// Consolidated data is followed by the sequence number and FNV1a_64 of the region
+#    define WEAR_LEVELING_LOG_OFFSET ((WEAR_LEVELING_LOGICAL_SIZE) + 16)
+
+// Amount of write log remaining when a background consolidation is kicked off
+#    ifndef WEAR_LEVELING_CONSOLIDATION_HEADROOM
+#        define WEAR_LEVELING_CONSOLIDATION_HEADROOM (((WEAR_LEVELING_REGION_SIZE) - (WEAR_LEVELING_LOG_OFFSET)) / 2)
+#    endif
+
+// Number of bytes of consolidated data copied per background step
+#    ifndef WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE
+#        define WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE 64
+#    endif
+
+_Static_assert(WEAR_LEVELING_REGION_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "Total backing size must be at least four times the size of the logical size for background consolidation");
+_Static_assert(WEAR_LEVELING_REGION_SIZE % BACKING_STORE_ERASE_SIZE == 0, "Half of the backing size must be a multiple of the erase size");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_HEADROOM < (WEAR_LEVELING_REGION_SIZE - WEAR_LEVELING_LOG_OFFSET), "Consolidation headroom must be smaller than the write log");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Consolidation chunk size must be a multiple of write size");
+#else
+#    define WEAR_LEVELING_REGION_SIZE (WEAR_LEVELING_BACKING_SIZE)
+// Consolidated data is followed by the FNV1a_64 of the consolidated area
+#    define WEAR_LEVELING_LOG_OFFSET ((WEAR_LEVELING_LOGICAL_SIZE) + 8)
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
@@ -75,6 +113,9 @@ bool backing_store_write_bulk(uint32_t address, backing_store_int_t* values, siz
 bool backing_store_lock(void);
 bool backing_store_read(uint32_t address, backing_store_int_t* value);
 bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count); // weak implementation already provided, optimized implementation can be implemented by driver
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+bool backing_store_erase_block(uint32_t address); // erases BACKING_STORE_ERASE_SIZE bytes starting at address, required for background consolidation
+#endif
 
 /**
  * Helper type used to contain a write log entry.
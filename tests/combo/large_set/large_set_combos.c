@@ -0,0 +1,87 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+#include "large_set_combos.h"
+
+/* One combo for every pair of LARGE_SET_KEY_COUNT keys, generated at runtime and
+ * served through combo_count()/combo_get() the same way dynamic combos would be. */
+
+void (*large_set_combo_event)(uint16_t combo_index, bool pressed) = NULL;
+
+void process_combo_event(uint16_t combo_index, bool pressed) {
+    if (large_set_combo_event) {
+        large_set_combo_event(combo_index, pressed);
+    }
+}
+
+static uint16_t large_set_keys[LARGE_SET_COMBO_COUNT][3];
+static combo_t  large_set_combos[LARGE_SET_COMBO_COUNT];
+
+uint16_t large_set_keycode(uint8_t key) {
+    return KC_A + key;
+}
+
+uint16_t large_set_combo_index(uint8_t first, uint8_t second) {
+    // Index of the pair (first, second), first < second, in generation order.
+    return first * (2 * LARGE_SET_KEY_COUNT - first - 1) / 2 + (second - first - 1);
+}
+
+void large_set_init(void) {
+    for (uint8_t first = 0; first < LARGE_SET_KEY_COUNT; ++first) {
+        for (uint8_t second = first + 1; second < LARGE_SET_KEY_COUNT; ++second) {
+            uint16_t index           = large_set_combo_index(first, second);
+            large_set_keys[index][0] = large_set_keycode(first);
+            large_set_keys[index][1] = large_set_keycode(second);
+            large_set_keys[index][2] = COMBO_END;
+            large_set_combos[index]  = (combo_t)COMBO_ACTION(large_set_keys[index]);
+        }
+    }
+    combo_keycode_index_invalidate();
+}
+
+void large_set_remap(uint16_t index, uint16_t first_keycode, uint16_t second_keycode) {
+    large_set_keys[index][0] = first_keycode;
+    large_set_keys[index][1] = second_keycode;
+    combo_keycode_index_invalidate();
+}
+
+uint16_t combo_count(void) {
+    return LARGE_SET_COMBO_COUNT;
+}
+
+combo_t *combo_get(uint16_t combo_idx) {
+    if (combo_idx >= LARGE_SET_COMBO_COUNT) {
+        return NULL;
+    }
+    return &large_set_combos[combo_idx];
+}
+
+bool large_set_process_combo(uint8_t key, bool pressed) {
+    keyrecord_t record = {.event = MAKE_KEYEVENT(key / MATRIX_COLS, key % MATRIX_COLS, pressed)};
+    return process_combo(large_set_keycode(key), &record);
+}
+
+static uint8_t random_key(uint32_t *seed) {
+    *seed = *seed * 1664525 + 1013904223;
+    return (*seed >> 8) % LARGE_SET_KEY_COUNT;
+}
+
+uint32_t large_set_random_taps(uint32_t taps) {
+    // Fixed seed, so every build sends the same sequence of key pairs.
+    uint32_t seed  = 0x5eed;
+    uint32_t calls = 0;
+
+    for (uint32_t i = 0; i < taps; ++i) {
+        uint8_t first  = random_key(&seed);
+        uint8_t second = random_key(&seed);
+        if (first == second) {
+            second = (second + 1) % LARGE_SET_KEY_COUNT;
+        }
+        large_set_process_combo(first, true);
+        large_set_process_combo(second, true);
+        large_set_process_combo(first, false);
+        large_set_process_combo(second, false);
+        calls += 4;
+    }
+    return calls;
+}
@@ -0,0 +1,18 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LARGE_SET_KEY_COUNT 33
+#define LARGE_SET_COMBO_COUNT (LARGE_SET_KEY_COUNT * (LARGE_SET_KEY_COUNT - 1) / 2)
+
+uint16_t large_set_keycode(uint8_t key);
+uint16_t large_set_combo_index(uint8_t first, uint8_t second);
+void     large_set_init(void);
+void     large_set_remap(uint16_t index, uint16_t first_keycode, uint16_t second_keycode);
+bool     large_set_process_combo(uint8_t key, bool pressed);
+uint32_t large_set_random_taps(uint32_t taps);
+
+extern void (*large_set_combo_event)(uint16_t combo_index, bool pressed);
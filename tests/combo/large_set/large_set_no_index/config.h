@@ -0,0 +1,10 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define TAPPING_TERM 200
+
+// Same combos as the parent test, without COMBO_KEYCODE_INDEX_SIZE, as the baseline for its benchmark.
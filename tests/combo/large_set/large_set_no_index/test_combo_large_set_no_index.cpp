@@ -0,0 +1,46 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+
+#include "quantum.h"
+#include "test_common.h"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "keymap_introspection.h"
+#include "../large_set_combos.h"
+}
+
+static uint32_t combo_presses;
+
+static void count_combo_presses(uint16_t combo_index, bool pressed) {
+    if (pressed) {
+        combo_presses++;
+    }
+}
+
+class ComboLargeSetNoIndex : public TestFixture {
+   public:
+    void SetUp() override {
+        large_set_init();
+        large_set_combo_event = count_combo_presses;
+        combo_presses         = 0;
+    }
+};
+
+TEST_F(ComboLargeSetNoIndex, benchmark_process_combo) {
+    const uint32_t taps = 20000;
+
+    auto     start = std::chrono::steady_clock::now();
+    uint32_t calls = large_set_random_taps(taps);
+    auto     end   = std::chrono::steady_clock::now();
+
+    // The same taps as with the index must fire the same combos.
+    EXPECT_EQ(combo_presses, taps);
+
+    double ns_per_call = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    printf("combo benchmark: %u combos, without index: %.1f ns per process_combo() call over %u calls\n", combo_count(), ns_per_call, calls);
+    RecordProperty("ns_per_call", (int)(ns_per_call + 0.5));
+}
@@ -0,0 +1,115 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "quantum.h"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "keymap_introspection.h"
+#include "large_set_combos.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+static std::vector<std::pair<uint16_t, bool>> combo_events;
+
+static void record_combo_event(uint16_t combo_index, bool pressed) {
+    combo_events.push_back({combo_index, pressed});
+}
+
+class ComboLargeSet : public TestFixture {
+   public:
+    void SetUp() override {
+        large_set_init();
+        large_set_combo_event = record_combo_event;
+        combo_events.clear();
+    }
+
+    KeymapKey key(uint8_t index) {
+        return KeymapKey(0, index % MATRIX_COLS, index / MATRIX_COLS, large_set_keycode(index));
+    }
+
+    void add_all_keys() {
+        for (uint8_t i = 0; i < LARGE_SET_KEY_COUNT; ++i) {
+            add_key(key(i));
+        }
+    }
+};
+
+TEST_F(ComboLargeSet, combo_count_is_large) {
+    EXPECT_GE(combo_count(), 500);
+}
+
+TEST_F(ComboLargeSet, each_pair_triggers_its_own_combo) {
+    TestDriver driver;
+    add_all_keys();
+
+    const std::vector<std::pair<uint8_t, uint8_t>> pairs = {{0, 1}, {0, 32}, {5, 17}, {31, 32}, {12, 13}};
+    for (auto &pair : pairs) {
+        combo_events.clear();
+        EXPECT_NO_REPORT(driver);
+        tap_combo({key(pair.first), key(pair.second)});
+        VERIFY_AND_CLEAR(driver);
+
+        uint16_t expected = large_set_combo_index(pair.first, pair.second);
+        ASSERT_EQ(combo_events.size(), 2);
+        EXPECT_EQ(combo_events[0], std::make_pair(expected, true));
+        EXPECT_EQ(combo_events[1], std::make_pair(expected, false));
+    }
+}
+
+TEST_F(ComboLargeSet, non_combo_key_is_not_delayed) {
+    TestDriver driver;
+    KeymapKey  key_enter(0, 9, 3, KC_ENTER);
+    set_keymap({key(0), key(1), key_enter});
+
+    EXPECT_REPORT(driver, (KC_ENTER));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_enter);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(combo_events.empty());
+}
+
+TEST_F(ComboLargeSet, index_follows_runtime_changes) {
+    TestDriver driver;
+    KeymapKey  key_enter(0, 9, 3, KC_ENTER);
+    add_all_keys();
+    add_key(key_enter);
+
+    // Move combo (0, 1) onto A + Enter.
+    uint16_t index = large_set_combo_index(0, 1);
+    large_set_remap(index, large_set_keycode(0), KC_ENTER);
+
+    EXPECT_NO_REPORT(driver);
+    tap_combo({key(0), key_enter});
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_EQ(combo_events.size(), 2);
+    EXPECT_EQ(combo_events[0], std::make_pair(index, true));
+    EXPECT_EQ(combo_events[1], std::make_pair(index, false));
+}
+
+TEST_F(ComboLargeSet, benchmark_process_combo) {
+    const uint32_t taps = 20000;
+
+    auto     start = std::chrono::steady_clock::now();
+    uint32_t calls = large_set_random_taps(taps);
+    auto     end   = std::chrono::steady_clock::now();
+
+    // Every tap must have fired exactly one combo press and release.
+    EXPECT_EQ(combo_events.size(), taps * 2);
+
+    double ns_per_call = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    printf("combo benchmark: %u combos, with index: %.1f ns per process_combo() call over %u calls\n", combo_count(), ns_per_call, calls);
+    RecordProperty("ns_per_call", (int)(ns_per_call + 0.5));
+}
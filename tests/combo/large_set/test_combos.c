@@ -0,0 +1,13 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+/* The real combo set is generated at runtime by large_set_combos.c. */
+
+uint16_t const unused_combo[] = {KC_ENTER, KC_ESCAPE, COMBO_END};
+
+// clang-format off
+combo_t key_combos[] = {
+    COMBO_ACTION(unused_combo)
+};
+// clang-format on
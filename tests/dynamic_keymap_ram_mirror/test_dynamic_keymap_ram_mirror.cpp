@@ -0,0 +1,108 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+#include "keymap_introspection.h"
+
+void advance_time(uint32_t ms);
+}
+
+class DynamicKeymapRamMirror : public TestFixture {
+   protected:
+    void SetUp() override {
+        dynamic_keymap_reset();
+        dynamic_keymap_init();
+    }
+
+    uint16_t stored_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        return (eeprom_read_byte(address) << 8) | eeprom_read_byte(address + 1);
+    }
+};
+
+TEST_F(DynamicKeymapRamMirror, LoadsKeymapAtInit) {
+    dynamic_keymap_set_keycode(1, 2, 3, KC_Q);
+    dynamic_keymap_flush();
+
+    // Anything written behind the mirror's back is only seen once reloaded.
+    uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(1, 2, 3);
+    eeprom_update_byte(address + 1, KC_W);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), KC_Q);
+
+    dynamic_keymap_init();
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), KC_W);
+}
+
+TEST_F(DynamicKeymapRamMirror, ChangesAreVisibleBeforeWriteBack) {
+    dynamic_keymap_set_keycode(0, 1, 2, KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 2), KC_B);
+    EXPECT_NE(stored_keycode(0, 1, 2), KC_B);
+
+    // Nothing is written back until the changes settle.
+    advance_time(DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY - 1);
+    dynamic_keymap_task();
+    EXPECT_NE(stored_keycode(0, 1, 2), KC_B);
+
+    advance_time(1);
+    dynamic_keymap_task();
+    EXPECT_EQ(stored_keycode(0, 1, 2), KC_B);
+}
+
+TEST_F(DynamicKeymapRamMirror, FurtherChangesDelayWriteBack) {
+    dynamic_keymap_set_keycode(0, 0, 0, KC_C);
+    advance_time(DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY - 1);
+    dynamic_keymap_set_keycode(0, 0, 1, KC_D);
+    advance_time(1);
+    dynamic_keymap_task();
+    EXPECT_NE(stored_keycode(0, 0, 0), KC_C);
+
+    advance_time(DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY);
+    dynamic_keymap_task();
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_C);
+    EXPECT_EQ(stored_keycode(0, 0, 1), KC_D);
+}
+
+TEST_F(DynamicKeymapRamMirror, WritesBackOneBlockPerTask) {
+    // Change the first key of each layer, each of which is in a different block.
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        dynamic_keymap_set_keycode(layer, 0, 0, KC_E);
+    }
+    advance_time(DYNAMIC_KEYMAP_RAM_MIRROR_WRITE_DELAY);
+
+    for (uint8_t pass = 0; pass < DYNAMIC_KEYMAP_LAYER_COUNT; pass++) {
+        dynamic_keymap_task();
+        for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+            EXPECT_EQ(stored_keycode(layer, 0, 0) == KC_E, layer <= pass);
+        }
+    }
+}
+
+TEST_F(DynamicKeymapRamMirror, BufferWritesAreMirrored) {
+    uint8_t data[] = {0x00, KC_F, 0x00, KC_G};
+    uint16_t offset = (MATRIX_COLS - 1) * 2;
+    dynamic_keymap_set_buffer(offset, sizeof(data), data);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, MATRIX_COLS - 1), KC_F);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 0), KC_G);
+
+    uint8_t readback[sizeof(data)] = {0};
+    dynamic_keymap_get_buffer(offset, sizeof(readback), readback);
+    EXPECT_EQ(memcmp(data, readback, sizeof(data)), 0);
+
+    dynamic_keymap_flush();
+    EXPECT_EQ(stored_keycode(0, 0, MATRIX_COLS - 1), KC_F);
+    EXPECT_EQ(stored_keycode(0, 1, 0), KC_G);
+}
+
+TEST_F(DynamicKeymapRamMirror, ResetIsPersistedImmediately) {
+    dynamic_keymap_set_keycode(2, 3, 4, KC_H);
+    dynamic_keymap_flush();
+    EXPECT_EQ(stored_keycode(2, 3, 4), KC_H);
+
+    dynamic_keymap_reset();
+    EXPECT_EQ(stored_keycode(2, 3, 4), keycode_at_keymap_location_raw(2, 3, 4));
+    EXPECT_EQ(dynamic_keymap_get_keycode(2, 3, 4), keycode_at_keymap_location_raw(2, 3, 4));
+}
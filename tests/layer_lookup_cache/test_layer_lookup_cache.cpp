@@ -0,0 +1,88 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerLookupCache : public TestFixture {};
+
+TEST_F(LayerLookupCache, ResolvesThroughTransparentLayers) {
+    TestDriver driver;
+    KeymapKey  key_a     = KeymapKey(0, 0, 0, KC_A);
+    KeymapKey  key_trns1 = KeymapKey(1, 0, 0, KC_TRNS);
+    KeymapKey  key_b     = KeymapKey(2, 0, 0, KC_B);
+    KeymapKey  key_trns3 = KeymapKey(3, 0, 0, KC_TRNS);
+
+    set_keymap({key_a, key_trns1, key_b, key_trns3});
+
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    layer_on(2);
+    layer_on(3);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 2);
+
+    layer_off(2);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    default_layer_set(1 << 2);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 2);
+    default_layer_set(1 << 0);
+}
+
+TEST_F(LayerLookupCache, KeymapChangeInvalidatesCache) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_TRNS)});
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_B)});
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 1);
+}
+
+TEST_F(LayerLookupCache, MomentaryLayerKeyReleasesCorrectly) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  key_mo = KeymapKey(0, 0, 0, MO(1));
+    KeymapKey  key_a  = KeymapKey(0, 1, 0, KC_A);
+    KeymapKey  key_b  = KeymapKey(1, 1, 0, KC_B);
+
+    set_keymap({key_mo, KeymapKey(1, 0, 0, KC_TRNS), key_a, key_b});
+
+    EXPECT_NO_REPORT(driver);
+    key_mo.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    key_mo.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
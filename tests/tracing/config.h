@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define TRACING_SAMPLE_BUFFER_SIZE 4
+#define TRACING_USER_POINTS(X) X(TEST_HOOK, "test_hook")
@@ -0,0 +1,164 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "tracing.h"
+}
+
+using testing::_;
+
+class TracingLatency : public TestFixture {
+   public:
+    void SetUp() override {
+        tracing_reset();
+    }
+
+    trace_stats_t stats(trace_point_t point) {
+        trace_stats_t stats;
+        tracing_get_stats(point, &stats);
+        return stats;
+    }
+};
+
+TEST_F(TracingLatency, PlainKeyIsReportedInTheSameScan) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a, 20);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 2);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).max, 0);
+    EXPECT_EQ(stats(TRACE_LATENCY_TAP_HOLD).count, 0);
+    EXPECT_EQ(stats(TRACE_LATENCY_COMBO).count, 0);
+}
+
+TEST_F(TracingLatency, EdgeWithoutReportIsNotMeasured) {
+    TestDriver driver;
+    KeymapKey  key_layer = KeymapKey(0, 0, 0, MO(1));
+
+    set_keymap({key_layer});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_layer);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 0);
+}
+
+TEST_F(TracingLatency, TapIsMeasuredFromThePress) {
+    TestDriver driver;
+    KeymapKey  key_lt = KeymapKey(0, 0, 0, LT(1, KC_B));
+
+    set_keymap({key_lt});
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_lt, 50);
+    VERIFY_AND_CLEAR(driver);
+
+    // The press is held back until the release resolves it as a tap.
+    EXPECT_EQ(stats(TRACE_LATENCY_TAP_HOLD).count, 1);
+    EXPECT_EQ(stats(TRACE_LATENCY_TAP_HOLD).max, 50);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 1);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).max, 0);
+}
+
+TEST_F(TracingLatency, HoldIsMeasuredFromThePress) {
+    TestDriver driver;
+    KeymapKey  key_mt = KeymapKey(0, 0, 0, SFT_T(KC_C));
+
+    set_keymap({key_mt});
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    key_mt.press();
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats(TRACE_LATENCY_TAP_HOLD).count, 1);
+    EXPECT_GE(stats(TRACE_LATENCY_TAP_HOLD).min, TAPPING_TERM);
+    EXPECT_LE(stats(TRACE_LATENCY_TAP_HOLD).max, TAPPING_TERM + 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_mt.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 1);
+}
+
+TEST_F(TracingLatency, ComboIsMeasuredFromTheCompletingKey) {
+    TestDriver driver;
+    KeymapKey  key_y = KeymapKey(0, 0, 0, KC_Y);
+    KeymapKey  key_u = KeymapKey(0, 1, 0, KC_U);
+
+    set_keymap({key_y, key_u});
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_y, key_u});
+    VERIFY_AND_CLEAR(driver);
+
+    // The chord is only resolved on the scan after U completes it.
+    EXPECT_EQ(stats(TRACE_LATENCY_COMBO).count, 2);
+    EXPECT_EQ(stats(TRACE_LATENCY_COMBO).max, 1);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 0);
+}
+
+TEST_F(TracingLatency, KeyHeldByComboBufferIsMeasured) {
+    TestDriver driver;
+    KeymapKey  key_y = KeymapKey(0, 0, 0, KC_Y);
+    KeymapKey  key_u = KeymapKey(0, 1, 0, KC_U);
+    KeymapKey  key_a = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({key_y, key_u, key_a});
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_REPORT(driver, (KC_Y, KC_A));
+    key_y.press();
+    idle_for(10);
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // Y waited in the combo buffer until A showed it could not be a combo.
+    EXPECT_EQ(stats(TRACE_LATENCY_COMBO).count, 1);
+    EXPECT_EQ(stats(TRACE_LATENCY_COMBO).max, 10);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).count, 1);
+    EXPECT_EQ(stats(TRACE_LATENCY_MATRIX).max, 0);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    key_y.release();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TracingLatency, RawHidReport) {
+    TestDriver driver;
+    KeymapKey  key_lt = KeymapKey(0, 0, 0, LT(1, KC_B));
+
+    set_keymap({key_lt});
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_lt, 30);
+    VERIFY_AND_CLEAR(driver);
+
+    uint8_t data[32] = {0};
+    data[1]          = TRACE_LATENCY_TAP_HOLD;
+    tracing_raw_hid_fill(data, sizeof(data));
+
+    EXPECT_EQ(data[3], 1);
+    EXPECT_EQ(data[11], 30);
+    EXPECT_EQ(memcmp(&data[23], "latency_t", 9), 0);
+}
@@ -0,0 +1,99 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "tracing.h"
+}
+
+using testing::_;
+
+class Tracing : public TestFixture {
+   public:
+    void SetUp() override {
+        tracing_reset();
+    }
+};
+
+TEST_F(Tracing, AggregatesSamples) {
+    for (uint32_t i = 1; i <= 100; ++i) {
+        tracing_record(TRACE_TEST_HOOK, i);
+    }
+
+    trace_stats_t stats;
+    EXPECT_TRUE(tracing_get_stats(TRACE_TEST_HOOK, &stats));
+    EXPECT_EQ(stats.count, 100);
+    EXPECT_EQ(stats.min, 1);
+    EXPECT_EQ(stats.max, 100);
+    EXPECT_EQ(stats.avg, 50);
+    EXPECT_EQ(stats.total, 5050);
+    EXPECT_EQ(stats.p99, 100);
+}
+
+TEST_F(Tracing, PercentileIgnoresRareOutliers) {
+    for (uint32_t i = 0; i < 1000; ++i) {
+        tracing_record(TRACE_TEST_HOOK, 10);
+    }
+    tracing_record(TRACE_TEST_HOOK, 100000);
+
+    trace_stats_t stats;
+    EXPECT_TRUE(tracing_get_stats(TRACE_TEST_HOOK, &stats));
+    EXPECT_EQ(stats.max, 100000);
+    EXPECT_LT(stats.p99, 16);
+}
+
+TEST_F(Tracing, RingBufferKeepsMostRecent) {
+    for (uint32_t i = 1; i <= 6; ++i) {
+        tracing_record(TRACE_TEST_HOOK, i);
+    }
+
+    trace_sample_t sample;
+    EXPECT_TRUE(tracing_get_sample(0, &sample));
+    EXPECT_EQ(sample.point, TRACE_TEST_HOOK);
+    EXPECT_EQ(sample.ticks, 6);
+    EXPECT_TRUE(tracing_get_sample(3, &sample));
+    EXPECT_EQ(sample.ticks, 3);
+    EXPECT_FALSE(tracing_get_sample(4, &sample));
+}
+
+TEST_F(Tracing, RawHidReport) {
+    tracing_record(TRACE_TEST_HOOK, 0x01020304);
+
+    uint8_t data[32] = {0};
+    data[1]          = TRACE_TEST_HOOK;
+    tracing_raw_hid_fill(data, sizeof(data));
+
+    EXPECT_EQ(data[1], TRACE_TEST_HOOK);
+    EXPECT_EQ(data[2], TRACE_POINT_COUNT);
+    EXPECT_EQ(data[3], 1);
+    EXPECT_EQ(data[7], 0x04);
+    EXPECT_EQ(data[10], 0x01);
+    EXPECT_EQ(memcmp(&data[23], "test_hook", 9), 0);
+}
+
+TEST_F(Tracing, HotPathIsInstrumented) {
+    TestDriver driver;
+    KeymapKey  key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    trace_stats_t stats;
+    tracing_get_stats(TRACE_MATRIX_SCAN, &stats);
+    EXPECT_GE(stats.count, 2);
+    tracing_get_stats(TRACE_ACTION_EXEC, &stats);
+    EXPECT_GE(stats.count, 2);
+    tracing_get_stats(TRACE_PROCESS_RECORD, &stats);
+    EXPECT_EQ(stats.count, 2);
+    EXPECT_STREQ(tracing_get_name(TRACE_PROCESS_RECORD), "process_record");
+}
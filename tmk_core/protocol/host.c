@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "tracing.h"
 
 #ifdef DIGITIZER_ENABLE
 #    include "digitizer.h"
@@ -85,6 +86,7 @@ void host_keyboard_send(report_keyboard_t *report) {
     report->report_id = REPORT_ID_KEYBOARD;
 #endif
     (*driver->send_keyboard)(report);
+    TRACE_LATENCY_REPORT();
 
     if (debug_keyboard) {
         dprintf("keyboard_report: %02X | ", report->mods);
@@ -99,6 +101,7 @@ void host_nkro_send(report_nkro_t *report) {
     if (!driver) return;
     report->report_id = REPORT_ID_NKRO;
     (*driver->send_nkro)(report);
+    TRACE_LATENCY_REPORT();
 
     if (debug_keyboard) {
         dprintf("nkro_report: %02X | ", report->mods);